@@ -0,0 +1,79 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_BATCH_READ_OPTIONS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_BATCH_READ_OPTIONS_H
+
+#include "google/cloud/spanner/keys.h"
+#include "google/cloud/spanner/read_options.h"
+#include "google/cloud/spanner/version.h"
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+/// One of the reads in a `Client::BatchRead()` call.
+struct ReadRequest {
+  std::string table;
+  KeySet keys;
+  std::vector<std::string> columns;
+  ReadOptions read_options;
+};
+
+/// Options passed to `Client::BatchRead()`.
+class BatchReadOptions {
+ public:
+  /**
+   * Set the maximum number of reads to run at once. Each of them uses its own
+   * session from the pool. Values <= 1 run the reads one at a time.
+   */
+  BatchReadOptions& set_max_concurrent_reads(int count) {
+    max_concurrent_reads_ = count;
+    return *this;
+  }
+
+  /// Return the maximum number of reads to run at once.
+  int max_concurrent_reads() const { return max_concurrent_reads_; }
+
+  /**
+   * Combine the requests that read the same columns of the same table, by
+   * point keys only, into a single read.
+   *
+   * Each row of the combined read is returned to the requests that asked for
+   * its key, which is taken from the row's leading columns. This is only
+   * correct if the columns of each request start with the key columns (of the
+   * table, or of the index in `read_options`), so it is off by default.
+   */
+  BatchReadOptions& set_combine_point_reads(bool value) {
+    combine_point_reads_ = value;
+    return *this;
+  }
+
+  /// Return true if point reads of the same table and columns are combined.
+  bool combine_point_reads() const { return combine_point_reads_; }
+
+ private:
+  int max_concurrent_reads_ = 16;
+  bool combine_point_reads_ = false;
+};
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_BATCH_READ_OPTIONS_H
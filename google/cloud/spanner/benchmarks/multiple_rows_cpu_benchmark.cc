@@ -359,6 +359,25 @@ struct TimestampTraits {
   }
 };
 
+// Timestamps clustered around the time the benchmark runs, which is typical
+// of application data (e.g. "last modified" columns), and which exercises
+// the date-prefix reuse in `Timestamp` formatting.
+struct RecentTimestampTraits {
+  using native_type = spanner::Timestamp;
+  static std::string SpannerDataType() { return "TIMESTAMP"; }
+  static std::string TableSuffix() { return "recent_timestamp"; }
+  static native_type MakeRandomValue(
+      google::cloud::internal::DefaultPRNG& generator) {
+    auto const tp =
+        std::chrono::system_clock::now() -
+        std::chrono::microseconds(
+            std::uniform_int_distribution<std::chrono::microseconds::rep>(
+                0, std::chrono::microseconds(std::chrono::minutes(1)).count())(
+                generator));
+    return spanner::MakeTimestamp(tp).value();
+  }
+};
+
 template <typename Traits>
 class ExperimentImpl {
  public:
@@ -1652,6 +1671,8 @@ std::map<std::string, ExperimentFactory> AvailableExperiments() {
       {"mutation-int64", MakeMutationFactory<Int64Traits>()},
       {"mutation-string", MakeMutationFactory<StringTraits>()},
       {"mutation-timestamp", MakeMutationFactory<TimestampTraits>()},
+      {"mutation-recent-timestamp",
+       MakeMutationFactory<RecentTimestampTraits>()},
   };
 }
 
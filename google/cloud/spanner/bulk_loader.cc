@@ -0,0 +1,144 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/bulk_loader.h"
+#include <algorithm>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+BulkLoader::BulkLoader(Client client, std::string table_name,
+                       std::vector<std::string> column_names,
+                       BulkLoaderOptions options)
+    : BulkLoader(std::move(client), std::move(table_name),
+                 std::move(column_names), std::move(options), nullptr,
+                 nullptr) {}
+
+BulkLoader::BulkLoader(Client client, std::string table_name,
+                       std::vector<std::string> column_names,
+                       BulkLoaderOptions options,
+                       std::unique_ptr<TransactionRerunPolicy> rerun_policy,
+                       std::unique_ptr<BackoffPolicy> backoff_policy)
+    : client_(std::move(client)),
+      table_name_(std::move(table_name)),
+      column_names_(std::move(column_names)),
+      options_(std::move(options)),
+      rerun_policy_(std::move(rerun_policy)),
+      backoff_policy_(std::move(backoff_policy)),
+      start_(std::chrono::steady_clock::now()),
+      current_(table_name_, column_names_) {
+  auto const thread_count = (std::max)(options_.max_concurrent_commits(), 1);
+  workers_.reserve(thread_count);
+  for (int i = 0; i != thread_count; ++i) {
+    workers_.emplace_back([this] { Run(); });
+  }
+}
+
+BulkLoader::~BulkLoader() { Finish(); }
+
+Status BulkLoader::AddRow(std::vector<Value> values) {
+  // Every value in the row is one mutation. Always allow at least one row per
+  // commit, even if the row alone exceeds the limit.
+  auto const row_cells = (std::max)(column_names_.size(), std::size_t{1});
+  auto const rows_per_commit = static_cast<std::int64_t>((std::max)(
+      options_.max_mutations_per_commit() / row_cells, std::size_t{1}));
+  auto const max_pending =
+      static_cast<std::size_t>((std::max)(options_.max_pending_batches(), 1));
+
+  std::unique_lock<std::mutex> lk(mu_);
+  // Wait for room *before* adding the row that completes the batch. While one
+  // producer waits, the others cannot add rows to the full batch either.
+  space_cv_.wait(lk, [&] {
+    return finished_ || current_rows_ + 1 < rows_per_commit ||
+           pending_.size() < max_pending;
+  });
+  if (finished_) {
+    return Status(StatusCode::kFailedPrecondition,
+                  "BulkLoader::AddRow() called after Finish()");
+  }
+  current_.AddRow(std::move(values));
+  if (++current_rows_ < rows_per_commit) return Status();
+  FlushLocked();
+  lk.unlock();
+  work_cv_.notify_one();
+  // The producers waiting for the full batch can start the next one.
+  space_cv_.notify_all();
+  return Status();
+}
+
+BulkLoadResult BulkLoader::Finish() {
+  std::unique_lock<std::mutex> lk(mu_);
+  if (finished_) return result_;
+  if (current_rows_ != 0) FlushLocked();
+  finished_ = true;
+  lk.unlock();
+  work_cv_.notify_all();
+  space_cv_.notify_all();
+  for (auto& t : workers_) t.join();
+
+  lk.lock();
+  result_.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start_);
+  return result_;
+}
+
+void BulkLoader::FlushLocked() {
+  // The rows are kept in the order they were added, so when the input is
+  // sorted by primary key each commit covers a single, contiguous key range.
+  pending_.push_back(Batch{std::move(current_).Build(), current_rows_});
+  current_ = InsertOrUpdateMutationBuilder(table_name_, column_names_);
+  current_rows_ = 0;
+}
+
+void BulkLoader::Run() {
+  std::unique_lock<std::mutex> lk(mu_);
+  for (;;) {
+    work_cv_.wait(lk, [this] { return finished_ || !pending_.empty(); });
+    if (pending_.empty()) return;  // finished, and nothing left to commit
+
+    auto batch = std::move(pending_.front());
+    pending_.pop_front();
+    space_cv_.notify_all();
+    lk.unlock();
+    auto commit = CommitBatch(batch.mutation);
+    lk.lock();
+
+    ++result_.commit_count;
+    if (commit) {
+      result_.row_count += batch.row_count;
+      continue;
+    }
+    result_.failed_row_count += batch.row_count;
+    if (result_.status.ok()) result_.status = commit.status();
+  }
+}
+
+StatusOr<CommitResult> BulkLoader::CommitBatch(Mutation const& mutation) {
+  // An "insert or update" mutation is idempotent, so `Client::Commit()` can
+  // safely rerun it after the transaction aborts.
+  auto mutator = [&mutation](Transaction const&) {
+    return StatusOr<Mutations>(Mutations{mutation});
+  };
+  if (!rerun_policy_ || !backoff_policy_) return client_.Commit(mutator);
+  return client_.Commit(mutator, rerun_policy_->clone(),
+                        backoff_policy_->clone());
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,217 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_BULK_LOADER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_BULK_LOADER_H
+
+#include "google/cloud/spanner/backoff_policy.h"
+#include "google/cloud/spanner/client.h"
+#include "google/cloud/spanner/mutations.h"
+#include "google/cloud/spanner/retry_policy.h"
+#include "google/cloud/spanner/value.h"
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/status.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+/**
+ * Controls how a `BulkLoader` splits rows into commits, and how many commits
+ * it runs at once.
+ */
+class BulkLoaderOptions {
+ public:
+  /**
+   * Set the maximum number of mutations (one per column value) in a single
+   * commit. Spanner rejects commits with more than 20,000 mutations, counting
+   * index updates, so the default leaves room for secondary indexes.
+   */
+  BulkLoaderOptions& set_max_mutations_per_commit(std::size_t count) {
+    max_mutations_per_commit_ = count;
+    return *this;
+  }
+
+  /// Return the maximum number of mutations in a single commit.
+  std::size_t max_mutations_per_commit() const {
+    return max_mutations_per_commit_;
+  }
+
+  /**
+   * Set the number of commits to run concurrently.
+   * Values <= 1 are treated as 1.
+   */
+  BulkLoaderOptions& set_max_concurrent_commits(int count) {
+    max_concurrent_commits_ = count;
+    return *this;
+  }
+
+  /// Return the number of commits to run concurrently.
+  int max_concurrent_commits() const { return max_concurrent_commits_; }
+
+  /**
+   * Set the number of full batches that may wait for a commit slot before
+   * `BulkLoader::AddRow()` blocks. This bounds the memory used by the loader
+   * when rows are produced faster than they can be committed.
+   * Values <= 1 are treated as 1.
+   */
+  BulkLoaderOptions& set_max_pending_batches(int count) {
+    max_pending_batches_ = count;
+    return *this;
+  }
+
+  /// Return the number of full batches that may wait for a commit slot.
+  int max_pending_batches() const { return max_pending_batches_; }
+
+ private:
+  std::size_t max_mutations_per_commit_ = 10000;
+  int max_concurrent_commits_ = 8;
+  int max_pending_batches_ = 16;
+};
+
+/**
+ * The outcome of a `BulkLoader` run.
+ */
+struct BulkLoadResult {
+  /// The number of rows in successful commits.
+  std::int64_t row_count = 0;
+
+  /// The number of rows in commits that failed.
+  std::int64_t failed_row_count = 0;
+
+  /// The number of commits, successful or not.
+  std::int64_t commit_count = 0;
+
+  /// The time from the creation of the loader until all commits completed.
+  std::chrono::microseconds elapsed{0};
+
+  /// Either OK or the error from the first commit that failed.
+  Status status;
+
+  /// The rate at which rows were committed, in rows per second.
+  double rows_per_second() const {
+    if (elapsed.count() == 0) return 0;
+    return static_cast<double>(row_count) * 1.0e6 /
+           static_cast<double>(elapsed.count());
+  }
+};
+
+/**
+ * Loads a large number of rows into a table using many concurrent commits.
+ *
+ * Rows are grouped, in the order they are added, into commits of at most
+ * `BulkLoaderOptions::max_mutations_per_commit()` mutations, which are then
+ * committed by a pool of background threads. Spanner performs best when each
+ * commit touches a single split, so add the rows in primary key order if
+ * possible: every commit will then cover a contiguous range of keys.
+ *
+ * Each commit is an "insert or update" mutation, so rerunning a commit (for
+ * example, after a `kAborted` error, as controlled by the
+ * `TransactionRerunPolicy`) is always safe. A failed commit does not stop
+ * the load; the first error and the number of rows that were not written are
+ * reported in the `BulkLoadResult`.
+ *
+ * @par Example
+ * @code
+ * spanner::BulkLoader loader(client, "Singers", {"SingerId", "FirstName"});
+ * for (auto const& s : singers) {
+ *   loader.AddRow({spanner::Value(s.id), spanner::Value(s.name)});
+ * }
+ * auto result = loader.Finish();
+ * std::cout << result.rows_per_second() << " rows/s\n";
+ * @endcode
+ */
+class BulkLoader {
+ public:
+  /// Commits with the default rerun and backoff policies of `Client::Commit`.
+  BulkLoader(Client client, std::string table_name,
+             std::vector<std::string> column_names,
+             BulkLoaderOptions options = {});
+
+  /// Commits with clones of @p rerun_policy and @p backoff_policy.
+  BulkLoader(Client client, std::string table_name,
+             std::vector<std::string> column_names, BulkLoaderOptions options,
+             std::unique_ptr<TransactionRerunPolicy> rerun_policy,
+             std::unique_ptr<BackoffPolicy> backoff_policy);
+
+  /// Commits any remaining rows, and waits for all the commits to complete.
+  ~BulkLoader();
+
+  // This class owns background threads, it cannot be copied or moved.
+  BulkLoader(BulkLoader const&) = delete;
+  BulkLoader& operator=(BulkLoader const&) = delete;
+  BulkLoader(BulkLoader&&) = delete;
+  BulkLoader& operator=(BulkLoader&&) = delete;
+
+  /**
+   * Adds a row, with one value per column. Blocks while too many batches are
+   * waiting to be committed.
+   *
+   * May be called concurrently from multiple threads. Returns an error, and
+   * drops the row, if `Finish()` was already called.
+   */
+  Status AddRow(std::vector<Value> values);
+
+  /**
+   * Commits any remaining rows, waits for all the commits to complete, and
+   * returns the results. No rows may be added after calling `Finish()`.
+   */
+  BulkLoadResult Finish();
+
+ private:
+  struct Batch {
+    Mutation mutation;
+    std::int64_t row_count;
+  };
+
+  void FlushLocked();
+  void Run();
+  StatusOr<CommitResult> CommitBatch(Mutation const& mutation);
+
+  Client client_;
+  std::string table_name_;
+  std::vector<std::string> column_names_;
+  BulkLoaderOptions options_;
+  std::unique_ptr<TransactionRerunPolicy> rerun_policy_;
+  std::unique_ptr<BackoffPolicy> backoff_policy_;
+  std::chrono::steady_clock::time_point start_;
+
+  std::mutex mu_;
+  std::condition_variable work_cv_;
+  std::condition_variable space_cv_;
+  InsertOrUpdateMutationBuilder current_;  // GUARDED_BY(mu_)
+  std::int64_t current_rows_ = 0;          // GUARDED_BY(mu_)
+  std::deque<Batch> pending_;              // GUARDED_BY(mu_)
+  bool finished_ = false;                  // GUARDED_BY(mu_)
+  BulkLoadResult result_;                  // GUARDED_BY(mu_)
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_BULK_LOADER_H
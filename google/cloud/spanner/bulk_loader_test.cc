@@ -0,0 +1,231 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/bulk_loader.h"
+#include "google/cloud/spanner/mocks/mock_spanner_connection.h"
+#include "google/cloud/spanner/mutations.h"
+#include "google/cloud/spanner/timestamp.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <gmock/gmock.h>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+using ::google::cloud::spanner_mocks::MockConnection;
+using ::testing::_;
+
+std::vector<Value> MakeRow(std::int64_t key) {
+  return {Value(key), Value("value-" + std::to_string(key))};
+}
+
+// Options with a single commit thread, so the batches are committed in order.
+BulkLoaderOptions SerialOptions(std::size_t max_mutations) {
+  return BulkLoaderOptions{}
+      .set_max_mutations_per_commit(max_mutations)
+      .set_max_concurrent_commits(1);
+}
+
+CommitResult MakeCommitResult() {
+  return CommitResult{
+      MakeTimestamp(std::chrono::system_clock::from_time_t(1)).value()};
+}
+
+TEST(BulkLoader, SplitsRowsIntoCommits) {
+  auto conn = std::make_shared<MockConnection>();
+  std::vector<Mutations> commits;
+  EXPECT_CALL(*conn, Commit(_))
+      .WillRepeatedly([&commits](Connection::CommitParams const& p) {
+        commits.push_back(p.mutations);
+        return MakeCommitResult();
+      });
+
+  BulkLoader loader(Client(conn), "table", {"Key", "Value"}, SerialOptions(4));
+  for (std::int64_t key = 0; key != 5; ++key) {
+    EXPECT_STATUS_OK(loader.AddRow(MakeRow(key)));
+  }
+  auto result = loader.Finish();
+  EXPECT_STATUS_OK(result.status);
+  EXPECT_EQ(5, result.row_count);
+  EXPECT_EQ(0, result.failed_row_count);
+  EXPECT_EQ(3, result.commit_count);
+
+  // Each row has two cells, so each commit holds two rows, in input order.
+  auto batch = [](std::int64_t first, std::int64_t last) {
+    InsertOrUpdateMutationBuilder b("table", {"Key", "Value"});
+    for (auto key = first; key != last; ++key) b.AddRow(MakeRow(key));
+    return Mutations{std::move(b).Build()};
+  };
+  EXPECT_EQ(std::vector<Mutations>({batch(0, 2), batch(2, 4), batch(4, 5)}),
+            commits);
+}
+
+TEST(BulkLoader, ReportsFailedCommits) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, Commit(_))
+      .WillOnce([](Connection::CommitParams const&) {
+        return StatusOr<CommitResult>(MakeCommitResult());
+      })
+      .WillOnce([](Connection::CommitParams const&) {
+        return StatusOr<CommitResult>(
+            Status(StatusCode::kPermissionDenied, "uh-oh"));
+      })
+      .WillOnce([](Connection::CommitParams const&) {
+        return StatusOr<CommitResult>(MakeCommitResult());
+      });
+
+  BulkLoader loader(Client(conn), "table", {"Key", "Value"}, SerialOptions(4));
+  for (std::int64_t key = 0; key != 6; ++key) loader.AddRow(MakeRow(key));
+  auto result = loader.Finish();
+  EXPECT_EQ(StatusCode::kPermissionDenied, result.status.code());
+  EXPECT_EQ(4, result.row_count);
+  EXPECT_EQ(2, result.failed_row_count);
+  EXPECT_EQ(3, result.commit_count);
+}
+
+TEST(BulkLoader, RerunsAbortedCommits) {
+  auto conn = std::make_shared<MockConnection>();
+  int commit_attempts = 0;
+  EXPECT_CALL(*conn, Commit(_))
+      .WillRepeatedly([&commit_attempts](Connection::CommitParams const&) {
+        if (++commit_attempts == 1) {
+          return StatusOr<CommitResult>(
+              Status(StatusCode::kAborted, "Aborted transaction"));
+        }
+        return StatusOr<CommitResult>(MakeCommitResult());
+      });
+
+  BulkLoader loader(Client(conn), "table", {"Key", "Value"}, SerialOptions(4),
+                    LimitedErrorCountTransactionRerunPolicy(2).clone(),
+                    ExponentialBackoffPolicy(std::chrono::microseconds(10),
+                                             std::chrono::microseconds(10), 2.0)
+                        .clone());
+  loader.AddRow(MakeRow(1));
+  auto result = loader.Finish();
+  EXPECT_STATUS_OK(result.status);
+  EXPECT_EQ(1, result.row_count);
+  EXPECT_EQ(1, result.commit_count);
+  EXPECT_EQ(2, commit_attempts);
+}
+
+TEST(BulkLoader, ConcurrentCommits) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, Commit(_))
+      .WillRepeatedly(
+          [](Connection::CommitParams const&) { return MakeCommitResult(); });
+
+  auto const options = BulkLoaderOptions{}
+                           .set_max_mutations_per_commit(10)
+                           .set_max_concurrent_commits(4)
+                           .set_max_pending_batches(2);
+  auto result = [&] {
+    BulkLoader loader(Client(conn), "table", {"Key", "Value"}, options);
+    for (std::int64_t key = 0; key != 1000; ++key) loader.AddRow(MakeRow(key));
+    return loader.Finish();
+  }();
+  EXPECT_STATUS_OK(result.status);
+  EXPECT_EQ(1000, result.row_count);
+  EXPECT_EQ(200, result.commit_count);
+  EXPECT_LE(0, result.rows_per_second());
+}
+
+TEST(BulkLoader, ConcurrentProducers) {
+  auto conn = std::make_shared<MockConnection>();
+  std::mutex mu;
+  std::vector<std::size_t> commit_cells;
+  EXPECT_CALL(*conn, Commit(_))
+      .WillRepeatedly([&](Connection::CommitParams const& p) {
+        std::size_t cells = 0;
+        for (auto const& m : p.mutations) {
+          cells += internal::MutationCellCount(m);
+        }
+        {
+          std::lock_guard<std::mutex> lk(mu);
+          commit_cells.push_back(cells);
+        }
+        // Slow commits keep the producers waiting for room.
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        return MakeCommitResult();
+      });
+
+  auto const options = BulkLoaderOptions{}
+                           .set_max_mutations_per_commit(10)
+                           .set_max_concurrent_commits(1)
+                           .set_max_pending_batches(1);
+  BulkLoader loader(Client(conn), "table", {"Key", "Value"}, options);
+  auto constexpr kProducers = 8;
+  auto constexpr kRowsPerProducer = 100;
+  std::vector<std::thread> producers;
+  for (int i = 0; i != kProducers; ++i) {
+    producers.emplace_back([&loader, i] {
+      for (int j = 0; j != kRowsPerProducer; ++j) {
+        EXPECT_STATUS_OK(loader.AddRow(MakeRow(i * kRowsPerProducer + j)));
+      }
+    });
+  }
+  for (auto& t : producers) t.join();
+  auto result = loader.Finish();
+  EXPECT_STATUS_OK(result.status);
+  EXPECT_EQ(kProducers * kRowsPerProducer, result.row_count);
+
+  // Every commit is full, except possibly the last one, and none is empty.
+  ASSERT_EQ(result.commit_count,
+            static_cast<std::int64_t>(commit_cells.size()));
+  std::size_t total = 0;
+  for (auto cells : commit_cells) {
+    EXPECT_LT(0, cells);
+    EXPECT_GE(10, cells);
+    total += cells;
+  }
+  EXPECT_EQ(2 * kProducers * kRowsPerProducer, total);
+  EXPECT_EQ(kProducers * kRowsPerProducer / 5, result.commit_count);
+}
+
+TEST(BulkLoader, AddRowAfterFinish) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, Commit(_)).Times(0);
+
+  BulkLoader loader(Client(conn), "table", {"Key", "Value"});
+  auto result = loader.Finish();
+  EXPECT_STATUS_OK(result.status);
+  auto status = loader.AddRow(MakeRow(1));
+  EXPECT_EQ(StatusCode::kFailedPrecondition, status.code());
+  EXPECT_EQ(0, loader.Finish().row_count);
+}
+
+TEST(BulkLoader, DestructorCommitsRemainingRows) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, Commit(_))
+      .WillOnce([](Connection::CommitParams const& p) {
+        EXPECT_EQ(1U, p.mutations.size());
+        return MakeCommitResult();
+      });
+
+  BulkLoader loader(Client(conn), "table", {"Key", "Value"});
+  loader.AddRow(MakeRow(1));
+}
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -14,6 +14,7 @@
 
 #include "google/cloud/spanner/bytes.h"
 #include "google/cloud/status.h"
+#include <algorithm>
 #include <array>
 #include <cctype>
 #include <climits>
@@ -58,6 +59,61 @@ static_assert('A' == 65, "required by base64 decoder");
 // base64 encode large values. So, we demand exactly 255.
 static_assert(UCHAR_MAX == 255, "required by base64 decoder");
 
+// Encodes the `n` octets at `p`, where `n` is a multiple of 3, writing
+// 4 * n / 3 characters starting at `out`. Returns the end of the output.
+char* EncodeGroups(unsigned char const* p, std::size_t n, char* out) {
+  for (auto const* const ep = p + n; p != ep; p += 3) {
+    unsigned int const v = p[0] << 16 | p[1] << 8 | p[2];
+    out[0] = kIndexToChar[v >> 18];
+    out[1] = kIndexToChar[v >> 12 & 0x3f];
+    out[2] = kIndexToChar[v >> 6 & 0x3f];
+    out[3] = kIndexToChar[v & 0x3f];
+    out += 4;
+  }
+  return out;
+}
+
+// Encodes the final `n` (1 or 2) octets at `p`, writing 4 characters,
+// including padding, starting at `out`. Returns the end of the output.
+char* EncodePartialGroup(unsigned char const* p, std::size_t n, char* out) {
+  unsigned int const v = p[0] << 16 | (n == 2 ? p[1] << 8 : 0);
+  out[0] = kIndexToChar[v >> 18];
+  out[1] = kIndexToChar[v >> 12 & 0x3f];
+  out[2] = n == 2 ? kIndexToChar[v >> 6 & 0x3f] : kPadding;
+  out[3] = kPadding;
+  return out + 4;
+}
+
+// Decodes the `n` characters at `p`, where `n` is a multiple of 4 and the
+// input is known to be valid base64, writing the octets starting at `out`.
+// Returns the end of the output.
+unsigned char* DecodeGroups(unsigned char const* p, std::size_t n,
+                            unsigned char* out) {
+  if (n == 0) return out;
+  auto index = [](unsigned char c) -> unsigned int {
+    return kCharToIndexExcessOne[c] - 1;
+  };
+  // Only the last group may contain padding, so decode the others without
+  // looking for it.
+  for (auto const* const ep = p + n - 4; p != ep; p += 4) {
+    unsigned int const v =
+        index(p[0]) << 18 | index(p[1]) << 12 | index(p[2]) << 6 | index(p[3]);
+    out[0] = static_cast<unsigned char>(v >> 16);
+    out[1] = static_cast<unsigned char>(v >> 8);
+    out[2] = static_cast<unsigned char>(v);
+    out += 3;
+  }
+  unsigned int v = index(p[0]) << 18 | index(p[1]) << 12;
+  *out++ = static_cast<unsigned char>(v >> 16);
+  if (p[2] == kPadding) return out;
+  v |= index(p[2]) << 6;
+  *out++ = static_cast<unsigned char>(v >> 8);
+  if (p[3] == kPadding) return out;
+  v |= index(p[3]);
+  *out++ = static_cast<unsigned char>(v);
+  return out;
+}
+
 }  // namespace
 
 // Prints the bytes in the form B"...", where printable bytes are output
@@ -65,7 +121,8 @@ static_assert(UCHAR_MAX == 255, "required by base64 decoder");
 // are printed as a 3-digit octal escape sequence.
 std::ostream& operator<<(std::ostream& os, Bytes const& bytes) {
   os << R"(B")";
-  for (auto const byte : Bytes::Decoder(bytes.base64_rep_)) {
+  for (auto const c : bytes.Decode()) {
+    auto const byte = static_cast<unsigned char>(c);
     if (byte == '"') {
       os << R"(\")";
     } else if (std::isprint(byte)) {
@@ -87,58 +144,54 @@ std::ostream& operator<<(std::ostream& os, Bytes const& bytes) {
 }
 
 void Bytes::Encoder::Flush() {
-  unsigned int const v = buf_[0] << 16 | buf_[1] << 8 | buf_[2];
-  rep_.push_back(kIndexToChar[v >> 18]);
-  rep_.push_back(kIndexToChar[v >> 12 & 0x3f]);
-  rep_.push_back(kIndexToChar[v >> 6 & 0x3f]);
-  rep_.push_back(kIndexToChar[v & 0x3f]);
-  len_ = 0;
+  auto const groups = len_ / 3;
+  auto const offset = rep_.size();
+  rep_.resize(offset + 4 * groups);
+  EncodeGroups(buf_.data(), 3 * groups, &rep_[offset]);
+  // Move any partial group to the front of the buffer.
+  std::copy(buf_.data() + 3 * groups, buf_.data() + len_, buf_.data());
+  len_ -= 3 * groups;
 }
 
 void Bytes::Encoder::FlushAndPad() {
-  switch (len_) {
-    case 2: {
-      unsigned int const v = buf_[0] << 16 | buf_[1] << 8;
-      rep_.push_back(kIndexToChar[v >> 18]);
-      rep_.push_back(kIndexToChar[v >> 12 & 0x3f]);
-      rep_.push_back(kIndexToChar[v >> 6 & 0x3f]);
-      rep_.push_back(kPadding);
-      break;
-    }
-    case 1: {
-      unsigned int const v = buf_[0] << 16;
-      rep_.push_back(kIndexToChar[v >> 18]);
-      rep_.push_back(kIndexToChar[v >> 12 & 0x3f]);
-      rep_.append(2, kPadding);
-      break;
-    }
-  }
+  Flush();
+  if (len_ == 0) return;
+  auto const offset = rep_.size();
+  rep_.resize(offset + 4);
+  EncodePartialGroup(buf_.data(), len_, &rep_[offset]);
+  len_ = 0;
 }
 
-void Bytes::Decoder::Iterator::Fill() {
-  if (pos_ != end_) {
-    unsigned char p0 = *pos_++;
-    unsigned char p1 = *pos_++;
-    unsigned char p2 = *pos_++;
-    unsigned char p3 = *pos_++;
-    auto i0 = kCharToIndexExcessOne[p0] - 1;
-    auto i1 = kCharToIndexExcessOne[p1] - 1;
-    if (p3 == kPadding) {
-      if (p2 == kPadding) {
-        buf_[++len_] = i0 << 2 | i1 >> 4;
-      } else {
-        auto i2 = kCharToIndexExcessOne[p2] - 1;
-        buf_[++len_] = i1 << 4 | i2 >> 2;
-        buf_[++len_] = i0 << 2 | i1 >> 4;
-      }
-    } else {
-      auto i2 = kCharToIndexExcessOne[p2] - 1;
-      auto i3 = kCharToIndexExcessOne[p3] - 1;
-      buf_[++len_] = i2 << 6 | i3;
-      buf_[++len_] = i1 << 4 | i2 >> 2;
-      buf_[++len_] = i0 << 2 | i1 >> 4;
-    }
-  }
+void Bytes::EncodeOctets(unsigned char const* data, std::size_t size) {
+  auto const tail = size % 3;
+  base64_rep_.resize((size + 2) / 3 * 4);
+  auto* out = EncodeGroups(data, size - tail, &base64_rep_[0]);
+  if (tail != 0) EncodePartialGroup(data + size - tail, tail, out);
+}
+
+std::size_t Bytes::size() const {
+  auto const n = base64_rep_.size();
+  std::size_t size = n / 4 * 3;
+  if (n != 0 && base64_rep_[n - 1] == kPadding) --size;
+  if (n != 0 && base64_rep_[n - 2] == kPadding) --size;
+  return size;
+}
+
+unsigned char* Bytes::copy_to(unsigned char* buffer) const {
+  return DecodeGroups(
+      reinterpret_cast<unsigned char const*>(base64_rep_.data()),
+      base64_rep_.size(), buffer);
+}
+
+char* Bytes::copy_to(char* buffer) const {
+  auto* end = copy_to(reinterpret_cast<unsigned char*>(buffer));
+  return reinterpret_cast<char*>(end);
+}
+
+std::string Bytes::Decode() const {
+  std::string octets(size(), '\0');
+  copy_to(&octets[0]);
+  return octets;
 }
 
 namespace internal {
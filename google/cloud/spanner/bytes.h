@@ -22,6 +22,8 @@
 #include <iterator>
 #include <ostream>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 namespace google {
 namespace cloud {
@@ -51,23 +53,36 @@ class Bytes {
   ///@{
   template <typename InputIt>
   Bytes(InputIt first, InputIt last) {
-    Encoder encoder(base64_rep_);
-    while (first != last) {
-      encoder.buf_[encoder.len_++] = *first++;
-      if (encoder.len_ == encoder.buf_.size()) encoder.Flush();
-    }
-    if (encoder.len_ != 0) encoder.FlushAndPad();
+    Encode(first, last, IsOctetPointer<InputIt>{});
   }
   template <typename Container>
-  explicit Bytes(Container const& c) : Bytes(std::begin(c), std::end(c)) {}
+  explicit Bytes(Container const& c)
+      : Bytes(c, HasContiguousOctets<Container>{}) {}
+  ///@}
+
+  /// Construction from `size` octets starting at `data`, without copying
+  /// them to an intermediate buffer.
+  Bytes(void const* data, std::size_t size) {
+    EncodeOctets(static_cast<unsigned char const*>(data), size);
+  }
+
+  /// The number of octets. This does not decode the octets.
+  std::size_t size() const;
+
+  /**
+   * Decodes the octets directly into @p buffer, which must have room for at
+   * least `size()` octets. Returns a pointer one past the last octet written.
+   */
+  ///@{
+  char* copy_to(char* buffer) const;
+  unsigned char* copy_to(unsigned char* buffer) const;
   ///@}
 
   /// Conversion to a sequence of octets.  The `Container` must support
   /// construction from a range specified as a pair of input iterators.
   template <typename Container>
   Container get() const {
-    Decoder decoder(base64_rep_);
-    return Container(decoder.begin(), decoder.end());
+    return FromOctets(Decode(), static_cast<Container*>(nullptr));
   }
 
   /// @name Relational operators
@@ -90,6 +105,8 @@ class Bytes {
   friend StatusOr<Bytes> internal::BytesFromBase64(std::string input);
   friend std::string internal::BytesToBase64(Bytes b);
 
+  // Buffers octets from an arbitrary input range so they can be encoded a
+  // block at a time, rather than one 3-octet group per call.
   struct Encoder {
     explicit Encoder(std::string& rep) : rep_(rep), len_(0) {}
     void Flush();
@@ -97,59 +114,73 @@ class Bytes {
 
     std::string& rep_;  // encoded
     std::size_t len_;   // buf_[0 .. len_-1] pending encode
-    std::array<unsigned char, 3> buf_;
+    std::array<unsigned char, 3 * 256> buf_;
   };
 
-  struct Decoder {
-    class Iterator {
-     public:
-      using iterator_category = std::input_iterator_tag;
-      using value_type = unsigned char;
-      using difference_type = std::ptrdiff_t;
-      using pointer = value_type*;
-      using reference = value_type&;
-
-      Iterator(std::string::const_iterator begin,
-               std::string::const_iterator end)
-          : pos_(begin), end_(end), len_(0) {
-        Fill();
-      }
-
-      void Fill();
-
-      reference operator*() { return buf_[len_]; }
-      pointer operator->() { return &buf_[len_]; }
-
-      Iterator& operator++() {
-        if (--len_ == 0) Fill();
-        return *this;
-      }
-      Iterator operator++(int) {
-        auto const old = *this;
-        operator++();
-        return old;
-      }
-
-      friend bool operator==(Iterator const& a, Iterator const& b) {
-        return a.pos_ == b.pos_ && a.len_ == b.len_;
-      }
-      friend bool operator!=(Iterator const& a, Iterator const& b) {
-        return !(a == b);
-      }
-
-     private:
-      std::string::const_iterator pos_;  // [pos_ .. end_) pending decode
-      std::string::const_iterator end_;
-      std::size_t len_;  // buf_[len_ .. 1] decoded
-      std::array<value_type, 1 + 3> buf_;
-    };
-
-    explicit Decoder(std::string const& rep) : rep_(rep) {}
-    Iterator begin() { return Iterator(rep_.begin(), rep_.end()); }
-    Iterator end() { return Iterator(rep_.end(), rep_.end()); }
-
-    std::string const& rep_;  // encoded
-  };
+  // Pointers to octets can be encoded without staging them in the Encoder.
+  template <typename InputIt>
+  using IsOctetPointer = std::integral_constant<
+      bool, std::is_pointer<InputIt>::value &&
+                sizeof(typename std::iterator_traits<InputIt>::value_type) ==
+                    1>;
+
+  // Containers with `data()` and `size()` store their elements contiguously.
+  template <typename Container, typename = void>
+  struct HasContiguousOctets : std::false_type {};
+  template <typename Container>
+  struct HasContiguousOctets<
+      Container, decltype(void(std::declval<Container const&>().data()),
+                          void(std::declval<Container const&>().size()))>
+      : IsOctetPointer<decltype(std::declval<Container const&>().data())> {};
+
+  template <typename Container>
+  Bytes(Container const& c, std::true_type)
+      : Bytes(c.data(), c.data() + c.size()) {}
+  template <typename Container>
+  Bytes(Container const& c, std::false_type)
+      : Bytes(std::begin(c), std::end(c)) {}
+
+  template <typename InputIt>
+  void Encode(InputIt first, InputIt last, std::false_type) {
+    using category = typename std::iterator_traits<InputIt>::iterator_category;
+    Reserve(first, last, category{});
+    Encoder encoder(base64_rep_);
+    while (first != last) {
+      auto* p = encoder.buf_.data() + encoder.len_;
+      auto* const ep = encoder.buf_.data() + encoder.buf_.size();
+      while (p != ep && first != last) *p++ = *first++;
+      encoder.len_ = p - encoder.buf_.data();
+      encoder.Flush();
+    }
+    encoder.FlushAndPad();
+  }
+  template <typename OctetPtr>
+  void Encode(OctetPtr first, OctetPtr last, std::true_type) {
+    EncodeOctets(reinterpret_cast<unsigned char const*>(first),
+                 static_cast<std::size_t>(last - first));
+  }
+  void EncodeOctets(unsigned char const* data, std::size_t size);
+
+  // Sizes `base64_rep_` for the encoded range when that is cheap to compute.
+  template <typename InputIt>
+  void Reserve(InputIt, InputIt, std::input_iterator_tag) {}
+  template <typename RandomIt>
+  void Reserve(RandomIt first, RandomIt last,
+               std::random_access_iterator_tag) {
+    auto const n = static_cast<std::size_t>(last - first);
+    base64_rep_.reserve((n + 2) / 3 * 4);
+  }
+
+  // Decodes `base64_rep_` in a single pass.
+  std::string Decode() const;
+
+  template <typename Container>
+  static Container FromOctets(std::string const& s, Container*) {
+    // Convert through `unsigned char`, so wider elements are in [0, 255].
+    auto const* data = reinterpret_cast<unsigned char const*>(s.data());
+    return Container(data, data + s.size());
+  }
+  static std::string FromOctets(std::string s, std::string*) { return s; }
 
   std::string base64_rep_;  // valid base64 representation
 };
@@ -14,7 +14,9 @@
 
 #include "google/cloud/spanner/bytes.h"
 #include <benchmark/benchmark.h>
+#include <random>
 #include <string>
+#include <vector>
 
 namespace google {
 namespace cloud {
@@ -81,6 +83,54 @@ void BM_BytesGet(benchmark::State& state) {
 }
 BENCHMARK(BM_BytesGet);
 
+std::vector<char> MakePayload(std::size_t size) {
+  std::mt19937_64 gen(size);
+  std::uniform_int_distribution<int> dist(0, 255);
+  std::vector<char> payload(size);
+  for (auto& c : payload) c = static_cast<char>(dist(gen));
+  return payload;
+}
+
+void BM_BytesCtorPayload(benchmark::State& state) {
+  auto const payload = MakePayload(static_cast<std::size_t>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Bytes(payload));
+  }
+  state.SetBytesProcessed(state.iterations() * payload.size());
+}
+BENCHMARK(BM_BytesCtorPayload)->RangeMultiplier(4)->Range(64, 1 << 20);
+
+void BM_BytesGetPayload(benchmark::State& state) {
+  auto const payload = MakePayload(static_cast<std::size_t>(state.range(0)));
+  Bytes b(payload);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(b.get<std::vector<char>>());
+  }
+  state.SetBytesProcessed(state.iterations() * payload.size());
+}
+BENCHMARK(BM_BytesGetPayload)->RangeMultiplier(4)->Range(64, 1 << 20);
+
+void BM_BytesCopyToPayload(benchmark::State& state) {
+  auto const payload = MakePayload(static_cast<std::size_t>(state.range(0)));
+  Bytes b(payload);
+  std::vector<char> buffer(b.size());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(b.copy_to(buffer.data()));
+  }
+  state.SetBytesProcessed(state.iterations() * payload.size());
+}
+BENCHMARK(BM_BytesCopyToPayload)->RangeMultiplier(4)->Range(64, 1 << 20);
+
+void BM_BytesFromBase64Payload(benchmark::State& state) {
+  auto const payload = MakePayload(static_cast<std::size_t>(state.range(0)));
+  auto const base64 = internal::BytesToBase64(Bytes(payload));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(internal::BytesFromBase64(base64));
+  }
+  state.SetBytesProcessed(state.iterations() * base64.size());
+}
+BENCHMARK(BM_BytesFromBase64Payload)->RangeMultiplier(4)->Range(64, 1 << 20);
+
 }  // namespace
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner
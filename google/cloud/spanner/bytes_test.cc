@@ -118,6 +118,25 @@ TEST(Bytes, LongerRoundTrip) {
   }
 }
 
+TEST(Bytes, LargePayloadRoundTrip) {
+  // Exercise payloads around the multiples of the encoder's internal block.
+  for (std::size_t size : {767, 768, 769, 1535, 1536, 1537, 100000}) {
+    std::string data(size, '\0');
+    for (std::size_t i = 0; i != size; ++i) {
+      data[i] = static_cast<char>(i * 7 + i / 256);
+    }
+    Bytes bytes(data);
+    auto const base64 = internal::BytesToBase64(bytes);
+    EXPECT_EQ((size + 2) / 3 * 4, base64.size());
+    EXPECT_EQ(data, bytes.get<std::string>());
+    EXPECT_EQ(Bytes(std::deque<char>(data.begin(), data.end())), bytes);
+
+    auto decoded = internal::BytesFromBase64(base64);
+    EXPECT_STATUS_OK(decoded) << size;
+    EXPECT_EQ(data, decoded->get<std::string>());
+  }
+}
+
 TEST(Bytes, RFC4648TestVectors) {
   // https://tools.ietf.org/html/rfc4648#section-10
   std::vector<std::pair<std::string, std::string>> test_cases = {
@@ -235,6 +254,50 @@ TEST(Bytes, Conversions) {
   EXPECT_EQ(v_plain, bytes->get<std::vector<std::uint8_t>>());
 }
 
+TEST(Bytes, HighBitOctets) {
+  std::vector<int> const octets = {0x00, 0x01, 0x7f, 0x80, 0xc3, 0xff};
+  Bytes const bytes(octets);
+  EXPECT_EQ("AAF/gMP/", internal::BytesToBase64(bytes));
+  EXPECT_EQ(octets, bytes.get<std::vector<int>>());
+  EXPECT_EQ(std::vector<std::uint8_t>(octets.begin(), octets.end()),
+            bytes.get<std::vector<std::uint8_t>>());
+  EXPECT_EQ(std::deque<std::int64_t>(octets.begin(), octets.end()),
+            bytes.get<std::deque<std::int64_t>>());
+  EXPECT_EQ(std::string("\x00\x01\x7f\x80\xc3\xff", 6),
+            bytes.get<std::string>());
+}
+
+TEST(Bytes, SizeAndCopyTo) {
+  for (std::string const plain : {"", "f", "fo", "foo", "foob", "fooba"}) {
+    Bytes const bytes(plain);
+    EXPECT_EQ(plain.size(), bytes.size());
+
+    std::vector<char> buffer(bytes.size() + 1, '#');
+    auto* end = bytes.copy_to(buffer.data());
+    EXPECT_EQ(buffer.data() + plain.size(), end);
+    EXPECT_EQ(plain, std::string(buffer.data(), end));
+    EXPECT_EQ('#', buffer.back());
+
+    std::vector<std::uint8_t> octets(bytes.size());
+    auto* uend = bytes.copy_to(octets.data());
+    EXPECT_EQ(octets.data() + octets.size(), uend);
+    EXPECT_EQ(std::vector<std::uint8_t>(plain.begin(), plain.end()), octets);
+  }
+}
+
+TEST(Bytes, RawConstruction) {
+  std::string const plain = "The quick brown fox jumps over the lazy dog.";
+  for (std::size_t n = 0; n != plain.size(); ++n) {
+    auto const expected =
+        Bytes(std::deque<char>(plain.begin(), plain.begin() + n));
+    EXPECT_EQ(expected, Bytes(plain.data(), n));
+    EXPECT_EQ(expected, Bytes(plain.data(), plain.data() + n));
+    EXPECT_EQ(expected, Bytes(plain.substr(0, n)));
+    auto const* u = reinterpret_cast<unsigned char const*>(plain.data());
+    EXPECT_EQ(expected, Bytes(u, u + n));
+  }
+}
+
 TEST(Bytes, RelationalOperators) {
   std::string const s_plain = "The quick brown fox jumps over the lazy dog.";
   std::deque<char> const d_plain(s_plain.begin(), s_plain.end());
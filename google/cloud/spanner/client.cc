@@ -14,7 +14,10 @@
 
 #include "google/cloud/spanner/client.h"
 #include "google/cloud/spanner/backoff_policy.h"
+#include "google/cloud/spanner/internal/batch_read.h"
 #include "google/cloud/spanner/internal/connection_impl.h"
+#include "google/cloud/spanner/internal/deadline_connection.h"
+#include "google/cloud/spanner/internal/read_timestamp_cache.h"
 #include "google/cloud/spanner/internal/retry_loop.h"
 #include "google/cloud/spanner/internal/spanner_stub.h"
 #include "google/cloud/spanner/internal/status_utils.h"
@@ -23,6 +26,8 @@
 #include "google/cloud/internal/getenv.h"
 #include "google/cloud/log.h"
 #include <grpcpp/grpcpp.h>
+#include <algorithm>
+#include <atomic>
 #include <thread>
 
 namespace google {
@@ -30,6 +35,29 @@ namespace cloud {
 namespace spanner {
 inline namespace SPANNER_CLIENT_NS {
 
+namespace {
+
+// Wrap @p conn in the decorators enabled by @p opts.
+std::shared_ptr<Connection> DecorateConnection(std::shared_ptr<Connection> conn,
+                                               ClientOptions const& opts) {
+  if (opts.cache_read_timestamps()) {
+    conn = internal::MakeReadTimestampCacheConnection(std::move(conn));
+  }
+  if (opts.operation_timeout().count() > 0 ||
+      opts.attempt_timeout().count() > 0) {
+    conn = internal::MakeDeadlineConnection(
+        std::move(conn), opts.operation_timeout(), opts.attempt_timeout());
+  }
+  return conn;
+}
+
+}  // namespace
+
+Client::Client(std::shared_ptr<Connection> conn, ClientOptions opts)
+    : conn_(DecorateConnection(conn, opts)),
+      undecorated_conn_(std::move(conn)),
+      opts_(std::move(opts)) {}
+
 RowStream Client::Read(std::string table, KeySet keys,
                        std::vector<std::string> columns,
                        ReadOptions read_options) {
@@ -66,6 +94,49 @@ RowStream Client::Read(Transaction transaction, std::string table, KeySet keys,
                       {}});
 }
 
+std::vector<StatusOr<std::vector<Row>>> Client::BatchRead(
+    std::vector<ReadRequest> requests, BatchReadOptions const& options) {
+  return BatchRead(Transaction::ReadOnlyOptions(), std::move(requests),
+                   options);
+}
+
+std::vector<StatusOr<std::vector<Row>>> Client::BatchRead(
+    Transaction::SingleUseOptions transaction_options,
+    std::vector<ReadRequest> requests, BatchReadOptions const& options) {
+  std::vector<StatusOr<std::vector<Row>>> results(requests.size());
+  auto const groups = internal::GroupReadRequests(
+      std::move(requests), options.combine_point_reads());
+
+  // Each worker claims the next unread group, until none are left. Groups
+  // answer disjoint requests, so the workers write disjoint `results`.
+  std::atomic<std::size_t> next(0);
+  auto worker = [&] {
+    for (auto g = next++; g < groups.size(); g = next++) {
+      auto const& request = groups[g].request;
+      auto stream = Read(transaction_options, request.table, request.keys,
+                         request.columns, request.read_options);
+      StatusOr<std::vector<Row>> rows = std::vector<Row>{};
+      for (auto& row : stream) {
+        if (!row) {
+          rows = std::move(row).status();
+          break;
+        }
+        rows->push_back(*std::move(row));
+      }
+      internal::DistributeReadResult(groups[g], std::move(rows), results);
+    }
+  };
+
+  auto const concurrency = (std::min)(
+      static_cast<std::size_t>((std::max)(options.max_concurrent_reads(), 1)),
+      groups.size());
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < concurrency; ++i) threads.emplace_back(worker);
+  worker();
+  for (auto& t : threads) t.join();
+  return results;
+}
+
 RowStream Client::Read(ReadPartition const& read_partition) {
   return conn_->Read(internal::MakeReadParams(read_partition));
 }
@@ -185,74 +256,139 @@ StatusOr<BatchDmlResult> Client::ExecuteBatchDml(
       {std::move(transaction), std::move(statements)});
 }
 
-StatusOr<CommitResult> Client::Commit(
+optional<StatusOr<CommitResult>> Client::CommitAttempt(
     std::function<StatusOr<Mutations>(Transaction)> const& mutator,
-    std::unique_ptr<TransactionRerunPolicy> rerun_policy,
-    std::unique_ptr<BackoffPolicy> backoff_policy) {
+    Transaction& txn, TransactionRerunPolicy& rerun_policy) {
   // The status-code discriminator of TransactionRerunPolicy.
   using RerunnablePolicy = internal::SafeTransactionRerun;
 
-  Transaction txn = MakeReadWriteTransaction();
-  for (int rerun = 0;; ++rerun) {
-    StatusOr<Mutations> mutations;
+  StatusOr<Mutations> mutations;
 #if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
-    try {
+  try {
 #endif
-      mutations = mutator(txn);
+    mutations = mutator(txn);
 #if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
-    } catch (RuntimeStatusError const& error) {
-      // Treat this like mutator() returned a bad Status.
-      Status status = error.status();
-      if (status.ok()) {
-        status = Status(StatusCode::kUnknown, "OK Status thrown from mutator");
-      }
-      mutations = status;
-    } catch (...) {
+  } catch (RuntimeStatusError const& error) {
+    // Treat this like mutator() returned a bad Status.
+    Status status = error.status();
+    if (status.ok()) {
+      status = Status(StatusCode::kUnknown, "OK Status thrown from mutator");
+    }
+    mutations = status;
+  } catch (...) {
+    auto rb_status = Rollback(txn);
+    if (!RerunnablePolicy::IsOk(rb_status)) {
+      GCP_LOG(WARNING) << "Rollback() failure in Client::Commit(): "
+                       << rb_status.message();
+    }
+    throw;
+  }
+#endif
+  auto status = mutations.status();
+  if (RerunnablePolicy::IsOk(status)) {
+    auto result = Commit(txn, *std::move(mutations));
+    status = result.status();
+    if (!RerunnablePolicy::IsTransientFailure(status)) {
+      return result;
+    }
+  } else {
+    if (!RerunnablePolicy::IsTransientFailure(status)) {
       auto rb_status = Rollback(txn);
       if (!RerunnablePolicy::IsOk(rb_status)) {
         GCP_LOG(WARNING) << "Rollback() failure in Client::Commit(): "
                          << rb_status.message();
       }
-      throw;
+      return StatusOr<CommitResult>(status);
     }
+  }
+  // A transient failure (e.g., kAborted), so consider rerunning.
+  if (!rerun_policy.OnFailure(status)) {
+    return StatusOr<CommitResult>(status);  // reruns exhausted
+  }
+  if (internal::IsSessionNotFound(status)) {
+    // Marks the session bad and creates a new Transaction for the next loop.
+    internal::Visit(txn, [](internal::SessionHolder& s,
+                            google::spanner::v1::TransactionSelector const&,
+                            std::int64_t) {
+      if (s) s->set_bad();
+      return true;
+    });
+    txn = MakeReadWriteTransaction();
+  } else {
+    // Create a new transaction for the next loop, but reuse the session
+    // so that we have a slightly better chance of avoiding another abort.
+    txn = MakeReadWriteTransaction(txn);
+  }
+  return {};
+}
+
+StatusOr<CommitResult> Client::Commit(
+    std::function<StatusOr<Mutations>(Transaction)> const& mutator,
+    std::unique_ptr<TransactionRerunPolicy> rerun_policy,
+    std::unique_ptr<BackoffPolicy> backoff_policy) {
+  Transaction txn = MakeReadWriteTransaction();
+  for (;;) {
+    auto result = CommitAttempt(mutator, txn, *rerun_policy);
+    if (result) return *std::move(result);
+    std::this_thread::sleep_for(backoff_policy->OnCompletion());
+  }
+}
+
+// The state of one `AsyncCommit()` call, shared by its timer callbacks.
+struct Client::AsyncCommitState {
+  CompletionQueue cq;
+  std::function<StatusOr<Mutations>(Transaction)> mutator;
+  std::unique_ptr<TransactionRerunPolicy> rerun_policy;
+  std::unique_ptr<BackoffPolicy> backoff_policy;
+  Transaction txn;
+  promise<StatusOr<CommitResult>> result;
+};
+
+void Client::AsyncCommitLoop(std::shared_ptr<AsyncCommitState> state) {
+  optional<StatusOr<CommitResult>> result;
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+  try {
 #endif
-    auto status = mutations.status();
-    if (RerunnablePolicy::IsOk(status)) {
-      auto result = Commit(txn, *mutations);
-      status = result.status();
-      if (!RerunnablePolicy::IsTransientFailure(status)) {
-        return result;
-      }
-    } else {
-      if (!RerunnablePolicy::IsTransientFailure(status)) {
-        auto rb_status = Rollback(txn);
-        if (!RerunnablePolicy::IsOk(rb_status)) {
-          GCP_LOG(WARNING) << "Rollback() failure in Client::Commit(): "
-                           << rb_status.message();
+    result = CommitAttempt(state->mutator, state->txn, *state->rerun_policy);
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+  } catch (...) {
+    // This may run in a CompletionQueue thread, so report the exception
+    // through the future instead of letting it escape.
+    state->result.set_exception(std::current_exception());
+    return;
+  }
+#endif
+  if (result) {
+    state->result.set_value(*std::move(result));
+    return;
+  }
+  // Wait for the backoff on a timer, rather than blocking this thread.
+  auto delay = state->backoff_policy->OnCompletion();
+  auto client = *this;
+  state->cq.MakeRelativeTimer(delay).then(
+      [client, state](
+          future<StatusOr<std::chrono::system_clock::time_point>> f) mutable {
+        auto timer = f.get();
+        if (!timer) {
+          state->result.set_value(std::move(timer).status());
+          return;
         }
-        return status;
-      }
-    }
-    // A transient failure (e.g., kAborted), so consider rerunning.
-    if (!rerun_policy->OnFailure(status)) {
-      return status;  // reruns exhausted
-    }
-    if (internal::IsSessionNotFound(status)) {
-      // Marks the session bad and creates a new Transaction for the next loop.
-      internal::Visit(txn, [](internal::SessionHolder& s,
-                              google::spanner::v1::TransactionSelector const&,
-                              std::int64_t) {
-        if (s) s->set_bad();
-        return true;
+        client.AsyncCommitLoop(std::move(state));
       });
-      txn = MakeReadWriteTransaction();
-    } else {
-      // Create a new transaction for the next loop, but reuse the session
-      // so that we have a slightly better chance of avoiding another abort.
-      txn = MakeReadWriteTransaction(txn);
-    }
-    std::this_thread::sleep_for(backoff_policy->OnCompletion());
-  }
+}
+
+future<StatusOr<CommitResult>> Client::AsyncCommit(
+    CompletionQueue cq,
+    std::function<StatusOr<Mutations>(Transaction)> mutator,
+    std::unique_ptr<TransactionRerunPolicy> rerun_policy,
+    std::unique_ptr<BackoffPolicy> backoff_policy) {
+  auto state = std::make_shared<AsyncCommitState>(AsyncCommitState{
+      std::move(cq), std::move(mutator), std::move(rerun_policy),
+      std::move(backoff_policy), MakeReadWriteTransaction(),
+      promise<StatusOr<CommitResult>>{}});
+  auto f = state->result.get_future();
+  AsyncCommitLoop(std::move(state));
+  return f;
 }
 
 StatusOr<CommitResult> Client::Commit(
@@ -319,27 +455,37 @@ QueryOptions Client::OverlayQueryOptions(QueryOptions const& preferred) {
 
 std::shared_ptr<Connection> MakeConnection(
     Database const& db, ConnectionOptions const& connection_options,
-    SessionPoolOptions session_pool_options) {
+    SessionPoolOptions session_pool_options,
+    ConnectionTuningOptions tuning_options) {
   return MakeConnection(db, connection_options, std::move(session_pool_options),
                         internal::DefaultConnectionRetryPolicy(),
-                        internal::DefaultConnectionBackoffPolicy());
+                        internal::DefaultConnectionBackoffPolicy(),
+                        std::move(tuning_options));
 }
 
 std::shared_ptr<Connection> MakeConnection(
     Database const& db, ConnectionOptions const& connection_options,
     SessionPoolOptions session_pool_options,
     std::unique_ptr<RetryPolicy> retry_policy,
-    std::unique_ptr<BackoffPolicy> backoff_policy) {
+    std::unique_ptr<BackoffPolicy> backoff_policy,
+    ConnectionTuningOptions tuning_options) {
   std::vector<std::shared_ptr<internal::SpannerStub>> stubs;
   int num_channels = std::max(connection_options.num_channels(), 1);
   stubs.reserve(num_channels);
   for (int channel_id = 0; channel_id < num_channels; ++channel_id) {
-    stubs.push_back(
-        internal::CreateDefaultSpannerStub(connection_options, channel_id));
+    stubs.push_back(internal::CreateDefaultSpannerStub(
+        connection_options, channel_id, tuning_options));
   }
+  // The session pool uses this to recreate the channels in a bad state.
+  auto stub_factory = [connection_options, tuning_options](int channel_id,
+                                                          int generation) {
+    return internal::CreateDefaultSpannerStub(connection_options, channel_id,
+                                              tuning_options, generation);
+  };
   return internal::MakeConnection(
       db, std::move(stubs), connection_options, std::move(session_pool_options),
-      std::move(retry_policy), std::move(backoff_policy));
+      std::move(retry_policy), std::move(backoff_policy),
+      std::move(stub_factory), std::move(tuning_options));
 }
 
 }  // namespace SPANNER_CLIENT_NS
@@ -17,10 +17,12 @@
 
 #include "google/cloud/spanner/backoff_policy.h"
 #include "google/cloud/spanner/batch_dml_result.h"
+#include "google/cloud/spanner/batch_read_options.h"
 #include "google/cloud/spanner/client_options.h"
 #include "google/cloud/spanner/commit_result.h"
 #include "google/cloud/spanner/connection.h"
 #include "google/cloud/spanner/connection_options.h"
+#include "google/cloud/spanner/connection_tuning_options.h"
 #include "google/cloud/spanner/database.h"
 #include "google/cloud/spanner/keys.h"
 #include "google/cloud/spanner/mutations.h"
@@ -34,6 +36,8 @@
 #include "google/cloud/spanner/session_pool_options.h"
 #include "google/cloud/spanner/sql_statement.h"
 #include "google/cloud/spanner/transaction.h"
+#include "google/cloud/completion_queue.h"
+#include "google/cloud/future.h"
 #include "google/cloud/optional.h"
 #include "google/cloud/status.h"
 #include "google/cloud/status_or.h"
@@ -118,9 +122,14 @@ class Client {
    * See `MakeConnection()` for how to create a connection to Spanner. To help
    * with unit testing, callers may create fake/mock `Connection` objects that
    * are injected into the `Client`.
+   *
+   * If `opts.cache_read_timestamps()` is true, @p conn is wrapped in a
+   * decorator that serves bounded-staleness reads from a cached timestamp,
+   * shared by this `Client` and its copies. Likewise, if
+   * `opts.operation_timeout()` or `opts.attempt_timeout()` is set, @p conn is
+   * wrapped in a decorator that sets the deadline of each operation.
    */
-  explicit Client(std::shared_ptr<Connection> conn, ClientOptions opts = {})
-      : conn_(std::move(conn)), opts_(std::move(opts)) {}
+  explicit Client(std::shared_ptr<Connection> conn, ClientOptions opts = {});
 
   /// No default construction. Use `Client(std::shared_ptr<Connection>)`
   Client() = delete;
@@ -135,8 +144,12 @@ class Client {
 
   //@{
   // @name Equality
+  //
+  // Clients are equal if they were created with the same `Connection`, even
+  // if their `ClientOptions` enable different decorators (for example, they
+  // do not share a cache of read timestamps).
   friend bool operator==(Client const& a, Client const& b) {
-    return a.conn_ == b.conn_;
+    return a.undecorated_conn_ == b.undecorated_conn_;
   }
   friend bool operator!=(Client const& a, Client const& b) { return !(a == b); }
   //@}
@@ -191,6 +204,41 @@ class Client {
                  ReadOptions read_options = {});
   //@}
 
+  //@{
+  /**
+   * Runs many independent reads, concurrently, and returns their rows.
+   *
+   * Fetching rows from several tables, or by many keys, with a sequence of
+   * `Read()` calls takes one round trip per call. `BatchRead()` issues the
+   * reads in parallel, each on its own session from the pool, so the whole
+   * batch takes about as long as its slowest read. Optionally, requests for
+   * the same columns of the same table by point keys are combined into a
+   * single read, see `BatchReadOptions::set_combine_point_reads()`.
+   *
+   * Each read runs in its own single-use transaction, with default options or
+   * with @p transaction_options. Use an exact-staleness timestamp if the reads
+   * must observe the same snapshot of the database.
+   *
+   * @param requests The reads to run.
+   * @param options Controls concurrency and how requests are combined.
+   *
+   * @return The rows of each request, or the error that its read failed with,
+   *     in the same order as @p requests.
+   */
+  std::vector<StatusOr<std::vector<Row>>> BatchRead(
+      std::vector<ReadRequest> requests, BatchReadOptions const& options = {});
+
+  /**
+   * @copydoc BatchRead
+   *
+   * @param transaction_options Execute each read in a single-use transaction
+   * with these options.
+   */
+  std::vector<StatusOr<std::vector<Row>>> BatchRead(
+      Transaction::SingleUseOptions transaction_options,
+      std::vector<ReadRequest> requests, BatchReadOptions const& options = {});
+  //@}
+
   /**
    * Reads rows from a subset of rows in a database. Requires a prior call
    * to `PartitionRead` to obtain the partition information; see the
@@ -546,6 +594,33 @@ class Client {
   StatusOr<CommitResult> Commit(
       std::function<StatusOr<Mutations>(Transaction)> const& mutator);
 
+  /**
+   * Commits a read-write transaction, without blocking between reruns.
+   *
+   * Same as `Commit(mutator, rerun_policy, backoff_policy)`, except that the
+   * backoff between reruns is a timer on @p cq, instead of a sleep in the
+   * calling thread. The first attempt runs in the calling thread, and each
+   * rerun runs in a thread servicing @p cq, so many contending transactions
+   * can wait for their reruns without holding a thread each.
+   *
+   * The @p mutator and `Commit()` RPCs still block the thread that runs them.
+   * Exceptions thrown by @p mutator (other than `RuntimeStatusError`) are
+   * reported through the returned future.
+   *
+   * @param cq the completion queue used for the backoff timers. The caller
+   *     must keep at least one thread servicing @p cq until the returned
+   *     future is satisfied.
+   * @param mutator the function called to create mutations
+   * @param rerun_policy controls for how long (or how many times) the mutator
+   *     will be rerun after the transaction aborts.
+   * @param backoff_policy controls how long to wait between reruns.
+   */
+  future<StatusOr<CommitResult>> AsyncCommit(
+      CompletionQueue cq,
+      std::function<StatusOr<Mutations>(Transaction)> mutator,
+      std::unique_ptr<TransactionRerunPolicy> rerun_policy,
+      std::unique_ptr<BackoffPolicy> backoff_policy);
+
   /**
    * Commits the given @p mutations atomically in order.
    *
@@ -620,9 +695,21 @@ class Client {
   StatusOr<PartitionedDmlResult> ExecutePartitionedDml(SqlStatement statement);
 
  private:
+  struct AsyncCommitState;
+
   QueryOptions OverlayQueryOptions(QueryOptions const&);
 
+  // Runs one attempt of the `Commit(mutator, ...)` rerun loop. Returns the
+  // final result, or an empty optional if the transaction should be rerun,
+  // in which case `txn` is replaced by the transaction for the rerun.
+  optional<StatusOr<CommitResult>> CommitAttempt(
+      std::function<StatusOr<Mutations>(Transaction)> const& mutator,
+      Transaction& txn, TransactionRerunPolicy& rerun_policy);
+  void AsyncCommitLoop(std::shared_ptr<AsyncCommitState> state);
+
   std::shared_ptr<Connection> conn_;
+  // The `Connection` given to the constructor, before any decorators.
+  std::shared_ptr<Connection> undecorated_conn_;
   ClientOptions opts_;
 };
 
@@ -639,14 +726,17 @@ class Client {
  *     this function.
  * @param session_pool_options (optional) configure the `SessionPool` created
  *     by the `Connection`.
+ * @param tuning_options (optional) enable the optional features of the
+ *     `Connection`, e.g. tracing.
  */
 std::shared_ptr<Connection> MakeConnection(
     Database const& db,
     ConnectionOptions const& connection_options = ConnectionOptions(),
-    SessionPoolOptions session_pool_options = SessionPoolOptions());
+    SessionPoolOptions session_pool_options = SessionPoolOptions(),
+    ConnectionTuningOptions tuning_options = ConnectionTuningOptions());
 
 /**
- * @copydoc MakeConnection(Database const&, ConnectionOptions const&, SessionPoolOptions)
+ * @copydoc MakeConnection(Database const&, ConnectionOptions const&, SessionPoolOptions, ConnectionTuningOptions)
  *
  * @param retry_policy override the default `RetryPolicy`, controls how long
  *     the returned `Connection` object retries requests on transient
@@ -658,7 +748,8 @@ std::shared_ptr<Connection> MakeConnection(
     Database const& db, ConnectionOptions const& connection_options,
     SessionPoolOptions session_pool_options,
     std::unique_ptr<RetryPolicy> retry_policy,
-    std::unique_ptr<BackoffPolicy> backoff_policy);
+    std::unique_ptr<BackoffPolicy> backoff_policy,
+    ConnectionTuningOptions tuning_options = ConnectionTuningOptions());
 
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner
@@ -17,6 +17,7 @@
 
 #include "google/cloud/spanner/query_options.h"
 #include "google/cloud/spanner/version.h"
+#include <chrono>
 #include <string>
 
 namespace google {
@@ -45,8 +46,73 @@ class ClientOptions {
     return *this;
   }
 
+  /// Returns true if bounded-staleness reads use a cached read timestamp.
+  bool cache_read_timestamps() const { return cache_read_timestamps_; }
+
+  /**
+   * Serve bounded-staleness reads from a cached read timestamp.
+   *
+   * Single-use reads and queries with a bounded-staleness timestamp bound
+   * (`Transaction::SingleUseOptions` with a `min_read_timestamp` or a
+   * `max_staleness`) normally have Spanner negotiate their read timestamp.
+   * With this option the `Client` remembers the newest read timestamp its
+   * reads observed, and sends a bounded-staleness read as an exact-timestamp
+   * read at that timestamp if it satisfies the bound, so the nearest replica
+   * can serve it without negotiation. One read at a time is still sent with
+   * its own bound to refresh the cached timestamp, once it is older than half
+   * of the read's `max_staleness`.
+   *
+   * The bound is checked against the local clock.
+   */
+  ClientOptions& set_cache_read_timestamps(bool value) {
+    cache_read_timestamps_ = value;
+    return *this;
+  }
+
+  /// Returns the maximum duration of each operation, zero if unbounded.
+  std::chrono::milliseconds operation_timeout() const {
+    return operation_timeout_;
+  }
+
+  /**
+   * Bound the duration of each operation, e.g. each `Read()` or `Commit()`.
+   *
+   * The timeout covers the retries and backoffs of the operation, waiting for
+   * a session from the pool, and, for `Read()` and `ExecuteQuery()`, reading
+   * the rows from the returned `RowStream`. An operation that runs out of
+   * time fails with `StatusCode::kDeadlineExceeded`. The `Commit()` overloads
+   * that rerun a transaction apply the timeout to each read and commit in the
+   * transaction, not to the whole loop. The default, zero, leaves operations
+   * bound only by the `RetryPolicy`.
+   */
+  ClientOptions& set_operation_timeout(std::chrono::milliseconds value) {
+    operation_timeout_ = value;
+    return *this;
+  }
+
+  /// Returns the maximum duration of each RPC attempt, zero if unbounded.
+  std::chrono::milliseconds attempt_timeout() const {
+    return attempt_timeout_;
+  }
+
+  /**
+   * Bound the duration of each attempt of the non-streaming RPCs.
+   *
+   * An attempt that runs out of time is retried like a transient failure, if
+   * the RPC can be retried, and is cut short to fit in the remaining time of
+   * the `operation_timeout()`. Streaming reads are only bound by the
+   * `operation_timeout()`. The default, zero, leaves attempts unbounded.
+   */
+  ClientOptions& set_attempt_timeout(std::chrono::milliseconds value) {
+    attempt_timeout_ = value;
+    return *this;
+  }
+
   friend bool operator==(ClientOptions const& a, ClientOptions const& b) {
-    return a.query_options_ == b.query_options_;
+    return a.query_options_ == b.query_options_ &&
+           a.cache_read_timestamps_ == b.cache_read_timestamps_ &&
+           a.operation_timeout_ == b.operation_timeout_ &&
+           a.attempt_timeout_ == b.attempt_timeout_;
   }
 
   friend bool operator!=(ClientOptions const& a, ClientOptions const& b) {
@@ -55,6 +121,9 @@ class ClientOptions {
 
  private:
   QueryOptions query_options_;
+  bool cache_read_timestamps_ = false;
+  std::chrono::milliseconds operation_timeout_{0};
+  std::chrono::milliseconds attempt_timeout_{0};
 };
 
 }  // namespace SPANNER_CLIENT_NS
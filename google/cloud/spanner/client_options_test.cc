@@ -16,6 +16,7 @@
 #include "google/cloud/spanner/query_options.h"
 #include "google/cloud/spanner/version.h"
 #include <gmock/gmock.h>
+#include <chrono>
 
 namespace google {
 namespace cloud {
@@ -37,6 +38,38 @@ TEST(ClientOptionsTest, OptimizerVersion) {
   EXPECT_EQ(copy, default_constructed);
 }
 
+TEST(ClientOptionsTest, CacheReadTimestamps) {
+  ClientOptions const default_constructed{};
+  EXPECT_FALSE(default_constructed.cache_read_timestamps());
+
+  auto copy = default_constructed;
+  copy.set_cache_read_timestamps(true);
+  EXPECT_TRUE(copy.cache_read_timestamps());
+  EXPECT_NE(copy, default_constructed);
+
+  copy.set_cache_read_timestamps(false);
+  EXPECT_EQ(copy, default_constructed);
+}
+
+TEST(ClientOptionsTest, Timeouts) {
+  ClientOptions const default_constructed{};
+  EXPECT_EQ(0, default_constructed.operation_timeout().count());
+  EXPECT_EQ(0, default_constructed.attempt_timeout().count());
+
+  auto copy = default_constructed;
+  copy.set_operation_timeout(std::chrono::milliseconds(500));
+  EXPECT_EQ(std::chrono::milliseconds(500), copy.operation_timeout());
+  EXPECT_NE(copy, default_constructed);
+
+  copy.set_operation_timeout(std::chrono::milliseconds(0));
+  copy.set_attempt_timeout(std::chrono::milliseconds(100));
+  EXPECT_EQ(std::chrono::milliseconds(100), copy.attempt_timeout());
+  EXPECT_NE(copy, default_constructed);
+
+  copy.set_attempt_timeout(std::chrono::milliseconds(0));
+  EXPECT_EQ(copy, default_constructed);
+}
+
 }  // namespace
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner
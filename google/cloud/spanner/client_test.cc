@@ -29,6 +29,7 @@
 #include <array>
 #include <chrono>
 #include <cstdint>
+#include <thread>
 #include <utility>
 
 namespace google {
@@ -80,6 +81,21 @@ TEST(ClientTest, CopyAndMove) {
   EXPECT_EQ(c1, c2);
 }
 
+TEST(ClientTest, EqualityIgnoresDecorators) {
+  auto conn = std::make_shared<MockConnection>();
+  Client plain(conn);
+  Client cached(conn, ClientOptions().set_cache_read_timestamps(true));
+  Client timed(conn, ClientOptions().set_operation_timeout(
+                         std::chrono::milliseconds(100)));
+  EXPECT_EQ(plain, cached);
+  EXPECT_EQ(plain, timed);
+  EXPECT_EQ(cached, timed);
+
+  Client other(std::make_shared<MockConnection>(),
+               ClientOptions().set_cache_read_timestamps(true));
+  EXPECT_NE(cached, other);
+}
+
 TEST(ClientTest, ReadSuccess) {
   auto conn = std::make_shared<MockConnection>();
   Client client(conn);
@@ -168,6 +184,51 @@ TEST(ClientTest, ReadFailure) {
   EXPECT_EQ((*iter).status().code(), StatusCode::kDeadlineExceeded);
 }
 
+TEST(ClientTest, BatchRead) {
+  auto conn = std::make_shared<MockConnection>();
+  Client client(conn);
+
+  EXPECT_CALL(*conn, Read(_))
+      .Times(3)
+      .WillRepeatedly([](Connection::ReadParams const& params) {
+        auto source = make_unique<MockResultSetSource>();
+        if (params.table == "Singers") {
+          // The two requests for Singers are combined.
+          EXPECT_EQ(KeySet().AddKey(MakeKey(1)).AddKey(MakeKey(2)),
+                    params.keys);
+          EXPECT_CALL(*source, NextRow())
+              .WillOnce(Return(MakeTestRow(std::int64_t{1}, "Steve")))
+              .WillOnce(Return(MakeTestRow(std::int64_t{2}, "Ann")))
+              .WillOnce(Return(Row()));
+        } else if (params.table == "Albums") {
+          EXPECT_CALL(*source, NextRow())
+              .WillOnce(Return(MakeTestRow(std::int64_t{3}, "Go")))
+              .WillOnce(Return(Row()));
+        } else {
+          EXPECT_CALL(*source, NextRow())
+              .WillOnce(Return(Status(StatusCode::kNotFound, "no table")));
+        }
+        return RowStream(std::move(source));
+      });
+
+  auto const columns = std::vector<std::string>{"Id", "Name"};
+  auto results = client.BatchRead(
+      {ReadRequest{"Singers", KeySet().AddKey(MakeKey(1)), columns, {}},
+       ReadRequest{"Missing", KeySet::All(), columns, {}},
+       ReadRequest{"Singers", KeySet().AddKey(MakeKey(2)), columns, {}},
+       ReadRequest{"Albums", KeySet::All(), columns, {}}},
+      BatchReadOptions{}.set_combine_point_reads(true));
+  ASSERT_EQ(4, results.size());
+  ASSERT_STATUS_OK(results[0]);
+  EXPECT_THAT(*results[0],
+              ElementsAre(MakeTestRow(std::int64_t{1}, "Steve")));
+  EXPECT_EQ(StatusCode::kNotFound, results[1].status().code());
+  ASSERT_STATUS_OK(results[2]);
+  EXPECT_THAT(*results[2], ElementsAre(MakeTestRow(std::int64_t{2}, "Ann")));
+  ASSERT_STATUS_OK(results[3]);
+  EXPECT_THAT(*results[3], ElementsAre(MakeTestRow(std::int64_t{3}, "Go")));
+}
+
 TEST(ClientTest, ExecuteQuerySuccess) {
   auto conn = std::make_shared<MockConnection>();
   Client client(conn);
@@ -681,6 +742,81 @@ TEST(ClientTest, CommitMutatorPermanentFailure) {
   EXPECT_EQ(1, commit_attempts);  // no reruns
 }
 
+TEST(ClientTest, AsyncCommitReruns) {
+  auto timestamp = internal::TimestampFromRFC3339("2020-02-28T04:49:17.335Z");
+  ASSERT_STATUS_OK(timestamp);
+  int commit_attempts = 0;
+
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, Commit(_))
+      .WillRepeatedly([&commit_attempts, &timestamp](
+                          Connection::CommitParams const&)
+                          -> StatusOr<CommitResult> {
+        if (++commit_attempts < 3) {
+          return Status(StatusCode::kAborted, "Aborted transaction");
+        }
+        return CommitResult{*timestamp};
+      });
+
+  auto mutator = [](Transaction const&) -> StatusOr<Mutations> {
+    return Mutations{MakeDeleteMutation("table", KeySet::All())};
+  };
+
+  CompletionQueue cq;
+  std::thread t([&cq] { cq.Run(); });
+  Client client(conn);
+  auto result =
+      client
+          .AsyncCommit(cq, mutator,
+                       LimitedErrorCountTransactionRerunPolicy(5).clone(),
+                       ExponentialBackoffPolicy(std::chrono::microseconds(10),
+                                                std::chrono::microseconds(10),
+                                                2.0)
+                           .clone())
+          .get();
+  cq.Shutdown();
+  t.join();
+
+  EXPECT_STATUS_OK(result);
+  EXPECT_EQ(*timestamp, result->commit_timestamp);
+  EXPECT_EQ(3, commit_attempts);
+}
+
+TEST(ClientTest, AsyncCommitTooManyFailures) {
+  int commit_attempts = 0;
+  int const maximum_failures = 2;
+
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, Commit(_))
+      .WillRepeatedly([&commit_attempts](Connection::CommitParams const&) {
+        ++commit_attempts;
+        return Status(StatusCode::kAborted, "Aborted transaction");
+      });
+
+  auto mutator = [](Transaction const&) -> StatusOr<Mutations> {
+    return Mutations{MakeDeleteMutation("table", KeySet::All())};
+  };
+
+  CompletionQueue cq;
+  std::thread t([&cq] { cq.Run(); });
+  Client client(conn);
+  auto result =
+      client
+          .AsyncCommit(
+              cq, mutator,
+              LimitedErrorCountTransactionRerunPolicy(maximum_failures).clone(),
+              ExponentialBackoffPolicy(std::chrono::microseconds(10),
+                                       std::chrono::microseconds(10), 2.0)
+                  .clone())
+          .get();
+  cq.Shutdown();
+  t.join();
+
+  EXPECT_EQ(StatusCode::kAborted, result.status().code());
+  EXPECT_THAT(result.status().message(), HasSubstr("Aborted transaction"));
+  EXPECT_EQ(maximum_failures + 1, commit_attempts);  // one too many
+}
+
 TEST(ClientTest, CommitMutations) {
   auto conn = std::make_shared<MockConnection>();
   auto mutation = MakeDeleteMutation("table", KeySet::All());
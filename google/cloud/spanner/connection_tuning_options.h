@@ -0,0 +1,213 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_CONNECTION_TUNING_OPTIONS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_CONNECTION_TUNING_OPTIONS_H
+
+#include "google/cloud/spanner/retry_budget.h"
+#include "google/cloud/spanner/rpc_trace_buffer.h"
+#include "google/cloud/spanner/tracer.h"
+#include "google/cloud/spanner/version.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+/**
+ * Configures the optional Cloud Spanner features of a `Connection`.
+ *
+ * `ConnectionOptions` configures the gRPC channels and `SessionPoolOptions`
+ * the session pool. This class configures what the `Connection` does with
+ * them, e.g. how its operations and RPCs are traced, whether its slow reads
+ * are hedged, or how much it retries. Pass it to `MakeConnection()`.
+ * Every feature is disabled by default.
+ */
+class ConnectionTuningOptions {
+ public:
+  ConnectionTuningOptions() = default;
+  ConnectionTuningOptions(ConnectionTuningOptions const&) = default;
+  ConnectionTuningOptions& operator=(ConnectionTuningOptions const&) = default;
+  ConnectionTuningOptions(ConnectionTuningOptions&&) = default;
+  ConnectionTuningOptions& operator=(ConnectionTuningOptions&&) = default;
+
+  /// Returns the `Tracer` for the operations, `nullptr` if tracing is off.
+  std::shared_ptr<Tracer> const& tracer() const { return tracer_; }
+
+  /**
+   * Create spans for the operations of the `Connection` with @p tracer.
+   *
+   * The default, `nullptr`, disables tracing, and then the only cost of the
+   * instrumentation is a null check per operation.
+   */
+  ConnectionTuningOptions& set_tracer(std::shared_ptr<Tracer> tracer) {
+    tracer_ = std::move(tracer);
+    return *this;
+  }
+
+  /// Returns the buffer for the sampled RPC traces, `nullptr` if disabled.
+  std::shared_ptr<RpcTraceBuffer> const& rpc_trace_buffer() const {
+    return rpc_trace_buffer_;
+  }
+
+  /**
+   * Record a sample of the RPCs in @p buffer.
+   *
+   * Unlike the "rpc" tracing component of `ConnectionOptions`, which formats
+   * every request and response, only the calls selected by
+   * `rpc_sample_rate()` and `rpc_slow_threshold()` are formatted, so this is
+   * cheap enough to leave enabled in production. The selected calls are also
+   * logged at DEBUG level. Keep a copy of @p buffer to `Dump()` the records.
+   * The default, `nullptr`, disables the sampling.
+   */
+  ConnectionTuningOptions& set_rpc_trace_buffer(
+      std::shared_ptr<RpcTraceBuffer> buffer) {
+    rpc_trace_buffer_ = std::move(buffer);
+    return *this;
+  }
+
+  /// Returns N, where one in every N RPCs is recorded, 0 if none are.
+  std::int64_t rpc_sample_rate() const { return rpc_sample_rate_; }
+
+  /**
+   * Record one in every @p rate RPCs (counted per thread) in the
+   * `rpc_trace_buffer()`. Zero records none. The default is 1000.
+   */
+  ConnectionTuningOptions& set_rpc_sample_rate(std::int64_t rate) {
+    rpc_sample_rate_ = rate;
+    return *this;
+  }
+
+  /// Returns the latency of the RPCs always recorded, zero if disabled.
+  std::chrono::milliseconds rpc_slow_threshold() const {
+    return rpc_slow_threshold_;
+  }
+
+  /**
+   * Also record every RPC slower than @p threshold in the
+   * `rpc_trace_buffer()`. The default, zero, disables this.
+   */
+  ConnectionTuningOptions& set_rpc_slow_threshold(
+      std::chrono::milliseconds threshold) {
+    rpc_slow_threshold_ = threshold;
+    return *this;
+  }
+
+  /// Returns the percentile of the reads that are hedged, 0 if none are.
+  int hedge_percentile() const { return hedge_percentile_; }
+
+  /**
+   * Hedge the streaming reads and queries in single-use read-only
+   * transactions that are slower than @p percentile (1 to 99) of the recent
+   * calls.
+   *
+   * If the first response of such a call does not arrive within that
+   * percentile of the recent times to the first response, the same request is
+   * sent on another idle session, and the first call to respond wins. This
+   * trades some extra load for a shorter tail latency. The default, 0,
+   * disables hedging, and so does any value out of range.
+   */
+  ConnectionTuningOptions& set_hedge_percentile(int percentile) {
+    hedge_percentile_ = percentile < 0 || percentile > 99 ? 0 : percentile;
+    return *this;
+  }
+
+  /// Returns the minimum delay before a call is hedged.
+  std::chrono::milliseconds hedge_min_delay() const { return hedge_min_delay_; }
+
+  /**
+   * Never hedge a call before @p delay, even if most calls are faster. The
+   * default is 1ms.
+   */
+  ConnectionTuningOptions& set_hedge_min_delay(
+      std::chrono::milliseconds delay) {
+    hedge_min_delay_ = delay;
+    return *this;
+  }
+
+  /// Returns the retry budget of the `Connection`, `nullptr` if it has none.
+  std::shared_ptr<RetryBudget> const& retry_budget() const {
+    return retry_budget_;
+  }
+
+  /**
+   * Stop retrying the RPCs while @p budget is exhausted.
+   *
+   * The retry policy of each operation is still honored, the budget only
+   * refuses some of the retries it allows. Keep a copy of @p budget to read
+   * its `Snapshot()`. The default, `nullptr`, disables the retry budget.
+   */
+  ConnectionTuningOptions& set_retry_budget(
+      std::shared_ptr<RetryBudget> budget) {
+    retry_budget_ = std::move(budget);
+    return *this;
+  }
+
+  /// Returns true if unused read-write transactions commit in a single RPC.
+  bool single_use_commits() const { return single_use_commits_; }
+
+  /**
+   * Commit the read-write transactions that no read, query, or DML statement
+   * has used in a single RPC, without calling `BeginTransaction` first.
+   *
+   * This saves a round trip per commit, but Spanner may apply such a commit
+   * twice if it is resent after a transient error. Only enable it if applying
+   * the mutations twice is harmless, e.g. if they are all
+   * `InsertOrUpdateMutation`, `ReplaceMutation`, or `DeleteMutation` and no
+   * other client writes the same rows. An `InsertMutation` applied twice
+   * fails with `StatusCode::kAlreadyExists`. The default, `false`, begins the
+   * transaction and commits it by ID, which is safe to retry.
+   */
+  ConnectionTuningOptions& set_single_use_commits(bool enabled) {
+    single_use_commits_ = enabled;
+    return *this;
+  }
+
+  friend bool operator==(ConnectionTuningOptions const& a,
+                         ConnectionTuningOptions const& b) {
+    return a.tracer_ == b.tracer_ &&
+           a.rpc_trace_buffer_ == b.rpc_trace_buffer_ &&
+           a.rpc_sample_rate_ == b.rpc_sample_rate_ &&
+           a.rpc_slow_threshold_ == b.rpc_slow_threshold_ &&
+           a.hedge_percentile_ == b.hedge_percentile_ &&
+           a.hedge_min_delay_ == b.hedge_min_delay_ &&
+           a.retry_budget_ == b.retry_budget_ &&
+           a.single_use_commits_ == b.single_use_commits_;
+  }
+
+  friend bool operator!=(ConnectionTuningOptions const& a,
+                         ConnectionTuningOptions const& b) {
+    return !(a == b);
+  }
+
+ private:
+  std::shared_ptr<Tracer> tracer_;
+  std::shared_ptr<RpcTraceBuffer> rpc_trace_buffer_;
+  std::int64_t rpc_sample_rate_ = 1000;
+  std::chrono::milliseconds rpc_slow_threshold_{0};
+  int hedge_percentile_ = 0;
+  std::chrono::milliseconds hedge_min_delay_{1};
+  std::shared_ptr<RetryBudget> retry_budget_;
+  bool single_use_commits_ = false;
+};
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_CONNECTION_TUNING_OPTIONS_H
@@ -0,0 +1,122 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/connection_tuning_options.h"
+#include "google/cloud/spanner/testing/in_memory_tracer.h"
+#include <gmock/gmock.h>
+#include <chrono>
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+TEST(ConnectionTuningOptionsTest, Tracer) {
+  ConnectionTuningOptions const default_constructed{};
+  EXPECT_EQ(nullptr, default_constructed.tracer());
+
+  auto copy = default_constructed;
+  EXPECT_EQ(copy, default_constructed);
+
+  auto tracer = std::make_shared<spanner_testing::InMemoryTracer>();
+  copy.set_tracer(tracer);
+  EXPECT_EQ(tracer, copy.tracer());
+  EXPECT_NE(copy, default_constructed);
+
+  copy.set_tracer(nullptr);
+  EXPECT_EQ(copy, default_constructed);
+}
+
+TEST(ConnectionTuningOptionsTest, RpcSampling) {
+  ConnectionTuningOptions const default_constructed{};
+  EXPECT_EQ(nullptr, default_constructed.rpc_trace_buffer());
+  EXPECT_EQ(1000, default_constructed.rpc_sample_rate());
+  EXPECT_EQ(0, default_constructed.rpc_slow_threshold().count());
+
+  auto copy = default_constructed;
+  auto buffer = std::make_shared<RpcTraceBuffer>(16);
+  copy.set_rpc_trace_buffer(buffer);
+  EXPECT_EQ(buffer, copy.rpc_trace_buffer());
+  EXPECT_NE(copy, default_constructed);
+  copy.set_rpc_trace_buffer(nullptr);
+  EXPECT_EQ(copy, default_constructed);
+
+  copy.set_rpc_sample_rate(10);
+  EXPECT_EQ(10, copy.rpc_sample_rate());
+  EXPECT_NE(copy, default_constructed);
+  copy.set_rpc_sample_rate(1000);
+  EXPECT_EQ(copy, default_constructed);
+
+  copy.set_rpc_slow_threshold(std::chrono::milliseconds(250));
+  EXPECT_EQ(std::chrono::milliseconds(250), copy.rpc_slow_threshold());
+  EXPECT_NE(copy, default_constructed);
+  copy.set_rpc_slow_threshold(std::chrono::milliseconds(0));
+  EXPECT_EQ(copy, default_constructed);
+}
+
+TEST(ConnectionTuningOptionsTest, Hedging) {
+  ConnectionTuningOptions const default_constructed{};
+  EXPECT_EQ(0, default_constructed.hedge_percentile());
+  EXPECT_EQ(std::chrono::milliseconds(1),
+            default_constructed.hedge_min_delay());
+
+  auto copy = default_constructed;
+  copy.set_hedge_percentile(95);
+  EXPECT_EQ(95, copy.hedge_percentile());
+  EXPECT_NE(copy, default_constructed);
+  copy.set_hedge_percentile(100);
+  EXPECT_EQ(0, copy.hedge_percentile());
+  EXPECT_EQ(copy, default_constructed);
+
+  copy.set_hedge_min_delay(std::chrono::milliseconds(20));
+  EXPECT_EQ(std::chrono::milliseconds(20), copy.hedge_min_delay());
+  EXPECT_NE(copy, default_constructed);
+  copy.set_hedge_min_delay(std::chrono::milliseconds(1));
+  EXPECT_EQ(copy, default_constructed);
+}
+
+TEST(ConnectionTuningOptionsTest, RetryBudget) {
+  ConnectionTuningOptions const default_constructed{};
+  EXPECT_EQ(nullptr, default_constructed.retry_budget());
+
+  auto copy = default_constructed;
+  auto budget = std::make_shared<RetryBudget>(100, 0.1);
+  copy.set_retry_budget(budget);
+  EXPECT_EQ(budget, copy.retry_budget());
+  EXPECT_NE(copy, default_constructed);
+
+  copy.set_retry_budget(nullptr);
+  EXPECT_EQ(copy, default_constructed);
+}
+
+TEST(ConnectionTuningOptionsTest, SingleUseCommits) {
+  ConnectionTuningOptions const default_constructed{};
+  EXPECT_FALSE(default_constructed.single_use_commits());
+
+  auto copy = default_constructed;
+  copy.set_single_use_commits(true);
+  EXPECT_TRUE(copy.single_use_commits());
+  EXPECT_NE(copy, default_constructed);
+
+  copy.set_single_use_commits(false);
+  EXPECT_EQ(copy, default_constructed);
+}
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
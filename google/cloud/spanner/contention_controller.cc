@@ -0,0 +1,181 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/contention_controller.h"
+#include "google/cloud/spanner/backoff_policy.h"
+#include <algorithm>
+#include <random>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+namespace {
+// How much each attempt moves the exponentially weighted abort rate.
+auto constexpr kAbortRateWeight = 0.1;
+// The fraction of the concurrency limit kept after an abort.
+auto constexpr kAbortDecrease = 0.7;
+}  // namespace
+
+struct ContentionController::HintState {
+  double limit;
+  int in_flight = 0;
+  double abort_rate = 0;
+  std::condition_variable cv;
+};
+
+// One call to `Commit()`. It holds a slot from the start of each attempt
+// until the attempt fails, or until the final attempt completes.
+struct ContentionController::Attempt {
+  explicit Attempt(HintState& s) : state(&s) {}
+
+  HintState* state;
+  bool holding = false;
+  int reruns = 0;
+};
+
+// `Client::Commit()` asks its backoff policy for a delay only after an
+// attempt fails with a rerunnable error, so that is where the failed attempt
+// gives up its slot. Reruns after a lost session are rare enough that they
+// are also counted as aborts.
+class ContentionController::RerunBackoff : public BackoffPolicy {
+ public:
+  RerunBackoff(ContentionController* controller, Attempt* attempt)
+      : controller_(controller), attempt_(attempt) {}
+
+  std::unique_ptr<BackoffPolicy> clone() const override {
+    return std::unique_ptr<BackoffPolicy>(new RerunBackoff(*this));
+  }
+
+  std::chrono::milliseconds OnCompletion() override {
+    controller_->Release(*attempt_, /*aborted=*/true);
+    return controller_->Backoff(attempt_->reruns++);
+  }
+
+ private:
+  ContentionController* controller_;
+  Attempt* attempt_;
+};
+
+ContentionController::ContentionController(ContentionControllerOptions options)
+    : options_(std::move(options)),
+      generator_(google::cloud::internal::MakeDefaultPRNG()) {}
+
+ContentionController::~ContentionController() = default;
+
+StatusOr<CommitResult> ContentionController::Commit(
+    Client client, std::string const& hint,
+    std::function<StatusOr<Mutations>(Transaction)> const& mutator,
+    std::unique_ptr<TransactionRerunPolicy> rerun_policy) {
+  Attempt attempt(GetHintState(hint));
+  auto admitted = [this, &attempt, &mutator](Transaction txn) {
+    Acquire(attempt);
+    return mutator(std::move(txn));
+  };
+  StatusOr<CommitResult> result;
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+  try {
+#endif
+    result = client.Commit(
+        admitted, std::move(rerun_policy),
+        std::unique_ptr<BackoffPolicy>(new RerunBackoff(this, &attempt)));
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+  } catch (...) {
+    Release(attempt, /*aborted=*/false);
+    throw;
+  }
+#endif
+  Release(attempt, result.status().code() == StatusCode::kAborted);
+  return result;
+}
+
+StatusOr<CommitResult> ContentionController::Commit(
+    Client client, std::string const& hint,
+    std::function<StatusOr<Mutations>(Transaction)> const& mutator) {
+  // The same limit as the default policy of `Client::Commit()`.
+  return Commit(
+      std::move(client), hint, mutator,
+      LimitedTimeTransactionRerunPolicy(std::chrono::minutes(10)).clone());
+}
+
+ContentionStats ContentionController::Stats(std::string const& hint) {
+  auto& state = GetHintState(hint);
+  std::lock_guard<std::mutex> lk(mu_);
+  ContentionStats stats;
+  stats.abort_rate = state.abort_rate;
+  stats.concurrency_limit = static_cast<int>(state.limit);
+  stats.in_flight = state.in_flight;
+  return stats;
+}
+
+ContentionController::HintState& ContentionController::GetHintState(
+    std::string const& hint) {
+  std::lock_guard<std::mutex> lk(mu_);
+  auto& state = hints_[hint];
+  if (!state) {
+    state.reset(new HintState);
+    state->limit = (std::max)(options_.maximum_concurrency(), 1);
+  }
+  return *state;
+}
+
+void ContentionController::Acquire(Attempt& attempt) {
+  auto& state = *attempt.state;
+  std::unique_lock<std::mutex> lk(mu_);
+  state.cv.wait(lk, [&state] {
+    return state.in_flight < (std::max)(static_cast<int>(state.limit), 1);
+  });
+  ++state.in_flight;
+  attempt.holding = true;
+}
+
+void ContentionController::Release(Attempt& attempt, bool aborted) {
+  auto& state = *attempt.state;
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    if (!attempt.holding) return;
+    attempt.holding = false;
+    --state.in_flight;
+    auto const sample = aborted ? 1.0 : 0.0;
+    state.abort_rate += kAbortRateWeight * (sample - state.abort_rate);
+    if (aborted) {
+      state.limit = (std::max)(state.limit * kAbortDecrease, 1.0);
+    } else {
+      // Additive increase: about one more slot after `limit` good attempts.
+      auto const maximum = (std::max)(options_.maximum_concurrency(), 1);
+      state.limit = (std::min)(state.limit + 1 / state.limit,
+                               static_cast<double>(maximum));
+    }
+  }
+  state.cv.notify_all();
+}
+
+std::chrono::milliseconds ContentionController::Backoff(int rerun) {
+  auto bound = options_.initial_backoff();
+  for (int i = 0; i != rerun && bound < options_.maximum_backoff(); ++i) {
+    bound *= 2;
+  }
+  bound = (std::min)(bound, options_.maximum_backoff());
+  std::uniform_int_distribution<std::chrono::milliseconds::rep> delay(
+      0, bound.count());
+  std::lock_guard<std::mutex> lk(mu_);
+  return std::chrono::milliseconds(delay(generator_));
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
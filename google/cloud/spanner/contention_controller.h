@@ -0,0 +1,176 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_CONTENTION_CONTROLLER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_CONTENTION_CONTROLLER_H
+
+#include "google/cloud/spanner/client.h"
+#include "google/cloud/spanner/commit_result.h"
+#include "google/cloud/spanner/mutations.h"
+#include "google/cloud/spanner/retry_policy.h"
+#include "google/cloud/spanner/transaction.h"
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/internal/random.h"
+#include "google/cloud/status_or.h"
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+/**
+ * Controls how a `ContentionController` limits and delays transaction reruns.
+ */
+class ContentionControllerOptions {
+ public:
+  /**
+   * Set the upper bound of the first rerun's randomized backoff. The bound
+   * doubles for each further rerun of the same transaction.
+   */
+  ContentionControllerOptions& set_initial_backoff(
+      std::chrono::milliseconds backoff) {
+    initial_backoff_ = backoff;
+    return *this;
+  }
+
+  /// Return the upper bound of the first rerun's backoff.
+  std::chrono::milliseconds initial_backoff() const { return initial_backoff_; }
+
+  /// Set the largest backoff between two reruns.
+  ContentionControllerOptions& set_maximum_backoff(
+      std::chrono::milliseconds backoff) {
+    maximum_backoff_ = backoff;
+    return *this;
+  }
+
+  /// Return the largest backoff between two reruns.
+  std::chrono::milliseconds maximum_backoff() const { return maximum_backoff_; }
+
+  /**
+   * Set the number of transactions with the same hint that may run at once
+   * when they are not aborting. Values <= 1 are treated as 1.
+   */
+  ContentionControllerOptions& set_maximum_concurrency(int count) {
+    maximum_concurrency_ = count;
+    return *this;
+  }
+
+  /// Return the number of transactions with the same hint that may run at once.
+  int maximum_concurrency() const { return maximum_concurrency_; }
+
+ private:
+  std::chrono::milliseconds initial_backoff_ = std::chrono::milliseconds(10);
+  std::chrono::milliseconds maximum_backoff_ = std::chrono::seconds(32);
+  int maximum_concurrency_ = 64;
+};
+
+/// A snapshot of the state a `ContentionController` keeps for one hint.
+struct ContentionStats {
+  /// Exponentially weighted fraction of recent attempts that were aborted.
+  double abort_rate = 0;
+
+  /// The number of transactions with this hint allowed to run at once.
+  int concurrency_limit = 0;
+
+  /// The number of transactions with this hint running now.
+  int in_flight = 0;
+};
+
+/**
+ * Limits how many contending read-write transactions run at once.
+ *
+ * When many threads update the same rows, their transactions abort each
+ * other. If every thread then reruns after its own exponential backoff, the
+ * threads keep colliding and few transactions commit. A `ContentionController`
+ * is shared by all the threads (typically one per process), and tracks the
+ * abort rate of the transactions that share a *hint*, such as a table name or
+ * a hot key. It reacts to aborts as follows:
+ *
+ * - The number of transactions with the same hint that may run at once is
+ *   cut by 30% on each abort, down to one, and grows back by about one for
+ *   every `limit` attempts that are not aborted.
+ * - Reruns wait for a random delay, uniformly distributed between zero and an
+ *   exponentially growing bound, so that the threads aborted by the same
+ *   conflict do not retry in lockstep.
+ *
+ * @par Example
+ * @code
+ * auto controller = std::make_shared<spanner::ContentionController>();
+ * // ... in each thread ...
+ * auto result = controller->Commit(
+ *     client, "Accounts", [&](spanner::Transaction txn) {
+ *       return TransferFunds(client, txn, from, to, amount);
+ *     });
+ * @endcode
+ */
+class ContentionController {
+ public:
+  explicit ContentionController(ContentionControllerOptions options = {});
+  ~ContentionController();
+
+  // The transactions wait on condition variables owned by this object.
+  ContentionController(ContentionController const&) = delete;
+  ContentionController& operator=(ContentionController const&) = delete;
+
+  /**
+   * Runs @p mutator and commits its mutations, like `Client::Commit()`, while
+   * limiting the concurrency and spacing the reruns of the transactions that
+   * share @p hint.
+   *
+   * Each attempt first waits until fewer than the current limit of
+   * transactions with @p hint are running.
+   */
+  StatusOr<CommitResult> Commit(
+      Client client, std::string const& hint,
+      std::function<StatusOr<Mutations>(Transaction)> const& mutator,
+      std::unique_ptr<TransactionRerunPolicy> rerun_policy);
+
+  /// Same as above, with the default rerun policy of `Client::Commit()`.
+  StatusOr<CommitResult> Commit(
+      Client client, std::string const& hint,
+      std::function<StatusOr<Mutations>(Transaction)> const& mutator);
+
+  /// Returns the current state for @p hint.
+  ContentionStats Stats(std::string const& hint);
+
+ private:
+  struct HintState;
+  struct Attempt;
+  class RerunBackoff;
+
+  HintState& GetHintState(std::string const& hint);
+  void Acquire(Attempt& attempt);
+  void Release(Attempt& attempt, bool aborted);
+  std::chrono::milliseconds Backoff(int rerun);
+
+  ContentionControllerOptions options_;
+  std::mutex mu_;
+  std::unordered_map<std::string, std::unique_ptr<HintState>>
+      hints_;                                        // GUARDED_BY(mu_)
+  google::cloud::internal::DefaultPRNG generator_;  // GUARDED_BY(mu_)
+};
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_CONTENTION_CONTROLLER_H
@@ -0,0 +1,205 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/contention_controller.h"
+#include "google/cloud/spanner/mocks/mock_spanner_connection.h"
+#include "google/cloud/spanner/mutations.h"
+#include "google/cloud/spanner/timestamp.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <gmock/gmock.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+using ::google::cloud::spanner_mocks::MockConnection;
+using ::testing::_;
+
+CommitResult MakeCommitResult() {
+  return CommitResult{
+      MakeTimestamp(std::chrono::system_clock::from_time_t(1)).value()};
+}
+
+StatusOr<Mutations> DeleteAll(Transaction const&) {
+  return Mutations{MakeDeleteMutation("table", KeySet::All())};
+}
+
+ContentionControllerOptions FastOptions(int maximum_concurrency) {
+  return ContentionControllerOptions{}
+      .set_initial_backoff(std::chrono::milliseconds(1))
+      .set_maximum_backoff(std::chrono::milliseconds(2))
+      .set_maximum_concurrency(maximum_concurrency);
+}
+
+TEST(ContentionController, RerunsAbortedTransactions) {
+  auto conn = std::make_shared<MockConnection>();
+  int commit_attempts = 0;
+  EXPECT_CALL(*conn, Commit(_))
+      .WillRepeatedly([&commit_attempts](Connection::CommitParams const&) {
+        if (++commit_attempts < 3) {
+          return StatusOr<CommitResult>(
+              Status(StatusCode::kAborted, "Aborted transaction"));
+        }
+        return StatusOr<CommitResult>(MakeCommitResult());
+      });
+
+  ContentionController controller(FastOptions(8));
+  auto result = controller.Commit(Client(conn), "table", DeleteAll);
+  EXPECT_STATUS_OK(result);
+  EXPECT_EQ(3, commit_attempts);
+
+  // Two aborts shrink the limit (8 -> 5.6 -> 3.92), and the success grows it
+  // a little (3.92 + 1 / 3.92).
+  auto stats = controller.Stats("table");
+  EXPECT_EQ(0, stats.in_flight);
+  EXPECT_EQ(4, stats.concurrency_limit);
+  EXPECT_GT(stats.abort_rate, 0);
+
+  // Other hints are not affected.
+  auto other = controller.Stats("other-table");
+  EXPECT_EQ(8, other.concurrency_limit);
+  EXPECT_EQ(0, other.abort_rate);
+}
+
+TEST(ContentionController, ReportsFinalError) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, Commit(_))
+      .WillRepeatedly([](Connection::CommitParams const&) {
+        return Status(StatusCode::kAborted, "Aborted transaction");
+      });
+
+  ContentionController controller(FastOptions(8));
+  auto result =
+      controller.Commit(Client(conn), "table", DeleteAll,
+                        LimitedErrorCountTransactionRerunPolicy(2).clone());
+  EXPECT_EQ(StatusCode::kAborted, result.status().code());
+  auto stats = controller.Stats("table");
+  EXPECT_EQ(0, stats.in_flight);
+  EXPECT_EQ(2, stats.concurrency_limit);  // 8 * 0.7^3 rounds down to 2
+}
+
+TEST(ContentionController, LimitsConcurrency) {
+  auto conn = std::make_shared<MockConnection>();
+  std::atomic<int> in_flight(0);
+  std::atomic<int> max_in_flight(0);
+  EXPECT_CALL(*conn, Commit(_))
+      .WillRepeatedly([&](Connection::CommitParams const&) {
+        auto const current = ++in_flight;
+        auto observed = max_in_flight.load();
+        while (current > observed &&
+               !max_in_flight.compare_exchange_weak(observed, current)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        --in_flight;
+        return MakeCommitResult();
+      });
+
+  ContentionController controller(FastOptions(2));
+  std::vector<std::thread> threads;
+  for (int i = 0; i != 8; ++i) {
+    threads.emplace_back([&controller, &conn] {
+      for (int j = 0; j != 10; ++j) {
+        EXPECT_STATUS_OK(controller.Commit(Client(conn), "table", DeleteAll));
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  EXPECT_LE(max_in_flight.load(), 2);
+  EXPECT_EQ(0, controller.Stats("table").in_flight);
+}
+
+TEST(ContentionController, SerializedHotRowNeverAborts) {
+  // A single row with optimistic concurrency control: a commit is aborted if
+  // the row changed after the transaction read it.
+  std::mutex mu;
+  std::int64_t version = 0;
+  int abort_count = 0;
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, Commit(_))
+      .WillRepeatedly([&](Connection::CommitParams const& p)
+                          -> StatusOr<CommitResult> {
+        auto const proto = p.mutations.at(0).as_proto();
+        auto const read_version = std::stoll(
+            proto.insert_or_update().values(0).values(1).string_value());
+        std::lock_guard<std::mutex> lk(mu);
+        if (read_version != version) {
+          ++abort_count;
+          return Status(StatusCode::kAborted, "Aborted transaction");
+        }
+        ++version;
+        return MakeCommitResult();
+      });
+  auto read_modify_write = [&](Transaction const&) -> StatusOr<Mutations> {
+    std::int64_t read_version;
+    {
+      std::lock_guard<std::mutex> lk(mu);
+      read_version = version;
+    }
+    // Give the other threads a chance to read the same version.
+    std::this_thread::yield();
+    return Mutations{MakeInsertOrUpdateMutation(
+        "table", {"Key", "Version"}, std::int64_t{0}, read_version)};
+  };
+
+  // A transaction holds its slot from the read until the commit, so with a
+  // limit of one no two transactions can see the same version.
+  ContentionController controller(FastOptions(1));
+  std::vector<std::thread> threads;
+  for (int i = 0; i != 4; ++i) {
+    threads.emplace_back([&controller, &conn, &read_modify_write] {
+      for (int j = 0; j != 25; ++j) {
+        EXPECT_STATUS_OK(
+            controller.Commit(Client(conn), "table", read_modify_write));
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  EXPECT_EQ(100, version);
+  EXPECT_EQ(0, abort_count);
+  EXPECT_EQ(0, controller.Stats("table").abort_rate);
+}
+
+TEST(ContentionController, ReleasesOnPermanentFailure) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, Commit(_)).Times(0);
+  EXPECT_CALL(*conn, Rollback(_))
+      .WillRepeatedly(
+          [](Connection::RollbackParams const&) { return Status(); });
+
+  ContentionController controller(FastOptions(1));
+  for (int i = 0; i != 2; ++i) {
+    auto result = controller.Commit(
+        Client(conn), "table", [](Transaction const&) -> StatusOr<Mutations> {
+          return Status(StatusCode::kPermissionDenied, "uh-oh");
+        });
+    EXPECT_EQ(StatusCode::kPermissionDenied, result.status().code());
+  }
+  EXPECT_EQ(0, controller.Stats("table").in_flight);
+}
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,87 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_FAN_OUT_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_FAN_OUT_H
+
+#include "google/cloud/spanner/version.h"
+#include <functional>
+#include <future>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+/**
+ * Runs each of @p operations on its own thread, and returns their results in
+ * the same order.
+ *
+ * This is intended for the independent reads and queries of a single
+ * transaction, which would otherwise take one round trip each. If the
+ * transaction has not begun, one of the operations begins it while the others
+ * wait, and then the rest run concurrently. A `Transaction` is safe to share
+ * between threads, but the operations must not depend on each other's
+ * results. Operations that return a `RowStream` should consume it before they
+ * return.
+ *
+ * @warning Do not use this to run the DML statements of a read-write
+ *     transaction. Each statement carries a sequence number, and Spanner may
+ *     abort the transaction if a statement arrives after one with a higher
+ *     sequence number, so the DML statements of a transaction must run
+ *     sequentially.
+ *
+ * If an operation throws, the exception is rethrown after all the operations
+ * have completed.
+ *
+ * @par Example
+ * @code
+ * auto txn = spanner::MakeReadOnlyTransaction();
+ * auto count_rows = [&](spanner::SqlStatement statement) {
+ *   return [&client, &txn, statement] {
+ *     std::int64_t count = 0;
+ *     for (auto const& row : client.ExecuteQuery(txn, statement)) {
+ *       if (!row) return StatusOr<std::int64_t>(row.status());
+ *       ++count;
+ *     }
+ *     return StatusOr<std::int64_t>(count);
+ *   };
+ * };
+ * auto counts = spanner::FanOut<StatusOr<std::int64_t>>({
+ *     count_rows(spanner::SqlStatement("SELECT * FROM Albums")),
+ *     count_rows(spanner::SqlStatement("SELECT * FROM Singers")),
+ * });
+ * @endcode
+ */
+template <typename T>
+std::vector<T> FanOut(std::vector<std::function<T()>> const& operations) {
+  std::vector<std::future<T>> futures;
+  futures.reserve(operations.size());
+  for (auto const& op : operations) {
+    futures.push_back(std::async(std::launch::async, op));
+  }
+  for (auto& f : futures) f.wait();
+  std::vector<T> results;
+  results.reserve(futures.size());
+  for (auto& f : futures) results.push_back(f.get());
+  return results;
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_FAN_OUT_H
@@ -0,0 +1,116 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/fan_out.h"
+#include "google/cloud/spanner/client.h"
+#include "google/cloud/spanner/mocks/mock_spanner_connection.h"
+#include "google/cloud/spanner/results.h"
+#include "google/cloud/spanner/row.h"
+#include "google/cloud/spanner/transaction.h"
+#include "google/cloud/internal/make_unique.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <gmock/gmock.h>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+using ::google::cloud::internal::make_unique;
+using ::google::cloud::spanner_mocks::MockConnection;
+using ::google::cloud::spanner_mocks::MockResultSetSource;
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::Return;
+
+TEST(FanOut, Empty) {
+  auto results = FanOut<int>({});
+  EXPECT_TRUE(results.empty());
+}
+
+TEST(FanOut, RunsConcurrently) {
+  // Each operation waits until all of them have started, so this only
+  // completes if they run concurrently.
+  std::mutex mu;
+  std::condition_variable cv;
+  int started = 0;
+  auto op = [&](int value) {
+    return [&, value] {
+      std::unique_lock<std::mutex> lk(mu);
+      if (++started == 3) cv.notify_all();
+      cv.wait(lk, [&] { return started == 3; });
+      return value;
+    };
+  };
+  auto results = FanOut<int>({op(1), op(2), op(3)});
+  EXPECT_THAT(results, ElementsAre(1, 2, 3));
+}
+
+TEST(FanOut, ExecuteQuery) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, ExecuteQuery(_))
+      .Times(2)
+      .WillRepeatedly([](Connection::SqlParams const& p) {
+        EXPECT_THAT(p.statement.sql(), ::testing::StartsWith("SELECT"));
+        auto source = make_unique<MockResultSetSource>();
+        EXPECT_CALL(*source, NextRow())
+            .WillOnce(Return(MakeTestRow(1)))
+            .WillOnce(Return(MakeTestRow(2)))
+            .WillOnce(Return(Row()));
+        return RowStream(std::move(source));
+      });
+
+  Client client(conn);
+  auto txn = MakeReadOnlyTransaction();
+  auto count_rows = [&](std::string sql) {
+    return [&client, &txn, sql] {
+      int count = 0;
+      for (auto const& row : client.ExecuteQuery(txn, SqlStatement(sql))) {
+        EXPECT_STATUS_OK(row);
+        ++count;
+      }
+      return count;
+    };
+  };
+  auto results = FanOut<int>({
+      count_rows("SELECT * FROM Albums"),
+      count_rows("SELECT * FROM Singers"),
+  });
+  EXPECT_THAT(results, ElementsAre(2, 2));
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+TEST(FanOut, RethrowsExceptions) {
+  int completed = 0;
+  std::mutex mu;
+  auto ok = [&] {
+    std::lock_guard<std::mutex> lk(mu);
+    return ++completed;
+  };
+  auto fail = []() -> int { throw std::runtime_error("uh-oh"); };
+  EXPECT_THROW(FanOut<int>({ok, fail, ok}), std::runtime_error);
+  EXPECT_EQ(2, completed);
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
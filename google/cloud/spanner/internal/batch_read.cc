@@ -0,0 +1,146 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/batch_read.h"
+#include "google/cloud/spanner/value.h"
+#include <google/protobuf/struct.pb.h>
+#include <algorithm>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+namespace {
+
+// Returns the number of parts in the keys of @p keys, if it holds only point
+// keys of the same size, or 0 otherwise.
+std::size_t PointKeySize(google::spanner::v1::KeySet const& keys) {
+  if (keys.all() || keys.ranges_size() != 0 || keys.keys_size() == 0) return 0;
+  auto const size = keys.keys(0).values_size();
+  for (auto const& key : keys.keys()) {
+    if (key.values_size() != size) return 0;
+  }
+  return static_cast<std::size_t>(size);
+}
+
+// Requests with the same name can share a read.
+std::string CombinedReadName(ReadRequest const& request, std::size_t key_size) {
+  std::string name = request.table;
+  name += '\0';
+  name += request.read_options.index_name;
+  for (auto const& column : request.columns) {
+    name += '\0';
+    name += column;
+  }
+  name += '\0';
+  name += std::to_string(key_size);
+  return name;
+}
+
+}  // namespace
+
+std::vector<BatchReadGroup> GroupReadRequests(std::vector<ReadRequest> requests,
+                                              bool combine_point_reads) {
+  std::vector<BatchReadGroup> groups;
+  // The combined keys of each group, only used for combined reads.
+  std::vector<google::spanner::v1::KeySet> group_keys;
+  std::unordered_map<std::string, std::size_t> combined;
+  for (std::size_t i = 0; i != requests.size(); ++i) {
+    auto& request = requests[i];
+    auto keys = ToProto(request.keys);
+    auto const key_size = combine_point_reads && request.read_options.limit == 0
+                              ? PointKeySize(keys)
+                              : 0;
+    if (key_size == 0) {
+      groups.push_back(BatchReadGroup{std::move(request), {i}, 0, {}});
+      group_keys.emplace_back();
+      continue;
+    }
+    auto const inserted =
+        combined.emplace(CombinedReadName(request, key_size), groups.size());
+    if (inserted.second) {
+      groups.push_back(BatchReadGroup{
+          ReadRequest{request.table, KeySet(), request.columns,
+                      request.read_options},
+          {},
+          key_size,
+          {}});
+      group_keys.emplace_back();
+    }
+    auto const g = inserted.first->second;
+    auto& group = groups[g];
+    group.members.push_back(i);
+    for (auto& key : *keys.mutable_keys()) {
+      auto name = key.SerializeAsString();
+      auto const range = group.key_members.equal_range(name);
+      auto const member =
+          std::find_if(range.first, range.second,
+                       [i](std::pair<std::string const, std::size_t> const& m) {
+                         return m.second == i;
+                       });
+      if (member != range.second) continue;  // repeated in this request
+      if (range.first == range.second) *group_keys[g].add_keys() = key;
+      group.key_members.emplace(std::move(name), i);
+    }
+  }
+
+  for (std::size_t g = 0; g != groups.size(); ++g) {
+    auto& group = groups[g];
+    if (group.key_size == 0) continue;
+    if (group.members.size() == 1) {
+      // Nothing to share, read exactly what was requested.
+      group.request = std::move(requests[group.members.front()]);
+      group.key_size = 0;
+      group.key_members.clear();
+      continue;
+    }
+    group.request.keys = FromProto(std::move(group_keys[g]));
+  }
+  return groups;
+}
+
+void DistributeReadResult(BatchReadGroup const& group,
+                          StatusOr<std::vector<Row>> rows,
+                          std::vector<StatusOr<std::vector<Row>>>& results) {
+  if (!rows) {
+    for (auto i : group.members) results[i] = rows.status();
+    return;
+  }
+  if (group.key_size == 0) {
+    results[group.members.front()] = std::move(rows);
+    return;
+  }
+  for (auto i : group.members) results[i] = std::vector<Row>{};
+  for (auto& row : *rows) {
+    auto const& values = row.values();
+    if (values.size() < group.key_size) continue;
+    google::protobuf::ListValue key;
+    for (std::size_t i = 0; i != group.key_size; ++i) {
+      *key.add_values() = ToProtoValue(values[i]);
+    }
+    auto const range = group.key_members.equal_range(key.SerializeAsString());
+    for (auto m = range.first; m != range.second; ++m) {
+      results[m->second]->push_back(row);
+    }
+  }
+}
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,72 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_BATCH_READ_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_BATCH_READ_H
+
+#include "google/cloud/spanner/batch_read_options.h"
+#include "google/cloud/spanner/row.h"
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/status_or.h"
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+/// One read issued by `Client::BatchRead()`, on behalf of one or more requests.
+struct BatchReadGroup {
+  ReadRequest request;
+
+  /// The indexes of the requests this read answers.
+  std::vector<std::size_t> members;
+
+  /// For combined reads, the number of leading columns that hold the key.
+  std::size_t key_size;
+
+  /// For combined reads, maps each (serialized) key to its requests.
+  std::unordered_multimap<std::string, std::size_t> key_members;
+};
+
+/**
+ * Splits @p requests into the reads needed to answer them.
+ *
+ * If @p combine_point_reads is true, the requests that read the same columns
+ * of the same table, by point keys of the same size, share one read.
+ */
+std::vector<BatchReadGroup> GroupReadRequests(std::vector<ReadRequest> requests,
+                                              bool combine_point_reads);
+
+/**
+ * Stores the result of reading @p group into the `results` of its members.
+ *
+ * For combined reads each row is given to the requests that asked for its
+ * key. A failed read fails all its members.
+ */
+void DistributeReadResult(BatchReadGroup const& group,
+                          StatusOr<std::vector<Row>> rows,
+                          std::vector<StatusOr<std::vector<Row>>>& results);
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_BATCH_READ_H
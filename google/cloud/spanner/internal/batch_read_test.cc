@@ -0,0 +1,116 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/batch_read.h"
+#include "google/cloud/spanner/keys.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <gmock/gmock.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::testing::ElementsAre;
+
+ReadRequest PointRead(std::string table, std::vector<std::string> columns,
+                      std::vector<std::int64_t> const& keys) {
+  KeySet key_set;
+  for (auto k : keys) key_set.AddKey(MakeKey(k));
+  return ReadRequest{std::move(table), std::move(key_set), std::move(columns),
+                     ReadOptions{}};
+}
+
+std::vector<ReadRequest> MakeRequests() {
+  return {
+      PointRead("Singers", {"SingerId", "Name"}, {1, 2}),
+      PointRead("Singers", {"SingerId", "Name"}, {2, 3, 3}),
+      PointRead("Singers", {"Name"}, {1}),
+      ReadRequest{"Singers", KeySet::All(), {"SingerId", "Name"}, {}},
+      PointRead("Albums", {"SingerId", "Name"}, {1}),
+  };
+}
+
+TEST(BatchReadTest, NotCombinedByDefault) {
+  auto const requests = MakeRequests();
+  auto groups = GroupReadRequests(requests, false);
+  ASSERT_EQ(requests.size(), groups.size());
+  for (std::size_t i = 0; i != groups.size(); ++i) {
+    EXPECT_THAT(groups[i].members, ElementsAre(i));
+    EXPECT_EQ(0, groups[i].key_size);
+    EXPECT_EQ(requests[i].table, groups[i].request.table);
+    EXPECT_EQ(requests[i].keys, groups[i].request.keys);
+  }
+}
+
+TEST(BatchReadTest, CombinesPointReads) {
+  auto const requests = MakeRequests();
+  auto groups = GroupReadRequests(requests, true);
+  ASSERT_EQ(4, groups.size());
+
+  EXPECT_THAT(groups[0].members, ElementsAre(0, 1));
+  EXPECT_EQ(1, groups[0].key_size);
+  EXPECT_EQ("Singers", groups[0].request.table);
+  EXPECT_EQ(KeySet().AddKey(MakeKey(1)).AddKey(MakeKey(2)).AddKey(MakeKey(3)),
+            groups[0].request.keys);
+
+  // Different columns, not point keys, and a different table.
+  for (std::size_t g = 1; g != groups.size(); ++g) {
+    auto const i = g + 1;
+    EXPECT_THAT(groups[g].members, ElementsAre(i));
+    EXPECT_EQ(0, groups[g].key_size);
+    EXPECT_EQ(requests[i].table, groups[g].request.table);
+    EXPECT_EQ(requests[i].columns, groups[g].request.columns);
+    EXPECT_EQ(requests[i].keys, groups[g].request.keys);
+  }
+}
+
+TEST(BatchReadTest, DistributeCombined) {
+  auto groups = GroupReadRequests(MakeRequests(), true);
+  std::vector<StatusOr<std::vector<Row>>> results(5);
+  auto const row1 = MakeTestRow(std::int64_t{1}, "one");
+  auto const row2 = MakeTestRow(std::int64_t{2}, "two");
+  auto const row3 = MakeTestRow(std::int64_t{3}, "three");
+  DistributeReadResult(groups[0], std::vector<Row>{row1, row2, row3}, results);
+  ASSERT_STATUS_OK(results[0]);
+  EXPECT_THAT(*results[0], ElementsAre(row1, row2));
+  ASSERT_STATUS_OK(results[1]);
+  EXPECT_THAT(*results[1], ElementsAre(row2, row3));
+
+  auto const other = MakeTestRow("other");
+  DistributeReadResult(groups[1], std::vector<Row>{other}, results);
+  ASSERT_STATUS_OK(results[2]);
+  EXPECT_THAT(*results[2], ElementsAre(other));
+}
+
+TEST(BatchReadTest, DistributeFailure) {
+  auto groups = GroupReadRequests(MakeRequests(), true);
+  std::vector<StatusOr<std::vector<Row>>> results(5);
+  DistributeReadResult(groups[0], Status(StatusCode::kUnavailable, "try again"),
+                       results);
+  EXPECT_EQ(StatusCode::kUnavailable, results[0].status().code());
+  EXPECT_EQ(StatusCode::kUnavailable, results[1].status().code());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -15,6 +15,7 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_CHANNEL_H
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_CHANNEL_H
 
+#include "google/cloud/spanner/internal/channel_health.h"
 #include "google/cloud/spanner/internal/spanner_stub.h"
 #include "google/cloud/spanner/version.h"
 #include <memory>
@@ -27,18 +28,39 @@ namespace internal {
 
 /**
  * `Channel` represents a single gRPC Channel/Stub.
+ *
+ * The stub may be replaced, to recreate a channel in a bad state, so it is
+ * read and written atomically.
  */
 struct Channel {
   /// @p stub_param must not be nullptr
-  explicit Channel(std::shared_ptr<SpannerStub> stub_param)
-      : stub(std::move(stub_param)) {}
+  explicit Channel(std::shared_ptr<SpannerStub> stub_param, int id_param = 0,
+                   std::shared_ptr<ChannelHealth> health_param = nullptr)
+      : id(id_param),
+        health(std::move(health_param)),
+        stub_(std::move(stub_param)) {}
 
   // This class is not copyable or movable.
   Channel(Channel const&) = delete;
   Channel& operator=(Channel const&) = delete;
 
-  std::shared_ptr<SpannerStub> const stub;
+  std::shared_ptr<SpannerStub> stub() const { return std::atomic_load(&stub_); }
+  void set_stub(std::shared_ptr<SpannerStub> stub) {
+    std::atomic_store(&stub_, std::move(stub));
+  }
+
+  /// Whether calls on this channel should be avoided for now.
+  bool unhealthy() const { return health && health->unhealthy(); }
+
+  int const id;
+  /// The health of the channel, `nullptr` if it is not tracked.
+  std::shared_ptr<ChannelHealth> const health;
   int session_count = 0;
+  /// The number of times the channel was recreated.
+  int generation = 0;
+
+ private:
+  std::shared_ptr<SpannerStub> stub_;
 };
 
 }  // namespace internal
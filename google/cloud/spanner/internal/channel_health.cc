@@ -0,0 +1,107 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/channel_health.h"
+#include <algorithm>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+// The mean latency of the answered calls, if there are enough of them.
+std::chrono::microseconds MeanLatency(ChannelStats const& stats) {
+  auto const answered = stats.calls - stats.failures;
+  if (answered < ChannelHealth::kMinCalls) return std::chrono::microseconds(0);
+  return stats.latency / answered;
+}
+
+}  // namespace
+
+int constexpr ChannelHealth::kConsecutiveFailures;
+std::int64_t constexpr ChannelHealth::kMinCalls;
+std::int64_t constexpr ChannelHealth::kLatencyOutlierFactor;
+std::int64_t constexpr ChannelHealth::kMinOutlierLatencyMs;
+
+bool IsChannelFailure(Status const& status) {
+  return status.code() == StatusCode::kUnavailable;
+}
+
+void ChannelHealth::Record(Status const& status,
+                           std::chrono::microseconds latency) {
+  calls_.fetch_add(1, std::memory_order_relaxed);
+  if (!IsChannelFailure(status)) {
+    // Any other result, even an error, is an answer from the service.
+    consecutive_failures_.store(0, std::memory_order_relaxed);
+    latency_us_.fetch_add(latency.count(), std::memory_order_relaxed);
+    return;
+  }
+  failures_.fetch_add(1, std::memory_order_relaxed);
+  if (consecutive_failures_.fetch_add(1, std::memory_order_relaxed) + 1 >=
+      kConsecutiveFailures) {
+    MarkUnhealthy();
+  }
+}
+
+ChannelStats ChannelHealth::TakeStats() {
+  return ChannelStats{
+      calls_.exchange(0, std::memory_order_relaxed),
+      failures_.exchange(0, std::memory_order_relaxed),
+      std::chrono::microseconds(
+          latency_us_.exchange(0, std::memory_order_relaxed))};
+}
+
+void ChannelHealth::Reset() {
+  (void)TakeStats();
+  consecutive_failures_.store(0, std::memory_order_relaxed);
+  unhealthy_.store(false, std::memory_order_relaxed);
+}
+
+std::vector<std::size_t> FindUnhealthyChannels(
+    std::vector<ChannelStats> const& stats) {
+  std::vector<std::chrono::microseconds> latencies;
+  for (auto const& s : stats) {
+    auto const latency = MeanLatency(s);
+    if (latency != std::chrono::microseconds(0)) latencies.push_back(latency);
+  }
+  // Use the lower median, with two channels one may be an outlier of the
+  // other.
+  auto outlier = std::chrono::microseconds::max();
+  if (latencies.size() >= 2) {
+    auto median = latencies.begin() + (latencies.size() - 1) / 2;
+    std::nth_element(latencies.begin(), median, latencies.end());
+    outlier = (std::max)(
+        *median * ChannelHealth::kLatencyOutlierFactor,
+        std::chrono::microseconds(std::chrono::milliseconds(
+            ChannelHealth::kMinOutlierLatencyMs)));
+  }
+
+  std::vector<std::size_t> unhealthy;
+  for (std::size_t i = 0; i != stats.size(); ++i) {
+    auto const& s = stats[i];
+    if (s.calls < ChannelHealth::kMinCalls) continue;
+    if (2 * s.failures >= s.calls || MeanLatency(s) > outlier) {
+      unhealthy.push_back(i);
+    }
+  }
+  return unhealthy;
+}
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
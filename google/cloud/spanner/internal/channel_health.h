@@ -0,0 +1,110 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_CHANNEL_HEALTH_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_CHANNEL_HEALTH_H
+
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/status.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+/// The calls recorded by a `ChannelHealth` since the last check.
+struct ChannelStats {
+  std::int64_t calls;
+  /// The calls that failed with an error that may be caused by the channel.
+  std::int64_t failures;
+  /// The total latency of the other calls, which got an answer or timed out.
+  std::chrono::microseconds latency;
+};
+
+/**
+ * Whether @p status may be caused by a bad connection rather than by the
+ * request, i.e. the call did not reach the service.
+ *
+ * `kDeadlineExceeded` is not a channel failure: the RPC deadlines are those of
+ * the application's operations (see `ScopedDeadline`), which may simply be
+ * too short. Such calls count as answered, after the time they waited, so a
+ * channel where the calls keep timing out is still found as a latency outlier.
+ */
+bool IsChannelFailure(Status const& status);
+
+/**
+ * Tracks the health of a single gRPC channel.
+ *
+ * A channel is marked unhealthy as soon as `kConsecutiveFailures` calls in a
+ * row fail with a channel failure. Error rates and latency outliers, which
+ * need a comparison with the other channels, are detected periodically by the
+ * `SessionPool`, using `TakeStats()` and `FindUnhealthyChannels()`.
+ *
+ * This class is thread-safe and never takes a lock.
+ */
+class ChannelHealth {
+ public:
+  static int constexpr kConsecutiveFailures = 5;
+  static std::int64_t constexpr kMinCalls = 10;
+  static std::int64_t constexpr kLatencyOutlierFactor = 4;
+  static std::int64_t constexpr kMinOutlierLatencyMs = 10;
+
+  ChannelHealth() = default;
+  ChannelHealth(ChannelHealth const&) = delete;
+  ChannelHealth& operator=(ChannelHealth const&) = delete;
+
+  /// Record the result of a call, with the latency of its first response.
+  void Record(Status const& status, std::chrono::microseconds latency);
+
+  bool unhealthy() const { return unhealthy_.load(std::memory_order_relaxed); }
+  void MarkUnhealthy() { unhealthy_.store(true, std::memory_order_relaxed); }
+
+  /// Return the calls recorded since the previous call, and reset them.
+  ChannelStats TakeStats();
+
+  /// Forget the past calls, e.g. after the channel is recreated.
+  void Reset();
+
+ private:
+  std::atomic<bool> unhealthy_{false};
+  std::atomic<int> consecutive_failures_{0};
+  std::atomic<std::int64_t> calls_{0};
+  std::atomic<std::int64_t> failures_{0};
+  std::atomic<std::int64_t> latency_us_{0};
+};
+
+/**
+ * Return the indices of the channels in @p stats that look unhealthy.
+ *
+ * Only channels with at least `ChannelHealth::kMinCalls` calls are considered.
+ * A channel is unhealthy if at least half of its calls failed, or if the mean
+ * latency of its answered calls is more than `kLatencyOutlierFactor` times the
+ * median of the channels, and at least `kMinOutlierLatencyMs`.
+ */
+std::vector<std::size_t> FindUnhealthyChannels(
+    std::vector<ChannelStats> const& stats);
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_CHANNEL_HEALTH_H
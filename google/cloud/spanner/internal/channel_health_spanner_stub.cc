@@ -0,0 +1,217 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/channel_health_spanner_stub.h"
+#include "google/cloud/spanner/internal/stub_decorator_utils.h"
+#include "google/cloud/grpc_error_delegate.h"
+#include "google/cloud/optional.h"
+#include <chrono>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+namespace spanner_proto = ::google::spanner::v1;
+
+using PartialResultSetReader =
+    grpc::ClientReaderInterface<spanner_proto::PartialResultSet>;
+
+/**
+ * Records the result of a streaming call when the caller finishes it, with the
+ * latency of the first response.
+ */
+class ChannelHealthStreamReader : public ForwardingStreamReader {
+ public:
+  ChannelHealthStreamReader(std::unique_ptr<PartialResultSetReader> child,
+                            std::shared_ptr<ChannelHealth> health,
+                            std::chrono::steady_clock::time_point start)
+      : ForwardingStreamReader(std::move(child)),
+        health_(std::move(health)),
+        start_(start) {}
+
+  bool Read(spanner_proto::PartialResultSet* response) override {
+    auto const result = ForwardingStreamReader::Read(response);
+    if (!first_response_) first_response_ = ElapsedSince(start_);
+    return result;
+  }
+
+  grpc::Status Finish() override {
+    auto status = ForwardingStreamReader::Finish();
+    if (!first_response_) first_response_ = ElapsedSince(start_);
+    health_->Record(google::cloud::MakeStatusFromRpcError(status),
+                    *first_response_);
+    return status;
+  }
+
+ private:
+  std::shared_ptr<ChannelHealth> health_;
+  std::chrono::steady_clock::time_point start_;
+  optional<std::chrono::microseconds> first_response_;
+};
+
+}  // namespace
+
+template <typename Functor>
+auto ChannelHealthSpannerStub::Unary(Functor&& functor) -> decltype(functor()) {
+  auto const start = std::chrono::steady_clock::now();
+  auto response = functor();
+  health_->Record(StatusOf(response), ElapsedSince(start));
+  return response;
+}
+
+template <typename Functor>
+auto ChannelHealthSpannerStub::Streaming(Functor&& functor)
+    -> decltype(functor()) {
+  auto const start = std::chrono::steady_clock::now();
+  auto reader = functor();
+  if (!reader) return reader;
+  return std::unique_ptr<PartialResultSetReader>(
+      new ChannelHealthStreamReader(std::move(reader), health_, start));
+}
+
+StatusOr<spanner_proto::Session> ChannelHealthSpannerStub::CreateSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::CreateSessionRequest const& request) {
+  return Unary([&] { return child_->CreateSession(client_context, request); });
+}
+
+StatusOr<spanner_proto::BatchCreateSessionsResponse>
+ChannelHealthSpannerStub::BatchCreateSessions(
+    grpc::ClientContext& client_context,
+    spanner_proto::BatchCreateSessionsRequest const& request) {
+  return Unary([&] {
+    return child_->BatchCreateSessions(client_context, request);
+  });
+}
+
+std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+    spanner_proto::BatchCreateSessionsResponse>>
+ChannelHealthSpannerStub::AsyncBatchCreateSessions(
+    grpc::ClientContext& client_context,
+    spanner_proto::BatchCreateSessionsRequest const& request,
+    grpc::CompletionQueue* cq) {
+  return child_->AsyncBatchCreateSessions(client_context, request, cq);
+}
+
+StatusOr<spanner_proto::Session> ChannelHealthSpannerStub::GetSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::GetSessionRequest const& request) {
+  return Unary([&] { return child_->GetSession(client_context, request); });
+}
+
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<spanner_proto::Session>>
+ChannelHealthSpannerStub::AsyncGetSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::GetSessionRequest const& request,
+    grpc::CompletionQueue* cq) {
+  return child_->AsyncGetSession(client_context, request, cq);
+}
+
+StatusOr<spanner_proto::ListSessionsResponse>
+ChannelHealthSpannerStub::ListSessions(
+    grpc::ClientContext& client_context,
+    spanner_proto::ListSessionsRequest const& request) {
+  return Unary([&] { return child_->ListSessions(client_context, request); });
+}
+
+Status ChannelHealthSpannerStub::DeleteSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::DeleteSessionRequest const& request) {
+  return Unary([&] { return child_->DeleteSession(client_context, request); });
+}
+
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<google::protobuf::Empty>>
+ChannelHealthSpannerStub::AsyncDeleteSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::DeleteSessionRequest const& request,
+    grpc::CompletionQueue* cq) {
+  return child_->AsyncDeleteSession(client_context, request, cq);
+}
+
+StatusOr<spanner_proto::ResultSet> ChannelHealthSpannerStub::ExecuteSql(
+    grpc::ClientContext& client_context,
+    spanner_proto::ExecuteSqlRequest const& request) {
+  return Unary([&] { return child_->ExecuteSql(client_context, request); });
+}
+
+std::unique_ptr<PartialResultSetReader>
+ChannelHealthSpannerStub::ExecuteStreamingSql(
+    grpc::ClientContext& client_context,
+    spanner_proto::ExecuteSqlRequest const& request) {
+  return Streaming([&] {
+    return child_->ExecuteStreamingSql(client_context, request);
+  });
+}
+
+StatusOr<spanner_proto::ExecuteBatchDmlResponse>
+ChannelHealthSpannerStub::ExecuteBatchDml(
+    grpc::ClientContext& client_context,
+    spanner_proto::ExecuteBatchDmlRequest const& request) {
+  return Unary([&] {
+    return child_->ExecuteBatchDml(client_context, request);
+  });
+}
+
+std::unique_ptr<PartialResultSetReader> ChannelHealthSpannerStub::StreamingRead(
+    grpc::ClientContext& client_context,
+    spanner_proto::ReadRequest const& request) {
+  return Streaming([&] {
+    return child_->StreamingRead(client_context, request);
+  });
+}
+
+StatusOr<spanner_proto::Transaction> ChannelHealthSpannerStub::BeginTransaction(
+    grpc::ClientContext& client_context,
+    spanner_proto::BeginTransactionRequest const& request) {
+  return Unary([&] {
+    return child_->BeginTransaction(client_context, request);
+  });
+}
+
+StatusOr<spanner_proto::CommitResponse> ChannelHealthSpannerStub::Commit(
+    grpc::ClientContext& client_context,
+    spanner_proto::CommitRequest const& request) {
+  return Unary([&] { return child_->Commit(client_context, request); });
+}
+
+Status ChannelHealthSpannerStub::Rollback(
+    grpc::ClientContext& client_context,
+    spanner_proto::RollbackRequest const& request) {
+  return Unary([&] { return child_->Rollback(client_context, request); });
+}
+
+StatusOr<spanner_proto::PartitionResponse>
+ChannelHealthSpannerStub::PartitionQuery(
+    grpc::ClientContext& client_context,
+    spanner_proto::PartitionQueryRequest const& request) {
+  return Unary([&] { return child_->PartitionQuery(client_context, request); });
+}
+
+StatusOr<spanner_proto::PartitionResponse>
+ChannelHealthSpannerStub::PartitionRead(
+    grpc::ClientContext& client_context,
+    spanner_proto::PartitionReadRequest const& request) {
+  return Unary([&] { return child_->PartitionRead(client_context, request); });
+}
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
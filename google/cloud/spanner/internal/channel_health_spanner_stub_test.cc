@@ -0,0 +1,145 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/channel_health_spanner_stub.h"
+#include "google/cloud/spanner/testing/mock_spanner_stub.h"
+#include "google/cloud/internal/make_unique.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <gmock/gmock.h>
+#include <chrono>
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::internal::make_unique;
+using ::testing::_;
+using ::testing::Return;
+namespace spanner_proto = ::google::spanner::v1;
+
+class MockGrpcReader
+    : public ::grpc::ClientReaderInterface<spanner_proto::PartialResultSet> {
+ public:
+  MOCK_METHOD1(Read, bool(spanner_proto::PartialResultSet*));
+  MOCK_METHOD1(NextMessageSize, bool(std::uint32_t*));
+  MOCK_METHOD0(Finish, grpc::Status());
+  MOCK_METHOD0(WaitForInitialMetadata, void());
+};
+
+class ChannelHealthSpannerStubTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    mock_ = std::make_shared<spanner_testing::MockSpannerStub>();
+    health_ = std::make_shared<ChannelHealth>();
+  }
+
+  std::shared_ptr<spanner_testing::MockSpannerStub> mock_;
+  std::shared_ptr<ChannelHealth> health_;
+};
+
+TEST_F(ChannelHealthSpannerStubTest, Unary) {
+  auto const delay = std::chrono::milliseconds(2);
+  EXPECT_CALL(*mock_, Commit(_, _))
+      .WillOnce(Return(Status(StatusCode::kUnavailable, "try-again")))
+      .WillOnce([delay](grpc::ClientContext&,
+                        spanner_proto::CommitRequest const&) {
+        std::this_thread::sleep_for(delay);
+        return spanner_proto::CommitResponse();
+      });
+  EXPECT_CALL(*mock_, Rollback(_, _))
+      .WillOnce(Return(Status(StatusCode::kNotFound, "not-found")));
+
+  ChannelHealthSpannerStub stub(mock_, health_);
+  grpc::ClientContext context;
+  auto response = stub.Commit(context, spanner_proto::CommitRequest());
+  EXPECT_EQ(StatusCode::kUnavailable, response.status().code());
+  response = stub.Commit(context, spanner_proto::CommitRequest());
+  EXPECT_STATUS_OK(response);
+  auto status = stub.Rollback(context, spanner_proto::RollbackRequest());
+  EXPECT_EQ(StatusCode::kNotFound, status.code());
+
+  auto const stats = health_->TakeStats();
+  EXPECT_EQ(3, stats.calls);
+  EXPECT_EQ(1, stats.failures);
+  EXPECT_LE(delay, stats.latency);
+  EXPECT_FALSE(health_->unhealthy());
+}
+
+TEST_F(ChannelHealthSpannerStubTest, UnaryConsecutiveFailures) {
+  EXPECT_CALL(*mock_, Rollback(_, _))
+      .Times(ChannelHealth::kConsecutiveFailures)
+      .WillRepeatedly(Return(Status(StatusCode::kUnavailable, "try-again")));
+
+  ChannelHealthSpannerStub stub(mock_, health_);
+  for (int i = 0; i != ChannelHealth::kConsecutiveFailures; ++i) {
+    grpc::ClientContext context;
+    auto status = stub.Rollback(context, spanner_proto::RollbackRequest());
+    EXPECT_EQ(StatusCode::kUnavailable, status.code());
+  }
+  EXPECT_TRUE(health_->unhealthy());
+}
+
+TEST_F(ChannelHealthSpannerStubTest, Streaming) {
+  EXPECT_CALL(*mock_, StreamingRead(_, _))
+      .WillOnce([](grpc::ClientContext&, spanner_proto::ReadRequest const&) {
+        auto reader = make_unique<MockGrpcReader>();
+        EXPECT_CALL(*reader, Read(_))
+            .WillOnce(Return(true))
+            .WillOnce(Return(false));
+        EXPECT_CALL(*reader, Finish())
+            .WillOnce(Return(
+                grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again")));
+        return reader;
+      });
+
+  ChannelHealthSpannerStub stub(mock_, health_);
+  grpc::ClientContext context;
+  auto reader = stub.StreamingRead(context, spanner_proto::ReadRequest());
+  ASSERT_TRUE(reader);
+  spanner_proto::PartialResultSet r;
+  while (reader->Read(&r)) continue;
+  EXPECT_EQ(0, health_->TakeStats().calls);
+  EXPECT_FALSE(reader->Finish().ok());
+
+  auto const stats = health_->TakeStats();
+  EXPECT_EQ(1, stats.calls);
+  EXPECT_EQ(1, stats.failures);
+}
+
+TEST_F(ChannelHealthSpannerStubTest, StreamingNotFinished) {
+  EXPECT_CALL(*mock_, ExecuteStreamingSql(_, _))
+      .WillOnce(
+          [](grpc::ClientContext&, spanner_proto::ExecuteSqlRequest const&) {
+            return make_unique<MockGrpcReader>();
+          });
+
+  ChannelHealthSpannerStub stub(mock_, health_);
+  grpc::ClientContext context;
+  auto reader =
+      stub.ExecuteStreamingSql(context, spanner_proto::ExecuteSqlRequest());
+  ASSERT_TRUE(reader);
+  reader.reset();
+  EXPECT_EQ(0, health_->TakeStats().calls);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
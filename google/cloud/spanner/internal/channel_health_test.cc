@@ -0,0 +1,145 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/channel_health.h"
+#include <gmock/gmock.h>
+#include <chrono>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+Status ChannelFailure() {
+  return Status(StatusCode::kUnavailable, "try-again");
+}
+
+TEST(ChannelHealthTest, IsChannelFailure) {
+  EXPECT_TRUE(IsChannelFailure(ChannelFailure()));
+  EXPECT_FALSE(IsChannelFailure(Status(StatusCode::kDeadlineExceeded, "")));
+  EXPECT_FALSE(IsChannelFailure(Status()));
+  EXPECT_FALSE(IsChannelFailure(Status(StatusCode::kNotFound, "")));
+  EXPECT_FALSE(IsChannelFailure(Status(StatusCode::kAborted, "")));
+}
+
+TEST(ChannelHealthTest, ConsecutiveFailures) {
+  ChannelHealth health;
+  for (int i = 1; i != ChannelHealth::kConsecutiveFailures; ++i) {
+    health.Record(ChannelFailure(), microseconds(0));
+  }
+  EXPECT_FALSE(health.unhealthy());
+  // Any answer from the service breaks the sequence.
+  health.Record(Status(StatusCode::kNotFound, "not-found"), microseconds(0));
+  health.Record(ChannelFailure(), microseconds(0));
+  EXPECT_FALSE(health.unhealthy());
+
+  for (int i = 1; i != ChannelHealth::kConsecutiveFailures; ++i) {
+    health.Record(ChannelFailure(), microseconds(0));
+  }
+  EXPECT_TRUE(health.unhealthy());
+  health.Reset();
+  EXPECT_FALSE(health.unhealthy());
+}
+
+TEST(ChannelHealthTest, TimeoutsAreNotFailures) {
+  ChannelHealth health;
+  auto const timeout = Status(StatusCode::kDeadlineExceeded, "timeout");
+  for (int i = 0; i != ChannelHealth::kConsecutiveFailures; ++i) {
+    health.Record(timeout, milliseconds(10));
+  }
+  EXPECT_FALSE(health.unhealthy());
+
+  auto const stats = health.TakeStats();
+  EXPECT_EQ(ChannelHealth::kConsecutiveFailures, stats.calls);
+  EXPECT_EQ(0, stats.failures);
+  EXPECT_EQ(milliseconds(10 * ChannelHealth::kConsecutiveFailures),
+            stats.latency);
+}
+
+TEST(ChannelHealthTest, TakeStats) {
+  ChannelHealth health;
+  health.Record(Status(), microseconds(100));
+  health.Record(Status(StatusCode::kNotFound, "not-found"), microseconds(200));
+  health.Record(ChannelFailure(), microseconds(5000));
+
+  auto stats = health.TakeStats();
+  EXPECT_EQ(3, stats.calls);
+  EXPECT_EQ(1, stats.failures);
+  EXPECT_EQ(microseconds(300), stats.latency);
+
+  stats = health.TakeStats();
+  EXPECT_EQ(0, stats.calls);
+  EXPECT_EQ(0, stats.failures);
+  EXPECT_EQ(microseconds(0), stats.latency);
+}
+
+ChannelStats Calls(std::int64_t calls, std::int64_t failures,
+                   microseconds mean_latency) {
+  return ChannelStats{calls, failures, mean_latency * (calls - failures)};
+}
+
+TEST(FindUnhealthyChannelsTest, Healthy) {
+  EXPECT_THAT(FindUnhealthyChannels({}), IsEmpty());
+  EXPECT_THAT(FindUnhealthyChannels({Calls(100, 10, milliseconds(5)),
+                                     Calls(100, 0, milliseconds(8)),
+                                     Calls(100, 0, milliseconds(12))}),
+              IsEmpty());
+}
+
+TEST(FindUnhealthyChannelsTest, ErrorRate) {
+  EXPECT_THAT(FindUnhealthyChannels({Calls(100, 0, milliseconds(5)),
+                                     Calls(100, 50, milliseconds(5)),
+                                     Calls(100, 49, milliseconds(5))}),
+              ElementsAre(1));
+  // Too few calls to tell.
+  EXPECT_THAT(FindUnhealthyChannels({Calls(100, 0, milliseconds(5)),
+                                     Calls(ChannelHealth::kMinCalls - 1,
+                                           ChannelHealth::kMinCalls - 1,
+                                           milliseconds(0))}),
+              IsEmpty());
+}
+
+TEST(FindUnhealthyChannelsTest, LatencyOutlier) {
+  EXPECT_THAT(FindUnhealthyChannels({Calls(100, 0, milliseconds(5)),
+                                     Calls(100, 0, milliseconds(6)),
+                                     Calls(100, 0, milliseconds(50)),
+                                     Calls(100, 0, milliseconds(7))}),
+              ElementsAre(2));
+  // With two channels the slower one can be an outlier.
+  EXPECT_THAT(FindUnhealthyChannels({Calls(100, 0, milliseconds(50)),
+                                     Calls(100, 0, milliseconds(5))}),
+              ElementsAre(0));
+  // Fast calls are never outliers.
+  EXPECT_THAT(FindUnhealthyChannels({Calls(100, 0, microseconds(100)),
+                                     Calls(100, 0, milliseconds(2))}),
+              IsEmpty());
+  // A single channel has nothing to compare with.
+  EXPECT_THAT(FindUnhealthyChannels({Calls(100, 0, milliseconds(500))}),
+              IsEmpty());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
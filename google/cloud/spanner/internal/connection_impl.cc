@@ -13,11 +13,15 @@
 // limitations under the License.
 
 #include "google/cloud/spanner/internal/connection_impl.h"
+#include "google/cloud/spanner/internal/deadline.h"
 #include "google/cloud/spanner/internal/logging_result_set_reader.h"
 #include "google/cloud/spanner/internal/partial_result_set_resume.h"
 #include "google/cloud/spanner/internal/partial_result_set_source.h"
+#include "google/cloud/spanner/internal/retry_budget_policy.h"
+#include "google/cloud/spanner/internal/retry_budget_spanner_stub.h"
 #include "google/cloud/spanner/internal/retry_loop.h"
 #include "google/cloud/spanner/internal/status_utils.h"
+#include "google/cloud/spanner/internal/tracing.h"
 #include "google/cloud/spanner/query_partition.h"
 #include "google/cloud/spanner/read_partition.h"
 #include "google/cloud/grpc_error_delegate.h"
@@ -63,6 +67,94 @@ class DefaultPartialResultSetReader : public PartialResultSetReader {
 
 namespace spanner_proto = ::google::spanner::v1;
 
+std::shared_ptr<HedgingDelay> MakeHedgingDelay(
+    ConnectionTuningOptions const& options) {
+  if (options.hedge_percentile() == 0) return nullptr;
+  return std::make_shared<HedgingDelay>(
+      HedgingConfig{options.hedge_percentile(), options.hedge_min_delay()});
+}
+
+/**
+ * Where the calls of a streaming read or query go.
+ *
+ * A resumed call must send the session of the call that returned the resume
+ * token, so if a hedge wins, the resumed calls switch to the session of the
+ * hedge, which is kept out of the pool until the stream is done.
+ */
+struct StreamTarget {
+  std::shared_ptr<SpannerStub> stub;
+  // The session of a hedge, `nullptr` while the calls use the primary's.
+  SessionHolder session;
+};
+
+/**
+ * Return the factory for the calls of a streaming read or query.
+ *
+ * If @p hedging_delay is set, the first call is hedged with the same request
+ * on another idle session, from @p allocate_hedge_session.
+ */
+template <typename Request, typename MakeReader>
+PartialResultSetReaderFactory MakeStreamFactory(
+    Request request, std::shared_ptr<SpannerStub> stub, MakeReader make_reader,
+    std::shared_ptr<HedgingDelay> hedging_delay,
+    std::shared_ptr<SessionPool> session_pool,
+    std::function<SessionHolder()> allocate_hedge_session, CompletionQueue cq) {
+  auto target = std::make_shared<StreamTarget>();
+  target->stub = std::move(stub);
+  return [request, target, make_reader, hedging_delay, session_pool,
+          allocate_hedge_session, cq](std::string const& resume_token) mutable {
+    if (target->session) request.set_session(target->session->session_name());
+    request.set_resume_token(resume_token);
+    auto reader = make_reader(*target->stub, request);
+    // Only the first response is hedged, not the resumed calls.
+    if (!hedging_delay || !resume_token.empty()) return reader;
+    auto hedge = std::make_shared<StreamTarget>();
+    return std::unique_ptr<PartialResultSetReader>(
+        google::cloud::internal::make_unique<HedgedPartialResultSetReader>(
+            std::move(reader),
+            [hedge, request, make_reader, session_pool,
+             allocate_hedge_session]() mutable {
+              hedge->session = allocate_hedge_session();
+              if (!hedge->session) {
+                return std::unique_ptr<PartialResultSetReader>{};
+              }
+              hedge->stub = session_pool->GetStub(*hedge->session);
+              request.set_session(hedge->session->session_name());
+              return make_reader(*hedge->stub, request);
+            },
+            [target, hedge] { *target = std::move(*hedge); }, hedging_delay,
+            cq));
+  };
+}
+
+std::unique_ptr<RetryPolicy> WithRetryBudget(
+    std::unique_ptr<RetryPolicy> retry_policy,
+    std::shared_ptr<RetryBudget> const& budget) {
+  if (!budget) return retry_policy;
+  return google::cloud::internal::make_unique<RetryBudgetPolicy>(
+      std::move(retry_policy), budget);
+}
+
+std::vector<std::shared_ptr<SpannerStub>> WithRetryBudget(
+    std::vector<std::shared_ptr<SpannerStub>> stubs,
+    std::shared_ptr<RetryBudget> const& budget) {
+  if (!budget) return stubs;
+  for (auto& stub : stubs) {
+    stub = std::make_shared<RetryBudgetSpannerStub>(std::move(stub), budget);
+  }
+  return stubs;
+}
+
+SpannerStubFactory WithRetryBudget(SpannerStubFactory stub_factory,
+                                   std::shared_ptr<RetryBudget> const& budget) {
+  if (!stub_factory || !budget) return stub_factory;
+  return [stub_factory, budget](int channel_id, int generation) {
+    auto stub = stub_factory(channel_id, generation);
+    return std::shared_ptr<SpannerStub>(
+        std::make_shared<RetryBudgetSpannerStub>(std::move(stub), budget));
+  };
+}
+
 std::unique_ptr<RetryPolicy> DefaultConnectionRetryPolicy() {
   return google::cloud::spanner::LimitedTimeRetryPolicy(
              std::chrono::minutes(10))
@@ -81,10 +173,12 @@ std::shared_ptr<ConnectionImpl> MakeConnection(
     Database db, std::vector<std::shared_ptr<SpannerStub>> stubs,
     ConnectionOptions const& options, SessionPoolOptions session_pool_options,
     std::unique_ptr<RetryPolicy> retry_policy,
-    std::unique_ptr<BackoffPolicy> backoff_policy) {
+    std::unique_ptr<BackoffPolicy> backoff_policy,
+    SpannerStubFactory stub_factory, ConnectionTuningOptions tuning_options) {
   return std::shared_ptr<ConnectionImpl>(new ConnectionImpl(
       std::move(db), std::move(stubs), options, std::move(session_pool_options),
-      std::move(retry_policy), std::move(backoff_policy)));
+      std::move(retry_policy), std::move(backoff_policy),
+      std::move(stub_factory), std::move(tuning_options)));
 }
 
 ConnectionImpl::ConnectionImpl(Database db,
@@ -92,19 +186,29 @@ ConnectionImpl::ConnectionImpl(Database db,
                                ConnectionOptions const& options,
                                SessionPoolOptions session_pool_options,
                                std::unique_ptr<RetryPolicy> retry_policy,
-                               std::unique_ptr<BackoffPolicy> backoff_policy)
+                               std::unique_ptr<BackoffPolicy> backoff_policy,
+                               SpannerStubFactory stub_factory,
+                               ConnectionTuningOptions tuning_options)
     : db_(std::move(db)),
-      retry_policy_prototype_(std::move(retry_policy)),
+      retry_budget_(tuning_options.retry_budget()),
+      retry_policy_prototype_(
+          WithRetryBudget(std::move(retry_policy), retry_budget_)),
       backoff_policy_prototype_(std::move(backoff_policy)),
       background_threads_(options.background_threads_factory()()),
       session_pool_(MakeSessionPool(
-          db_, std::move(stubs), std::move(session_pool_options),
-          background_threads_->cq(), retry_policy_prototype_->clone(),
-          backoff_policy_prototype_->clone())),
+          db_, WithRetryBudget(std::move(stubs), retry_budget_),
+          std::move(session_pool_options), background_threads_->cq(),
+          retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
+          std::make_shared<Session::Clock>(),
+          WithRetryBudget(std::move(stub_factory), retry_budget_))),
       rpc_stream_tracing_enabled_(options.tracing_enabled("rpc-streams")),
-      tracing_options_(options.tracing_options()) {}
+      tracing_options_(options.tracing_options()),
+      tracer_(tuning_options.tracer()),
+      hedging_delay_(MakeHedgingDelay(tuning_options)),
+      single_use_commits_(tuning_options.single_use_commits()) {}
 
 RowStream ConnectionImpl::Read(ReadParams params) {
+  ScopedSpan span(tracer_, "spanner.Read");
   return internal::Visit(
       std::move(params.transaction),
       [this, &params](SessionHolder& session,
@@ -115,16 +219,20 @@ RowStream ConnectionImpl::Read(ReadParams params) {
 
 StatusOr<std::vector<ReadPartition>> ConnectionImpl::PartitionRead(
     PartitionReadParams params) {
-  return internal::Visit(
+  ScopedSpan span(tracer_, "spanner.PartitionRead");
+  auto result = internal::Visit(
       std::move(params.read_params.transaction),
       [this, &params](SessionHolder& session,
                       spanner_proto::TransactionSelector& s, std::int64_t) {
         return PartitionReadImpl(session, s, params.read_params,
                                  params.partition_options);
       });
+  span.End(result.status());
+  return result;
 }
 
 RowStream ConnectionImpl::ExecuteQuery(SqlParams params) {
+  ScopedSpan span(tracer_, "spanner.ExecuteQuery");
   return internal::Visit(std::move(params.transaction),
                          [this, &params](SessionHolder& session,
                                          spanner_proto::TransactionSelector& s,
@@ -135,16 +243,20 @@ RowStream ConnectionImpl::ExecuteQuery(SqlParams params) {
 }
 
 StatusOr<DmlResult> ConnectionImpl::ExecuteDml(SqlParams params) {
-  return internal::Visit(std::move(params.transaction),
-                         [this, &params](SessionHolder& session,
-                                         spanner_proto::TransactionSelector& s,
-                                         std::int64_t seqno) {
-                           return ExecuteDmlImpl(session, s, seqno,
-                                                 std::move(params));
-                         });
+  ScopedSpan span(tracer_, "spanner.ExecuteDml");
+  auto result = internal::Visit(
+      std::move(params.transaction),
+      [this, &params](SessionHolder& session,
+                      spanner_proto::TransactionSelector& s,
+                      std::int64_t seqno) {
+        return ExecuteDmlImpl(session, s, seqno, std::move(params));
+      });
+  span.End(result.status());
+  return result;
 }
 
 ProfileQueryResult ConnectionImpl::ProfileQuery(SqlParams params) {
+  ScopedSpan span(tracer_, "spanner.ProfileQuery");
   return internal::Visit(std::move(params.transaction),
                          [this, &params](SessionHolder& session,
                                          spanner_proto::TransactionSelector& s,
@@ -155,71 +267,92 @@ ProfileQueryResult ConnectionImpl::ProfileQuery(SqlParams params) {
 }
 
 StatusOr<ProfileDmlResult> ConnectionImpl::ProfileDml(SqlParams params) {
-  return internal::Visit(std::move(params.transaction),
-                         [this, &params](SessionHolder& session,
-                                         spanner_proto::TransactionSelector& s,
-                                         std::int64_t seqno) {
-                           return ProfileDmlImpl(session, s, seqno,
-                                                 std::move(params));
-                         });
+  ScopedSpan span(tracer_, "spanner.ProfileDml");
+  auto result = internal::Visit(
+      std::move(params.transaction),
+      [this, &params](SessionHolder& session,
+                      spanner_proto::TransactionSelector& s,
+                      std::int64_t seqno) {
+        return ProfileDmlImpl(session, s, seqno, std::move(params));
+      });
+  span.End(result.status());
+  return result;
 }
 
 StatusOr<ExecutionPlan> ConnectionImpl::AnalyzeSql(SqlParams params) {
-  return internal::Visit(std::move(params.transaction),
-                         [this, &params](SessionHolder& session,
-                                         spanner_proto::TransactionSelector& s,
-                                         std::int64_t seqno) {
-                           return AnalyzeSqlImpl(session, s, seqno,
-                                                 std::move(params));
-                         });
+  ScopedSpan span(tracer_, "spanner.AnalyzeSql");
+  auto result = internal::Visit(
+      std::move(params.transaction),
+      [this, &params](SessionHolder& session,
+                      spanner_proto::TransactionSelector& s,
+                      std::int64_t seqno) {
+        return AnalyzeSqlImpl(session, s, seqno, std::move(params));
+      });
+  span.End(result.status());
+  return result;
 }
 
 StatusOr<PartitionedDmlResult> ConnectionImpl::ExecutePartitionedDml(
     ExecutePartitionedDmlParams params) {
+  ScopedSpan span(tracer_, "spanner.ExecutePartitionedDml");
   auto txn = MakeReadOnlyTransaction();
-  return internal::Visit(
+  auto result = internal::Visit(
       txn, [this, &params](SessionHolder& session,
                            spanner_proto::TransactionSelector& s,
                            std::int64_t seqno) {
         return ExecutePartitionedDmlImpl(session, s, seqno, std::move(params));
       });
+  span.End(result.status());
+  return result;
 }
 
 StatusOr<std::vector<QueryPartition>> ConnectionImpl::PartitionQuery(
     PartitionQueryParams params) {
-  return internal::Visit(
+  ScopedSpan span(tracer_, "spanner.PartitionQuery");
+  auto result = internal::Visit(
       std::move(params.transaction),
       [this, &params](SessionHolder& session,
                       spanner_proto::TransactionSelector& s, std::int64_t) {
         return PartitionQueryImpl(session, s, params);
       });
+  span.End(result.status());
+  return result;
 }
 
 StatusOr<BatchDmlResult> ConnectionImpl::ExecuteBatchDml(
     ExecuteBatchDmlParams params) {
-  return internal::Visit(std::move(params.transaction),
-                         [this, &params](SessionHolder& session,
-                                         spanner_proto::TransactionSelector& s,
-                                         std::int64_t seqno) {
-                           return ExecuteBatchDmlImpl(session, s, seqno,
-                                                      std::move(params));
-                         });
+  ScopedSpan span(tracer_, "spanner.ExecuteBatchDml");
+  auto result = internal::Visit(
+      std::move(params.transaction),
+      [this, &params](SessionHolder& session,
+                      spanner_proto::TransactionSelector& s,
+                      std::int64_t seqno) {
+        return ExecuteBatchDmlImpl(session, s, seqno, std::move(params));
+      });
+  span.End(result.status());
+  return result;
 }
 
 StatusOr<CommitResult> ConnectionImpl::Commit(CommitParams params) {
-  return internal::Visit(
+  ScopedSpan span(tracer_, "spanner.Commit");
+  auto result = internal::Visit(
       std::move(params.transaction),
       [this, &params](SessionHolder& session,
                       spanner_proto::TransactionSelector& s, std::int64_t) {
         return this->CommitImpl(session, s, std::move(params));
       });
+  span.End(result.status());
+  return result;
 }
 
 Status ConnectionImpl::Rollback(RollbackParams params) {
-  return internal::Visit(
+  ScopedSpan span(tracer_, "spanner.Rollback");
+  auto status = internal::Visit(
       std::move(params.transaction),
       [this](SessionHolder& session, spanner_proto::TransactionSelector& s,
              std::int64_t) { return this->RollbackImpl(session, s); });
+  span.End(status);
+  return status;
 }
 
 class StatusOnlyResultSetSource : public internal::ResultSourceInterface {
@@ -296,6 +429,14 @@ Status ConnectionImpl::PrepareSession(SessionHolder& session,
   return Status();
 }
 
+std::shared_ptr<HedgingDelay> ConnectionImpl::HedgingDelayFor(
+    spanner_proto::TransactionSelector const& s) const {
+  // Only hedge the reads that are safe to send twice: the duplicate of a
+  // single-use read-only transaction is just another read.
+  if (!s.has_single_use() || !s.single_use().has_read_only()) return nullptr;
+  return hedging_delay_;
+}
+
 RowStream ConnectionImpl::ReadImpl(SessionHolder& session,
                                    spanner_proto::TransactionSelector& s,
                                    ReadParams params) {
@@ -323,19 +464,32 @@ RowStream ConnectionImpl::ReadImpl(SessionHolder& session,
   auto stub = session_pool_->GetStub(*session);
   auto const tracing_enabled = rpc_stream_tracing_enabled_;
   auto const tracing_options = tracing_options_;
-  auto factory = [stub, request, tracing_enabled,
-                  tracing_options](std::string const& resume_token) mutable {
-    request.set_resume_token(resume_token);
+  auto make_reader = [tracing_enabled, tracing_options](
+                         SpannerStub& channel_stub,
+                         spanner_proto::ReadRequest const& rpc_request) {
     auto context = google::cloud::internal::make_unique<grpc::ClientContext>();
+    // A stream may run for longer than an attempt timeout, it is only bound
+    // by the operation deadline.
+    SetDeadline(*context, CurrentDeadline().deadline);
     std::unique_ptr<PartialResultSetReader> reader =
         google::cloud::internal::make_unique<DefaultPartialResultSetReader>(
-            std::move(context), stub->StreamingRead(*context, request));
+            std::move(context),
+            channel_stub.StreamingRead(*context, rpc_request));
     if (tracing_enabled) {
       reader = google::cloud::internal::make_unique<LoggingResultSetReader>(
           std::move(reader), tracing_options);
     }
     return reader;
   };
+  auto hedging_delay = HedgingDelayFor(s);
+  std::function<SessionHolder()> allocate_hedge_session;
+  if (hedging_delay) {
+    allocate_hedge_session = session_pool_->HedgeSessionAllocator(*session);
+  }
+  auto factory = MakeStreamFactory(
+      std::move(request), std::move(stub), std::move(make_reader),
+      std::move(hedging_delay), session_pool_,
+      std::move(allocate_hedge_session), background_threads_->cq());
   auto rpc = google::cloud::internal::make_unique<PartialResultSetResume>(
       std::move(factory), Idempotency::kIdempotent,
       retry_policy_prototype_->clone(), backoff_policy_prototype_->clone());
@@ -462,28 +616,44 @@ ResultType ConnectionImpl::CommonQueryImpl(
   // through the lifetime of the lambda. Note that the local variables are a
   // reference to avoid increasing refcounts twice, but the capture is by value.
   auto stub = session_pool_->GetStub(*session);
+  // Profiled queries are not hedged, their statistics should describe a
+  // single execution.
+  auto hedging_delay = query_mode == spanner_proto::ExecuteSqlRequest::NORMAL
+                           ? HedgingDelayFor(s)
+                           : nullptr;
+  std::function<SessionHolder()> allocate_hedge_session;
+  if (hedging_delay) {
+    allocate_hedge_session = session_pool_->HedgeSessionAllocator(*session);
+  }
+  auto const& session_pool = session_pool_;
+  auto cq = background_threads_->cq();
   auto const& retry_policy = retry_policy_prototype_;
   auto const& backoff_policy = backoff_policy_prototype_;
   auto const tracing_enabled = rpc_stream_tracing_enabled_;
   auto const tracing_options = tracing_options_;
+  auto make_reader = [tracing_enabled, tracing_options](
+                         SpannerStub& channel_stub,
+                         spanner_proto::ExecuteSqlRequest const& rpc_request) {
+    auto context = google::cloud::internal::make_unique<grpc::ClientContext>();
+    SetDeadline(*context, CurrentDeadline().deadline);
+    std::unique_ptr<PartialResultSetReader> reader =
+        google::cloud::internal::make_unique<DefaultPartialResultSetReader>(
+            std::move(context),
+            channel_stub.ExecuteStreamingSql(*context, rpc_request));
+    if (tracing_enabled) {
+      reader = google::cloud::internal::make_unique<LoggingResultSetReader>(
+          std::move(reader), tracing_options);
+    }
+    return reader;
+  };
   auto retry_resume_fn =
-      [stub, retry_policy, backoff_policy, tracing_enabled,
-       tracing_options](spanner_proto::ExecuteSqlRequest& request) mutable
+      [stub, hedging_delay, session_pool, allocate_hedge_session, cq,
+       retry_policy, backoff_policy,
+       make_reader](spanner_proto::ExecuteSqlRequest& request) mutable
       -> StatusOr<std::unique_ptr<ResultSourceInterface>> {
-    auto factory = [stub, request, tracing_enabled,
-                    tracing_options](std::string const& resume_token) mutable {
-      request.set_resume_token(resume_token);
-      auto context =
-          google::cloud::internal::make_unique<grpc::ClientContext>();
-      std::unique_ptr<PartialResultSetReader> reader =
-          google::cloud::internal::make_unique<DefaultPartialResultSetReader>(
-              std::move(context), stub->ExecuteStreamingSql(*context, request));
-      if (tracing_enabled) {
-        reader = google::cloud::internal::make_unique<LoggingResultSetReader>(
-            std::move(reader), tracing_options);
-      }
-      return reader;
-    };
+    auto factory =
+        MakeStreamFactory(request, stub, make_reader, hedging_delay,
+                          session_pool, allocate_hedge_session, cq);
     auto rpc = google::cloud::internal::make_unique<PartialResultSetResume>(
         std::move(factory), Idempotency::kIdempotent, retry_policy->clone(),
         backoff_policy->clone());
@@ -745,33 +915,42 @@ StatusOr<CommitResult> ConnectionImpl::CommitImpl(
 
   spanner_proto::CommitRequest request;
   request.set_session(session->session_name());
+  request.mutable_mutations()->Reserve(
+      static_cast<int>(params.mutations.size()));
   for (auto&& m : params.mutations) {
     *request.add_mutations() = std::move(m).as_proto();
   }
 
+  auto stub = session_pool_->GetStub(*session);
   if (s.selector_case() != spanner_proto::TransactionSelector::kId) {
-    spanner_proto::BeginTransactionRequest begin;
-    begin.set_session(session->session_name());
-    *begin.mutable_options() = s.has_begin() ? s.begin() : s.single_use();
-    auto stub = session_pool_->GetStub(*session);
-    auto response = internal::RetryLoop(
-        retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
-        true,
-        [&stub](grpc::ClientContext& context,
-                spanner_proto::BeginTransactionRequest const& request) {
-          return stub->BeginTransaction(context, request);
-        },
-        begin, __func__);
-    if (!response) {
-      auto status = std::move(response).status();
-      if (internal::IsSessionNotFound(status)) session->set_bad();
-      return status;
+    auto options = s.has_begin() ? s.begin() : s.single_use();
+    if (single_use_commits_) {
+      // The caller accepted that a resent commit may be applied twice, so
+      // the unused transaction is committed without `BeginTransaction`.
+      *request.mutable_single_use_transaction() = std::move(options);
+    } else {
+      spanner_proto::BeginTransactionRequest begin;
+      begin.set_session(session->session_name());
+      *begin.mutable_options() = std::move(options);
+      auto response = internal::RetryLoop(
+          retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
+          true,
+          [&stub](grpc::ClientContext& context,
+                  spanner_proto::BeginTransactionRequest const& request) {
+            return stub->BeginTransaction(context, request);
+          },
+          begin, __func__);
+      if (!response) {
+        auto status = std::move(response).status();
+        if (internal::IsSessionNotFound(status)) session->set_bad();
+        return status;
+      }
+      s.set_id(response->id());
     }
-    s.set_id(response->id());
   }
-  request.set_transaction_id(s.id());
-
-  auto stub = session_pool_->GetStub(*session);
+  if (!request.has_single_use_transaction()) {
+    request.set_transaction_id(s.id());
+  }
   auto response = internal::RetryLoop(
       retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
       true,
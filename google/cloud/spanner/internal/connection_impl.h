@@ -17,11 +17,15 @@
 
 #include "google/cloud/spanner/backoff_policy.h"
 #include "google/cloud/spanner/connection.h"
+#include "google/cloud/spanner/connection_tuning_options.h"
 #include "google/cloud/spanner/database.h"
+#include "google/cloud/spanner/internal/hedged_partial_result_set_reader.h"
 #include "google/cloud/spanner/internal/session.h"
 #include "google/cloud/spanner/internal/session_pool.h"
 #include "google/cloud/spanner/internal/spanner_stub.h"
+#include "google/cloud/spanner/retry_budget.h"
 #include "google/cloud/spanner/retry_policy.h"
+#include "google/cloud/spanner/tracer.h"
 #include "google/cloud/spanner/tracing_options.h"
 #include "google/cloud/spanner/version.h"
 #include "google/cloud/background_threads.h"
@@ -49,6 +53,9 @@ std::unique_ptr<BackoffPolicy> DefaultConnectionBackoffPolicy();
 /**
  * Factory method to construct a `ConnectionImpl`.
  *
+ * If @p stub_factory is set, the session pool uses it to recreate the stubs of
+ * unhealthy channels, see `MakeSessionPool()`.
+ *
  * @note In tests we can use mock stubs and custom (or mock) policies.
  */
 class ConnectionImpl;
@@ -58,7 +65,9 @@ std::shared_ptr<ConnectionImpl> MakeConnection(
     SessionPoolOptions session_pool_options = SessionPoolOptions{},
     std::unique_ptr<RetryPolicy> retry_policy = DefaultConnectionRetryPolicy(),
     std::unique_ptr<BackoffPolicy> backoff_policy =
-        DefaultConnectionBackoffPolicy());
+        DefaultConnectionBackoffPolicy(),
+    SpannerStubFactory stub_factory = {},
+    ConnectionTuningOptions tuning_options = ConnectionTuningOptions{});
 
 /**
  * A concrete `Connection` subclass that uses gRPC to actually talk to a real
@@ -88,16 +97,23 @@ class ConnectionImpl : public Connection {
   friend std::shared_ptr<ConnectionImpl> MakeConnection(
       Database, std::vector<std::shared_ptr<SpannerStub>>,
       ConnectionOptions const&, SessionPoolOptions,
-      std::unique_ptr<RetryPolicy>, std::unique_ptr<BackoffPolicy>);
+      std::unique_ptr<RetryPolicy>, std::unique_ptr<BackoffPolicy>,
+      SpannerStubFactory, ConnectionTuningOptions);
   ConnectionImpl(Database db, std::vector<std::shared_ptr<SpannerStub>> stubs,
                  ConnectionOptions const& options,
                  SessionPoolOptions session_pool_options,
                  std::unique_ptr<RetryPolicy> retry_policy,
-                 std::unique_ptr<BackoffPolicy> backoff_policy);
+                 std::unique_ptr<BackoffPolicy> backoff_policy,
+                 SpannerStubFactory stub_factory,
+                 ConnectionTuningOptions tuning_options);
 
   Status PrepareSession(SessionHolder& session,
                         bool dissociate_from_pool = false);
 
+  /// The delay to hedge a streaming read, `nullptr` if it is not hedged.
+  std::shared_ptr<HedgingDelay> HedgingDelayFor(
+      google::spanner::v1::TransactionSelector const& s) const;
+
   RowStream ReadImpl(SessionHolder& session,
                      google::spanner::v1::TransactionSelector& s,
                      ReadParams params);
@@ -166,12 +182,16 @@ class ConnectionImpl : public Connection {
       google::spanner::v1::ExecuteSqlRequest::QueryMode query_mode);
 
   Database db_;
+  std::shared_ptr<RetryBudget> retry_budget_;
   std::shared_ptr<RetryPolicy const> retry_policy_prototype_;
   std::shared_ptr<BackoffPolicy const> backoff_policy_prototype_;
   std::unique_ptr<BackgroundThreads> background_threads_;
   std::shared_ptr<SessionPool> session_pool_;
   bool rpc_stream_tracing_enabled_ = false;
   TracingOptions tracing_options_;
+  std::shared_ptr<Tracer> tracer_;
+  std::shared_ptr<HedgingDelay> hedging_delay_;
+  bool single_use_commits_;
 };
 
 }  // namespace internal
@@ -15,6 +15,7 @@
 #include "google/cloud/spanner/internal/connection_impl.h"
 #include "google/cloud/spanner/client.h"
 #include "google/cloud/spanner/internal/spanner_stub.h"
+#include "google/cloud/spanner/testing/in_memory_tracer.h"
 #include "google/cloud/spanner/testing/matchers.h"
 #include "google/cloud/spanner/testing/mock_spanner_stub.h"
 #include "google/cloud/internal/make_unique.h"
@@ -24,7 +25,9 @@
 #include <array>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <future>
+#include <mutex>
 #include <string>
 #include <thread>
 #include <vector>
@@ -54,11 +57,13 @@ namespace {
 
 using ::google::cloud::internal::make_unique;
 using ::google::cloud::spanner_testing::HasSessionAndTransactionId;
+using ::google::cloud::spanner_testing::InMemoryTracer;
 using ::google::protobuf::TextFormat;
 using ::testing::_;
 using ::testing::AtLeast;
 using ::testing::ByMove;
 using ::testing::DoAll;
+using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::HasSubstr;
 using ::testing::InSequence;
@@ -133,15 +138,16 @@ spanner_proto::BatchCreateSessionsResponse MakeSessionsResponse(
 // policies would take too long (10 minutes).
 // Other tests can use this method or just call `MakeConnection()` directly.
 std::shared_ptr<Connection> MakeLimitedRetryConnection(
-    Database const& db,
-    std::shared_ptr<spanner_testing::MockSpannerStub> mock) {
+    Database const& db, std::shared_ptr<spanner_testing::MockSpannerStub> mock,
+    ConnectionTuningOptions tuning_options = ConnectionTuningOptions{}) {
   return MakeConnection(
       db, {std::move(mock)}, ConnectionOptions{}, SessionPoolOptions{},
       LimitedErrorCountRetryPolicy(/*maximum_failures=*/2).clone(),
       ExponentialBackoffPolicy(/*initial_delay=*/std::chrono::microseconds(1),
                                /*maximum_delay=*/std::chrono::microseconds(1),
                                /*scaling=*/2.0)
-          .clone());
+          .clone(),
+      /*stub_factory=*/{}, std::move(tuning_options));
 }
 
 class MockGrpcReader
@@ -400,6 +406,130 @@ TEST(ConnectionImplTest, ExecuteQueryGetSessionFailure) {
   }
 }
 
+TEST(ConnectionImplTest, ReadHedgedOnAnotherSession) {
+  using GrpcReader = std::unique_ptr<
+      grpc::ClientReaderInterface<spanner_proto::PartialResultSet>>;
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(
+          Return(ByMove(MakeSessionsResponse({"session-1", "session-2"}))));
+
+  auto db = Database("dummy_project", "dummy_instance", "dummy_database_id");
+  auto conn = MakeConnection(
+      db, {mock}, ConnectionOptions{}, SessionPoolOptions{}.set_min_sessions(2),
+      DefaultConnectionRetryPolicy(), DefaultConnectionBackoffPolicy(),
+      /*stub_factory=*/{},
+      ConnectionTuningOptions{}
+          .set_hedge_percentile(50)
+          .set_hedge_min_delay(std::chrono::milliseconds(1)));
+
+  auto read = [&conn] {
+    std::vector<std::int64_t> values;
+    auto rows =
+        conn->Read({MakeSingleUseTransaction(Transaction::ReadOnlyOptions()),
+                    "table",
+                    KeySet::All(),
+                    {"Number"}});
+    for (auto& row : StreamOf<std::tuple<std::int64_t>>(rows)) {
+      EXPECT_STATUS_OK(row);
+      if (row) values.push_back(std::get<0>(*row));
+    }
+    return values;
+  };
+  auto constexpr kFirst = R"pb(
+    metadata: {
+      row_type: {
+        fields: {
+          name: "Number",
+          type: { code: INT64 }
+        }
+      }
+    }
+    values: { string_value: "1" }
+    resume_token: "resume-after-1"
+  )pb";
+  spanner_proto::PartialResultSet first;
+  ASSERT_TRUE(TextFormat::ParseFromString(kFirst, &first));
+  auto constexpr kSecond = R"pb(
+    values: { string_value: "2" }
+  )pb";
+  spanner_proto::PartialResultSet second;
+  ASSERT_TRUE(TextFormat::ParseFromString(kSecond, &second));
+
+  // The fast reads that pick the delay.
+  EXPECT_CALL(*mock, StreamingRead(_, _))
+      .Times(HedgingDelay::kMinSamples)
+      .WillRepeatedly([&first](grpc::ClientContext&,
+                               spanner_proto::ReadRequest const&) {
+        auto reader = make_unique<MockGrpcReader>();
+        EXPECT_CALL(*reader, Read(_))
+            .WillOnce(DoAll(SetArgPointee<0>(first), Return(true)))
+            .WillOnce(Return(false));
+        EXPECT_CALL(*reader, Finish()).WillOnce(Return(grpc::Status()));
+        return GrpcReader(std::move(reader));
+      });
+  for (std::size_t i = 0; i != HedgingDelay::kMinSamples; ++i) {
+    EXPECT_THAT(read(), ElementsAre(1));
+  }
+
+  // The primary call only fails once the hedge responds, the hedge fails
+  // after its first response, and then the read resumes.
+  std::mutex mu;
+  std::condition_variable cv;
+  bool hedge_responded = false;
+  std::string primary_session;
+  std::string hedge_session;
+  auto primary = make_unique<MockGrpcReader>();
+  EXPECT_CALL(*primary, Read(_))
+      .WillOnce([&](spanner_proto::PartialResultSet*) {
+        std::unique_lock<std::mutex> lk(mu);
+        cv.wait(lk, [&] { return hedge_responded; });
+        return false;
+      })
+      .WillRepeatedly(Return(false));
+  EXPECT_CALL(*primary, Finish())
+      .WillOnce(Return(grpc::Status(grpc::StatusCode::CANCELLED, "lost")));
+  auto hedge = make_unique<MockGrpcReader>();
+  EXPECT_CALL(*hedge, Read(_))
+      .WillOnce([&](spanner_proto::PartialResultSet* response) {
+        *response = first;
+        std::lock_guard<std::mutex> lk(mu);
+        hedge_responded = true;
+        cv.notify_all();
+        return true;
+      })
+      .WillOnce(Return(false));
+  EXPECT_CALL(*hedge, Finish())
+      .WillOnce(
+          Return(grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again")));
+  auto resumed = make_unique<MockGrpcReader>();
+  EXPECT_CALL(*resumed, Read(_))
+      .WillOnce(DoAll(SetArgPointee<0>(second), Return(true)))
+      .WillOnce(Return(false));
+  EXPECT_CALL(*resumed, Finish()).WillOnce(Return(grpc::Status()));
+
+  EXPECT_CALL(*mock, StreamingRead(_, _))
+      .WillOnce([&](grpc::ClientContext&,
+                    spanner_proto::ReadRequest const& request) {
+        primary_session = request.session();
+        return GrpcReader(std::move(primary));
+      })
+      .WillOnce([&](grpc::ClientContext&,
+                    spanner_proto::ReadRequest const& request) {
+        hedge_session = request.session();
+        return GrpcReader(std::move(hedge));
+      })
+      .WillOnce([&](grpc::ClientContext&,
+                    spanner_proto::ReadRequest const& request) {
+        // The resume token is only valid on the session of the hedge.
+        EXPECT_EQ(hedge_session, request.session());
+        EXPECT_EQ("resume-after-1", request.resume_token());
+        return GrpcReader(std::move(resumed));
+      });
+  EXPECT_THAT(read(), ElementsAre(1, 2));
+  EXPECT_NE(primary_session, hedge_session);
+}
+
 TEST(ConnectionImplTest, ExecuteQueryStreamingReadFailure) {
   auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
 
@@ -1470,6 +1600,119 @@ TEST(ConnectionImplTest, CommitCommitTooManyTransientFailures) {
   EXPECT_THAT(commit.status().message(), HasSubstr("uh-oh in Commit"));
 }
 
+TEST(ConnectionImplTest, CommitSingleUseTransaction) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+
+  auto db = Database("dummy_project", "dummy_instance", "dummy_database_id");
+  auto conn = MakeLimitedRetryConnection(
+      db, mock, ConnectionTuningOptions{}.set_single_use_commits(true));
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  EXPECT_CALL(*mock, BeginTransaction(_, _)).Times(0);
+  auto const commit_timestamp =
+      MakeTimestamp(std::chrono::system_clock::from_time_t(123)).value();
+  EXPECT_CALL(*mock, Commit(_, _))
+      .WillOnce([commit_timestamp](
+                    grpc::ClientContext&,
+                    spanner_proto::CommitRequest const& request) {
+        EXPECT_EQ("test-session-name", request.session());
+        EXPECT_TRUE(request.transaction_id().empty());
+        EXPECT_TRUE(request.single_use_transaction().has_read_write());
+        spanner_proto::CommitResponse response;
+        *response.mutable_commit_timestamp() =
+            internal::TimestampToProto(commit_timestamp);
+        return response;
+      });
+
+  auto commit = conn->Commit({MakeReadWriteTransaction()});
+  ASSERT_STATUS_OK(commit);
+  EXPECT_EQ(commit_timestamp, commit->commit_timestamp);
+}
+
+TEST(ConnectionImplTest, CommitSingleUseTransientSuccess) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+
+  auto db = Database("dummy_project", "dummy_instance", "dummy_database_id");
+  auto conn = MakeLimitedRetryConnection(
+      db, mock, ConnectionTuningOptions{}.set_single_use_commits(true));
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  EXPECT_CALL(*mock, BeginTransaction(_, _)).Times(0);
+  // The caller accepted that a resent single-use commit may be applied twice,
+  // so it is retried like a commit by ID.
+  auto const commit_timestamp =
+      MakeTimestamp(std::chrono::system_clock::from_time_t(123)).value();
+  EXPECT_CALL(*mock, Commit(_, _))
+      .WillOnce(Return(Status(StatusCode::kUnavailable, "try-again")))
+      .WillOnce([commit_timestamp](
+                    grpc::ClientContext&,
+                    spanner_proto::CommitRequest const& request) {
+        EXPECT_TRUE(request.single_use_transaction().has_read_write());
+        spanner_proto::CommitResponse response;
+        *response.mutable_commit_timestamp() =
+            internal::TimestampToProto(commit_timestamp);
+        return response;
+      });
+
+  auto commit = conn->Commit({MakeReadWriteTransaction()});
+  ASSERT_STATUS_OK(commit);
+  EXPECT_EQ(commit_timestamp, commit->commit_timestamp);
+}
+
+TEST(ConnectionImplTest, CommitSingleUseSessionNotFound) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto db = Database("dummy_project", "dummy_instance", "dummy_database_id");
+  auto conn = MakeLimitedRetryConnection(
+      db, mock, ConnectionTuningOptions{}.set_single_use_commits(true));
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  EXPECT_CALL(*mock, Commit(_, _))
+      .WillOnce(Return(Status(StatusCode::kNotFound, "Session not found")));
+  auto txn = MakeReadWriteTransaction();
+  auto commit = conn->Commit({txn});
+  EXPECT_FALSE(commit.ok());
+  auto status = commit.status();
+  EXPECT_TRUE(IsSessionNotFound(status)) << status;
+  EXPECT_THAT(txn, HasBadSession());
+}
+
+TEST(ConnectionImplTest, CommitTraced) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto db = Database("dummy_project", "dummy_instance", "dummy_database_id");
+  auto tracer = std::make_shared<InMemoryTracer>();
+  auto conn = MakeConnection(
+      db, {mock}, ConnectionOptions{}, SessionPoolOptions{},
+      LimitedErrorCountRetryPolicy(/*maximum_failures=*/2).clone(),
+      ExponentialBackoffPolicy(/*initial_delay=*/std::chrono::microseconds(1),
+                               /*maximum_delay=*/std::chrono::microseconds(1),
+                               /*scaling=*/2.0)
+          .clone(),
+      /*stub_factory=*/{}, ConnectionTuningOptions{}.set_tracer(tracer));
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({"test-session-name"})));
+  EXPECT_CALL(*mock, Commit(_, _))
+      .WillOnce(Return(Status(StatusCode::kPermissionDenied, "uh-oh")));
+
+  auto txn = MakeReadWriteTransaction();
+  SetTransactionId(txn, "test-txn-id");
+  auto commit = conn->Commit({txn});
+  EXPECT_EQ(StatusCode::kPermissionDenied, commit.status().code());
+
+  EXPECT_THAT(tracer->SpanNames(),
+              ElementsAre("spanner.Commit", "spanner.SessionPool.Allocate",
+                          "spanner.RetryAttempt", "spanner.RetryAttempt"));
+  auto const spans = tracer->Spans();
+  EXPECT_EQ(spanner_testing::SpanData::kNoParent, spans[0].parent);
+  EXPECT_EQ(StatusCode::kPermissionDenied, spans[0].status.code());
+  // The BatchCreateSessions attempt.
+  EXPECT_EQ(1, spans[2].parent);
+  EXPECT_STATUS_OK(spans[2].status);
+  // The Commit attempt.
+  EXPECT_EQ(0, spans[3].parent);
+  EXPECT_EQ(StatusCode::kPermissionDenied, spans[3].status.code());
+  for (auto const& s : spans) EXPECT_TRUE(s.ended) << s.name;
+}
+
 TEST(ConnectionImplTest, CommitCommitIdempotentTransientSuccess) {
   auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
 
@@ -1665,6 +1908,38 @@ TEST(ConnectionImplTest, RollbackTooManyTransientFailures) {
   EXPECT_THAT(rollback.message(), HasSubstr("try-again in Rollback"));
 }
 
+TEST(ConnectionImplTest, RollbackRetryBudgetExhausted) {
+  auto db = Database("project", "instance", "database");
+  std::string const session_name = "test-session-name";
+
+  // With 2 tokens, retries stop once a single call fails.
+  auto budget = std::make_shared<RetryBudget>(2, 0.1);
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(MakeSessionsResponse({session_name})));
+  EXPECT_CALL(*mock, Rollback(_, _))
+      .WillOnce(Return(Status(StatusCode::kUnavailable, "try-again")));
+
+  auto conn = MakeConnection(
+      db, {mock}, ConnectionOptions{}, SessionPoolOptions{},
+      LimitedErrorCountRetryPolicy(/*maximum_failures=*/2).clone(),
+      ExponentialBackoffPolicy(/*initial_delay=*/std::chrono::microseconds(1),
+                               /*maximum_delay=*/std::chrono::microseconds(1),
+                               /*scaling=*/2.0)
+          .clone(),
+      /*stub_factory=*/{}, ConnectionTuningOptions{}.set_retry_budget(budget));
+  auto txn = MakeReadWriteTransaction();
+  SetTransactionId(txn, "test-txn-id");
+  auto rollback = conn->Rollback({txn});
+  EXPECT_EQ(StatusCode::kUnavailable, rollback.code());
+  EXPECT_THAT(rollback.message(), HasSubstr("Retry policy exhausted"));
+
+  auto const metrics = budget->Snapshot();
+  EXPECT_EQ(1, metrics.successes);
+  EXPECT_EQ(1, metrics.failures);
+  EXPECT_EQ(1, metrics.throttled);
+}
+
 TEST(ConnectionImplTest, RollbackSuccess) {
   auto db = Database("project", "instance", "database");
   std::string const session_name = "test-session-name";
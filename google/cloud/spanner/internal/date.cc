@@ -15,6 +15,7 @@
 #include "google/cloud/spanner/internal/date.h"
 #include <array>
 #include <cinttypes>
+#include <cstddef>
 #include <cstdio>
 
 namespace google {
@@ -23,7 +24,51 @@ namespace spanner {
 inline namespace SPANNER_CLIENT_NS {
 namespace internal {
 
+namespace {
+
+constexpr auto kDigits = "0123456789";
+
+inline bool IsDigit(char c) { return static_cast<unsigned>(c - '0') < 10; }
+
+// Parses two digits known to satisfy IsDigit().
+inline int Parse2d(char const* dp) {
+  return (dp[0] - '0') * 10 + (dp[1] - '0');
+}
+
+// The canonical "full-date" rendering for years in [0 .. 9999], with 'd'
+// marking the positions that must hold a digit.
+constexpr char kFixedLayout[] = "dddd-dd-dd";
+constexpr std::size_t kFixedLayoutSize = sizeof(kFixedLayout) - 1;
+
+bool MatchesFixedLayout(std::string const& s) {
+  if (s.size() != kFixedLayoutSize) return false;
+  for (std::size_t i = 0; i != kFixedLayoutSize; ++i) {
+    bool const ok = kFixedLayout[i] == 'd' ? IsDigit(s[i])
+                                           : s[i] == kFixedLayout[i];
+    if (!ok) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
 std::string DateToString(Date d) {
+  auto const year = d.year();
+  if (year >= 0 && year <= 9999) {
+    // The common case: format the fixed-width layout directly.
+    std::array<char, kFixedLayoutSize> buf;
+    buf[0] = kDigits[year / 1000];
+    buf[1] = kDigits[year / 100 % 10];
+    buf[2] = kDigits[year / 10 % 10];
+    buf[3] = kDigits[year % 10];
+    buf[4] = '-';
+    buf[5] = kDigits[d.month() / 10];
+    buf[6] = kDigits[d.month() % 10];
+    buf[7] = '-';
+    buf[8] = kDigits[d.day() / 10];
+    buf[9] = kDigits[d.day() % 10];
+    return std::string(buf.data(), buf.size());
+  }
   std::array<char, sizeof "-9223372036854775808-01-01"> buf;
   std::snprintf(buf.data(), buf.size(), "%04" PRId64 "-%02d-%02d", d.year(),
                 d.month(), d.day());
@@ -34,16 +79,24 @@ StatusOr<Date> DateFromString(std::string const& s) {
   std::int64_t year;
   int month;
   int day;
-  char c;
-  switch (sscanf(s.c_str(), "%" SCNd64 "-%d-%d%c", &year, &month, &day, &c)) {
-    case 3:
-      break;
-    case 4:
-      return Status(StatusCode::kInvalidArgument,
-                    s + ": Extra data after RFC3339 full-date");
-    default:
-      return Status(StatusCode::kInvalidArgument,
-                    s + ": Failed to match RFC3339 full-date");
+  if (MatchesFixedLayout(s)) {
+    // The common case: the fields are at fixed offsets.
+    year = Parse2d(s.data()) * 100 + Parse2d(s.data() + 2);
+    month = Parse2d(s.data() + 5);
+    day = Parse2d(s.data() + 8);
+  } else {
+    char c;
+    switch (
+        sscanf(s.c_str(), "%" SCNd64 "-%d-%d%c", &year, &month, &day, &c)) {
+      case 3:
+        break;
+      case 4:
+        return Status(StatusCode::kInvalidArgument,
+                      s + ": Extra data after RFC3339 full-date");
+      default:
+        return Status(StatusCode::kInvalidArgument,
+                      s + ": Failed to match RFC3339 full-date");
+    }
   }
   Date date(year, month, day);
   if (date.month() != month || date.day() != day) {
@@ -52,6 +52,24 @@ void BM_DateFromString(benchmark::State& state) {
 }
 BENCHMARK(BM_DateFromString);
 
+// Years outside [0 .. 9999] do not use the fixed-width layout, so these
+// measure the general snprintf()/sscanf() paths.
+void BM_DateToStringGeneral(benchmark::State& state) {
+  Date d(12020, 1, 17);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(DateToString(d));
+  }
+}
+BENCHMARK(BM_DateToStringGeneral);
+
+void BM_DateFromStringGeneral(benchmark::State& state) {
+  std::string s = "12020-01-17";
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(DateFromString(s));
+  }
+}
+BENCHMARK(BM_DateFromStringGeneral);
+
 }  // namespace
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
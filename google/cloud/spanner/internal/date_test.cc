@@ -27,10 +27,18 @@ TEST(Date, DateToString) {
   EXPECT_EQ("1066-10-14", DateToString(Date(1066, 10, 14)));
   EXPECT_EQ("0865-03-21", DateToString(Date(865, 3, 21)));
   EXPECT_EQ("0014-08-19", DateToString(Date(14, 8, 19)));
+  EXPECT_EQ("0000-01-01", DateToString(Date(0, 1, 1)));
+  EXPECT_EQ("9999-12-31", DateToString(Date(9999, 12, 31)));
+  EXPECT_EQ("10000-01-01", DateToString(Date(10000, 1, 1)));
+  EXPECT_EQ("-001-12-31", DateToString(Date(-1, 12, 31)));
 }
 
 TEST(Date, DateFromString) {
   EXPECT_EQ(Date(2019, 6, 21), DateFromString("2019-06-21").value());
+  EXPECT_EQ(Date(2020, 2, 29), DateFromString("2020-02-29").value());
+  EXPECT_EQ(Date(0, 1, 1), DateFromString("0000-01-01").value());
+  EXPECT_EQ(Date(10000, 1, 1), DateFromString("10000-01-01").value());
+  EXPECT_EQ(Date(-1, 12, 31), DateFromString("-001-12-31").value());
 }
 
 TEST(Date, DateFromStringFailure) {
@@ -39,6 +47,10 @@ TEST(Date, DateFromStringFailure) {
   EXPECT_FALSE(DateFromString("2018-13-02"));
   EXPECT_FALSE(DateFromString("2019-06-31"));
   EXPECT_FALSE(DateFromString("2019-06-21x"));
+  EXPECT_FALSE(DateFromString("2019-02-29"));
+  EXPECT_FALSE(DateFromString("2019-00-21"));
+  EXPECT_FALSE(DateFromString("2019-06-00"));
+  EXPECT_FALSE(DateFromString("2019/06/21"));
 }
 
 }  // namespace
@@ -0,0 +1,77 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/deadline.h"
+#include <algorithm>
+#include <sstream>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+using Clock = std::chrono::system_clock;
+
+// The deadline of the innermost `ScopedDeadline` on this thread.
+thread_local OperationDeadline current_deadline = NoDeadline();
+
+}  // namespace
+
+OperationDeadline CurrentDeadline() { return current_deadline; }
+
+bool Expired(OperationDeadline const& d, Clock::duration wait) {
+  if (d.deadline == Clock::time_point::max()) return false;
+  return Clock::now() + wait >= d.deadline;
+}
+
+Clock::time_point AttemptDeadline(OperationDeadline const& d) {
+  if (d.attempt_timeout.count() <= 0) return d.deadline;
+  return (std::min)(d.deadline, Clock::now() + d.attempt_timeout);
+}
+
+void SetDeadline(grpc::ClientContext& context, Clock::time_point deadline) {
+  if (deadline == Clock::time_point::max()) return;
+  context.set_deadline(deadline);
+}
+
+Status AttemptStatus(Status const& status, Clock::time_point attempt_deadline,
+                     OperationDeadline const& d) {
+  if (status.code() != StatusCode::kDeadlineExceeded ||
+      attempt_deadline >= d.deadline) {
+    return status;
+  }
+  return Status(StatusCode::kUnavailable, status.message());
+}
+
+Status DeadlineExceededError(char const* location, Status const& last_status) {
+  std::ostringstream os;
+  os << "Operation deadline exceeded in " << location;
+  if (!last_status.ok()) os << ", last error: " << last_status;
+  return Status(StatusCode::kDeadlineExceeded, std::move(os).str());
+}
+
+ScopedDeadline::ScopedDeadline(OperationDeadline const& deadline)
+    : previous_(current_deadline) {
+  current_deadline = deadline;
+}
+
+ScopedDeadline::~ScopedDeadline() { current_deadline = previous_; }
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,103 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_DEADLINE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_DEADLINE_H
+
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/status.h"
+#include <grpcpp/grpcpp.h>
+#include <chrono>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+/// The time budget of an operation, and of each of its RPC attempts.
+struct OperationDeadline {
+  /// When the operation must complete, `time_point::max()` if unbounded.
+  std::chrono::system_clock::time_point deadline;
+  /// The maximum duration of each unary RPC attempt, zero if unbounded.
+  std::chrono::milliseconds attempt_timeout;
+};
+
+/// An `OperationDeadline` with no bounds.
+inline OperationDeadline NoDeadline() {
+  return OperationDeadline{std::chrono::system_clock::time_point::max(),
+                           std::chrono::milliseconds(0)};
+}
+
+/// The deadline of the innermost `ScopedDeadline` on this thread, if any.
+OperationDeadline CurrentDeadline();
+
+/// True if @p d expires within @p wait from now.
+bool Expired(OperationDeadline const& d,
+             std::chrono::system_clock::duration wait =
+                 std::chrono::system_clock::duration::zero());
+
+/**
+ * The deadline of a unary RPC attempt starting now: the attempt timeout, cut
+ * short to fit in the remaining time of the operation.
+ */
+std::chrono::system_clock::time_point AttemptDeadline(
+    OperationDeadline const& d);
+
+/// Set the deadline of @p context, unless @p deadline is unbounded.
+void SetDeadline(grpc::ClientContext& context,
+                 std::chrono::system_clock::time_point deadline);
+
+/**
+ * The status of a failed attempt, as seen by the retry policy.
+ *
+ * An attempt that ran out of its own timeout, before the operation deadline,
+ * can be retried, so its `kDeadlineExceeded` error is reported as
+ * `kUnavailable`.
+ */
+Status AttemptStatus(Status const& status,
+                     std::chrono::system_clock::time_point attempt_deadline,
+                     OperationDeadline const& d);
+
+/// The error returned when an operation runs out of time in @p location.
+Status DeadlineExceededError(char const* location, Status const& last_status);
+
+/**
+ * Makes @p deadline the deadline of this thread until the `ScopedDeadline` is
+ * destroyed.
+ *
+ * Like `ScopedSpan`, this lets `RetryLoop()` and `SessionPool` enforce the
+ * deadline of the operation that calls them without changing their
+ * signatures. Objects of this class must be destroyed in the reverse order
+ * they were created in, on the thread that created them.
+ */
+class ScopedDeadline {
+ public:
+  explicit ScopedDeadline(OperationDeadline const& deadline);
+  ~ScopedDeadline();
+
+  ScopedDeadline(ScopedDeadline const&) = delete;
+  ScopedDeadline& operator=(ScopedDeadline const&) = delete;
+
+ private:
+  OperationDeadline previous_;
+};
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_DEADLINE_H
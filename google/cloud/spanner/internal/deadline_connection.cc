@@ -0,0 +1,108 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/deadline_connection.h"
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+RowStream DeadlineConnection::Read(ReadParams params) {
+  ScopedDeadline deadline(Deadline());
+  return child_->Read(std::move(params));
+}
+
+StatusOr<std::vector<ReadPartition>> DeadlineConnection::PartitionRead(
+    PartitionReadParams params) {
+  ScopedDeadline deadline(Deadline());
+  return child_->PartitionRead(std::move(params));
+}
+
+RowStream DeadlineConnection::ExecuteQuery(SqlParams params) {
+  ScopedDeadline deadline(Deadline());
+  return child_->ExecuteQuery(std::move(params));
+}
+
+StatusOr<DmlResult> DeadlineConnection::ExecuteDml(SqlParams params) {
+  ScopedDeadline deadline(Deadline());
+  return child_->ExecuteDml(std::move(params));
+}
+
+ProfileQueryResult DeadlineConnection::ProfileQuery(SqlParams params) {
+  ScopedDeadline deadline(Deadline());
+  return child_->ProfileQuery(std::move(params));
+}
+
+StatusOr<ProfileDmlResult> DeadlineConnection::ProfileDml(SqlParams params) {
+  ScopedDeadline deadline(Deadline());
+  return child_->ProfileDml(std::move(params));
+}
+
+StatusOr<ExecutionPlan> DeadlineConnection::AnalyzeSql(SqlParams params) {
+  ScopedDeadline deadline(Deadline());
+  return child_->AnalyzeSql(std::move(params));
+}
+
+StatusOr<PartitionedDmlResult> DeadlineConnection::ExecutePartitionedDml(
+    ExecutePartitionedDmlParams params) {
+  ScopedDeadline deadline(Deadline());
+  return child_->ExecutePartitionedDml(std::move(params));
+}
+
+StatusOr<std::vector<QueryPartition>> DeadlineConnection::PartitionQuery(
+    PartitionQueryParams params) {
+  ScopedDeadline deadline(Deadline());
+  return child_->PartitionQuery(std::move(params));
+}
+
+StatusOr<BatchDmlResult> DeadlineConnection::ExecuteBatchDml(
+    ExecuteBatchDmlParams params) {
+  ScopedDeadline deadline(Deadline());
+  return child_->ExecuteBatchDml(std::move(params));
+}
+
+StatusOr<CommitResult> DeadlineConnection::Commit(CommitParams params) {
+  ScopedDeadline deadline(Deadline());
+  return child_->Commit(std::move(params));
+}
+
+Status DeadlineConnection::Rollback(RollbackParams params) {
+  ScopedDeadline deadline(Deadline());
+  return child_->Rollback(std::move(params));
+}
+
+OperationDeadline DeadlineConnection::Deadline() const {
+  auto result = NoDeadline();
+  if (operation_timeout_.count() > 0) {
+    result.deadline = std::chrono::system_clock::now() + operation_timeout_;
+  }
+  result.attempt_timeout = attempt_timeout_;
+  return result;
+}
+
+std::shared_ptr<Connection> MakeDeadlineConnection(
+    std::shared_ptr<Connection> child,
+    std::chrono::milliseconds operation_timeout,
+    std::chrono::milliseconds attempt_timeout) {
+  return std::make_shared<DeadlineConnection>(
+      std::move(child), operation_timeout, attempt_timeout);
+}
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,89 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_DEADLINE_CONNECTION_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_DEADLINE_CONNECTION_H
+
+#include "google/cloud/spanner/connection.h"
+#include "google/cloud/spanner/internal/deadline.h"
+#include "google/cloud/spanner/version.h"
+#include <chrono>
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+/**
+ * A `Connection` decorator that bounds the duration of each operation.
+ *
+ * Each call runs within a `ScopedDeadline`, which expires @p operation_timeout
+ * after the call starts, and limits each unary RPC attempt to
+ * @p attempt_timeout. The deadline is enforced by the retry loops, the
+ * session pool and the streaming reads of the wrapped `Connection`. A zero
+ * timeout leaves that bound unset.
+ *
+ * The deadline of a `Read()` or `ExecuteQuery()` also covers reading the
+ * rows from the returned `RowStream`.
+ */
+class DeadlineConnection : public Connection {
+ public:
+  DeadlineConnection(std::shared_ptr<Connection> child,
+                     std::chrono::milliseconds operation_timeout,
+                     std::chrono::milliseconds attempt_timeout)
+      : child_(std::move(child)),
+        operation_timeout_(operation_timeout),
+        attempt_timeout_(attempt_timeout) {}
+  ~DeadlineConnection() override = default;
+
+  RowStream Read(ReadParams) override;
+  StatusOr<std::vector<ReadPartition>> PartitionRead(
+      PartitionReadParams) override;
+  RowStream ExecuteQuery(SqlParams) override;
+  StatusOr<DmlResult> ExecuteDml(SqlParams) override;
+  ProfileQueryResult ProfileQuery(SqlParams) override;
+  StatusOr<ProfileDmlResult> ProfileDml(SqlParams) override;
+  StatusOr<ExecutionPlan> AnalyzeSql(SqlParams) override;
+  StatusOr<PartitionedDmlResult> ExecutePartitionedDml(
+      ExecutePartitionedDmlParams) override;
+  StatusOr<std::vector<QueryPartition>> PartitionQuery(
+      PartitionQueryParams) override;
+  StatusOr<BatchDmlResult> ExecuteBatchDml(ExecuteBatchDmlParams) override;
+  StatusOr<CommitResult> Commit(CommitParams) override;
+  Status Rollback(RollbackParams) override;
+
+ private:
+  /// The deadline of an operation starting now.
+  OperationDeadline Deadline() const;
+
+  std::shared_ptr<Connection> child_;
+  std::chrono::milliseconds operation_timeout_;
+  std::chrono::milliseconds attempt_timeout_;
+};
+
+/// Wraps @p child in a `DeadlineConnection`.
+std::shared_ptr<Connection> MakeDeadlineConnection(
+    std::shared_ptr<Connection> child,
+    std::chrono::milliseconds operation_timeout,
+    std::chrono::milliseconds attempt_timeout);
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_DEADLINE_CONNECTION_H
@@ -0,0 +1,96 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/deadline_connection.h"
+#include "google/cloud/spanner/mocks/mock_spanner_connection.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <gmock/gmock.h>
+#include <chrono>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::spanner_mocks::MockConnection;
+using ::testing::_;
+using Clock = std::chrono::system_clock;
+
+TEST(DeadlineConnectionTest, SetsDeadline) {
+  auto mock = std::make_shared<MockConnection>();
+  OperationDeadline observed = NoDeadline();
+  EXPECT_CALL(*mock, Commit(_)).WillOnce([&observed](Connection::CommitParams) {
+    observed = CurrentDeadline();
+    return CommitResult{};
+  });
+
+  DeadlineConnection conn(mock, std::chrono::seconds(10),
+                          std::chrono::milliseconds(500));
+  auto const start = Clock::now();
+  auto result = conn.Commit({MakeReadWriteTransaction(), {}});
+  EXPECT_STATUS_OK(result);
+  EXPECT_LE(start + std::chrono::seconds(10), observed.deadline);
+  EXPECT_GE(Clock::now() + std::chrono::seconds(10), observed.deadline);
+  EXPECT_EQ(std::chrono::milliseconds(500), observed.attempt_timeout);
+
+  // The deadline is only set during the call.
+  EXPECT_EQ(Clock::time_point::max(), CurrentDeadline().deadline);
+}
+
+TEST(DeadlineConnectionTest, AttemptTimeoutOnly) {
+  auto mock = std::make_shared<MockConnection>();
+  OperationDeadline observed = NoDeadline();
+  EXPECT_CALL(*mock, Rollback(_))
+      .WillOnce([&observed](Connection::RollbackParams) {
+        observed = CurrentDeadline();
+        return Status();
+      });
+
+  DeadlineConnection conn(mock, std::chrono::milliseconds(0),
+                          std::chrono::milliseconds(500));
+  EXPECT_STATUS_OK(conn.Rollback({MakeReadWriteTransaction()}));
+  EXPECT_EQ(Clock::time_point::max(), observed.deadline);
+  EXPECT_EQ(std::chrono::milliseconds(500), observed.attempt_timeout);
+}
+
+TEST(DeadlineConnectionTest, EachCallGetsItsOwnDeadline) {
+  auto mock = std::make_shared<MockConnection>();
+  std::vector<Clock::time_point> deadlines;
+  EXPECT_CALL(*mock, ExecuteDml(_))
+      .Times(2)
+      .WillRepeatedly([&deadlines](Connection::SqlParams) {
+        deadlines.push_back(CurrentDeadline().deadline);
+        return StatusOr<DmlResult>(Status(StatusCode::kUnavailable, "nope"));
+      });
+
+  DeadlineConnection conn(mock, std::chrono::seconds(10),
+                          std::chrono::milliseconds(0));
+  for (int i = 0; i != 2; ++i) {
+    auto result = conn.ExecuteDml(
+        {MakeReadWriteTransaction(), SqlStatement("UPDATE T SET C = 1")});
+    EXPECT_EQ(StatusCode::kUnavailable, result.status().code());
+  }
+  ASSERT_EQ(2, deadlines.size());
+  EXPECT_LE(deadlines[0], deadlines[1]);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
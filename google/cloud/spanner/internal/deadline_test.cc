@@ -0,0 +1,119 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/deadline.h"
+#include <gmock/gmock.h>
+#include <chrono>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::testing::HasSubstr;
+using Clock = std::chrono::system_clock;
+
+TEST(DeadlineTest, NoDeadline) {
+  auto const d = CurrentDeadline();
+  EXPECT_EQ(Clock::time_point::max(), d.deadline);
+  EXPECT_EQ(0, d.attempt_timeout.count());
+  EXPECT_FALSE(Expired(d));
+  EXPECT_FALSE(Expired(d, std::chrono::hours(24)));
+  EXPECT_EQ(Clock::time_point::max(), AttemptDeadline(d));
+
+  grpc::ClientContext context;
+  auto const unset = context.deadline();
+  SetDeadline(context, AttemptDeadline(d));
+  EXPECT_EQ(unset, context.deadline());
+}
+
+TEST(DeadlineTest, Scoped) {
+  auto const deadline = Clock::now() + std::chrono::seconds(10);
+  {
+    ScopedDeadline outer(
+        OperationDeadline{deadline, std::chrono::milliseconds(100)});
+    EXPECT_EQ(deadline, CurrentDeadline().deadline);
+    {
+      ScopedDeadline inner(NoDeadline());
+      EXPECT_EQ(Clock::time_point::max(), CurrentDeadline().deadline);
+    }
+    EXPECT_EQ(deadline, CurrentDeadline().deadline);
+    EXPECT_EQ(std::chrono::milliseconds(100),
+              CurrentDeadline().attempt_timeout);
+  }
+  EXPECT_EQ(Clock::time_point::max(), CurrentDeadline().deadline);
+}
+
+TEST(DeadlineTest, Expired) {
+  OperationDeadline d{Clock::now() + std::chrono::seconds(10),
+                      std::chrono::milliseconds(0)};
+  EXPECT_FALSE(Expired(d));
+  EXPECT_TRUE(Expired(d, std::chrono::seconds(11)));
+  d.deadline = Clock::now() - std::chrono::milliseconds(1);
+  EXPECT_TRUE(Expired(d));
+}
+
+TEST(DeadlineTest, AttemptDeadline) {
+  auto const deadline = Clock::now() + std::chrono::seconds(10);
+  // Without an attempt timeout, the attempt gets the whole deadline.
+  EXPECT_EQ(deadline, AttemptDeadline(OperationDeadline{
+                          deadline, std::chrono::milliseconds(0)}));
+
+  auto const start = Clock::now();
+  auto actual = AttemptDeadline(
+      OperationDeadline{deadline, std::chrono::milliseconds(100)});
+  EXPECT_LE(start + std::chrono::milliseconds(100), actual);
+  EXPECT_GT(deadline, actual);
+
+  // The attempt shrinks to fit the remaining time.
+  EXPECT_EQ(deadline, AttemptDeadline(OperationDeadline{
+                          deadline, std::chrono::seconds(60)}));
+}
+
+TEST(DeadlineTest, AttemptStatus) {
+  auto const deadline = Clock::now() + std::chrono::seconds(10);
+  OperationDeadline d{deadline, std::chrono::milliseconds(100)};
+  Status timeout(StatusCode::kDeadlineExceeded, "timeout");
+  // The attempt timed out before the operation deadline, it can be retried.
+  auto status = AttemptStatus(timeout, deadline - std::chrono::seconds(1), d);
+  EXPECT_EQ(StatusCode::kUnavailable, status.code());
+  EXPECT_EQ("timeout", status.message());
+  // The operation deadline expired, it cannot be retried.
+  status = AttemptStatus(timeout, deadline, d);
+  EXPECT_EQ(StatusCode::kDeadlineExceeded, status.code());
+  Status other(StatusCode::kPermissionDenied, "uh-oh");
+  status = AttemptStatus(other, deadline - std::chrono::seconds(1), d);
+  EXPECT_EQ(StatusCode::kPermissionDenied, status.code());
+}
+
+TEST(DeadlineTest, DeadlineExceededError) {
+  auto status = DeadlineExceededError("Commit", Status());
+  EXPECT_EQ(StatusCode::kDeadlineExceeded, status.code());
+  EXPECT_EQ("Operation deadline exceeded in Commit", status.message());
+
+  status = DeadlineExceededError(
+      "Commit", Status(StatusCode::kUnavailable, "try-again"));
+  EXPECT_EQ(StatusCode::kDeadlineExceeded, status.code());
+  EXPECT_THAT(status.message(), HasSubstr("Commit"));
+  EXPECT_THAT(status.message(), HasSubstr("try-again"));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
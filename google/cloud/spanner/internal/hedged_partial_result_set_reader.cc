@@ -0,0 +1,194 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/hedged_partial_result_set_reader.h"
+#include "google/cloud/spanner/internal/stub_decorator_utils.h"
+#include "google/cloud/future.h"
+#include <algorithm>
+#include <condition_variable>
+#include <thread>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+// Cancel a call that lost the race, and consume its status.
+void Discard(PartialResultSetReader& reader) {
+  reader.TryCancel();
+  while (reader.Read()) continue;
+  reader.Finish();
+}
+
+/**
+ * The race between a primary call and its hedge.
+ *
+ * The delay timer keeps a reference to this object, so it may outlive the
+ * `HedgedPartialResultSetReader`, but `primary` and `thread` are only used
+ * before the first `Read()` returns.
+ */
+struct HedgeRace {
+  HedgedPartialResultSetReader::HedgeFactory factory;  // GUARDED_BY(mu)
+  PartialResultSetReader* primary = nullptr;
+  TraceContext trace_context;
+  OperationDeadline deadline;
+
+  std::mutex mu;
+  std::condition_variable cv;
+  bool primary_done = false;                               // GUARDED_BY(mu)
+  bool primary_won = false;                                // GUARDED_BY(mu)
+  bool hedge_started = false;                              // GUARDED_BY(mu)
+  bool hedge_done = false;                                 // GUARDED_BY(mu)
+  bool hedge_won = false;                                  // GUARDED_BY(mu)
+  std::chrono::steady_clock::time_point hedge_won_at;      // GUARDED_BY(mu)
+  std::thread thread;                                      // GUARDED_BY(mu)
+  PartialResultSetReader* hedge = nullptr;                 // GUARDED_BY(mu)
+  std::unique_ptr<PartialResultSetReader> finished_hedge;  // GUARDED_BY(mu)
+  optional<google::spanner::v1::PartialResultSet> first;   // GUARDED_BY(mu)
+};
+
+// Start and read the hedge, which runs on its own thread.
+void RunHedge(std::shared_ptr<HedgeRace> const& race,
+              HedgedPartialResultSetReader::HedgeFactory const& factory) {
+  ScopedDeadline deadline(race->deadline);
+  ScopedSpan span(race->trace_context, "spanner.Hedge");
+  auto hedge = factory();
+  std::unique_lock<std::mutex> lk(race->mu);
+  if (!hedge) {
+    span.SetAttribute("won", "false");
+    race->hedge_done = true;
+    race->cv.notify_all();
+    return;
+  }
+  race->hedge = hedge.get();
+  // The primary may have won while the hedge was starting.
+  if (race->primary_won) hedge->TryCancel();
+  lk.unlock();
+
+  auto result = hedge->Read();
+  lk.lock();
+  race->hedge_done = true;
+  race->finished_hedge = std::move(hedge);
+  if (result && !race->primary_won) {
+    race->hedge_won = true;
+    race->hedge_won_at = std::chrono::steady_clock::now();
+    race->first = std::move(result);
+    race->primary->TryCancel();
+  }
+  span.SetAttribute("won", race->hedge_won ? "true" : "false");
+  race->cv.notify_all();
+}
+
+}  // namespace
+
+std::size_t constexpr HedgingDelay::kWindow;
+std::size_t constexpr HedgingDelay::kMinSamples;
+std::size_t constexpr HedgingDelay::kRecomputeInterval;
+
+optional<std::chrono::microseconds> HedgingDelay::Delay() const {
+  std::lock_guard<std::mutex> lk(mu_);
+  return delay_;
+}
+
+void HedgingDelay::Record(std::chrono::microseconds latency) {
+  std::lock_guard<std::mutex> lk(mu_);
+  if (samples_.size() < kWindow) {
+    samples_.push_back(latency);
+  } else {
+    samples_[next_] = latency;
+    next_ = (next_ + 1) % kWindow;
+  }
+  ++recorded_;
+  if (recorded_ < kMinSamples || recorded_ % kRecomputeInterval != 0) return;
+  auto sorted = samples_;
+  auto const index =
+      sorted.size() * static_cast<std::size_t>(config_.percentile) / 100;
+  std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+  delay_ = (std::max)(sorted[index], config_.min_delay);
+}
+
+optional<google::spanner::v1::PartialResultSet>
+HedgedPartialResultSetReader::Read() {
+  if (!first_read_) return winner_->Read();
+  first_read_ = false;
+  return FirstRead();
+}
+
+optional<google::spanner::v1::PartialResultSet>
+HedgedPartialResultSetReader::FirstRead() {
+  auto const start = std::chrono::steady_clock::now();
+  auto const delay = delay_->Delay();
+  if (!delay) {
+    auto result = primary_->Read();
+    if (result) delay_->Record(ElapsedSince(start));
+    return result;
+  }
+
+  auto race = std::make_shared<HedgeRace>();
+  race->factory = std::move(hedge_factory_);
+  race->primary = primary_.get();
+  race->trace_context = trace_context_;
+  race->deadline = deadline_;
+  cq_.MakeRelativeTimer(*delay).then(
+      [race](future<StatusOr<std::chrono::system_clock::time_point>> f) {
+        // The timer fails if the completion queue is shut down.
+        if (!f.get()) return;
+        std::lock_guard<std::mutex> lk(race->mu);
+        if (race->primary_done) return;
+        race->hedge_started = true;
+        race->thread = std::thread(RunHedge, race, std::move(race->factory));
+      });
+
+  auto result = primary_->Read();
+  std::thread hedger;
+  {
+    std::unique_lock<std::mutex> lk(race->mu);
+    race->primary_done = true;
+    if (result && !race->hedge_won) {
+      race->primary_won = true;
+      if (race->hedge != nullptr) race->hedge->TryCancel();
+    }
+    // A primary that failed does not win while the hedge is running.
+    if (!race->primary_won && race->hedge_started) {
+      race->cv.wait(lk, [&] { return race->hedge_done; });
+    }
+    hedger = std::move(race->thread);
+    // Release what an unused factory captured, as the timer may keep `race`
+    // for a while.
+    race->factory = nullptr;
+  }
+  if (hedger.joinable()) hedger.join();
+  hedge_ = std::move(race->finished_hedge);
+
+  if (race->hedge_won) {
+    delay_->Record(std::chrono::duration_cast<std::chrono::microseconds>(
+        race->hedge_won_at - start));
+    Discard(*primary_);
+    winner_ = hedge_.get();
+    if (hedge_won_) hedge_won_();
+    return std::move(race->first);
+  }
+  if (race->primary_won) delay_->Record(ElapsedSince(start));
+  if (hedge_) Discard(*hedge_);
+  return result;
+}
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,151 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_HEDGED_PARTIAL_RESULT_SET_READER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_HEDGED_PARTIAL_RESULT_SET_READER_H
+
+#include "google/cloud/spanner/internal/deadline.h"
+#include "google/cloud/spanner/internal/partial_result_set_reader.h"
+#include "google/cloud/spanner/internal/tracing.h"
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/completion_queue.h"
+#include "google/cloud/optional.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+/// Configure the hedging of streaming reads.
+struct HedgingConfig {
+  /// Hedge the calls slower than this percentile (1 to 99), 0 disables this.
+  std::int64_t percentile;
+  /// Never hedge a call earlier than this.
+  std::chrono::microseconds min_delay;
+};
+
+/**
+ * Tracks the time to the first response of the recent calls, to pick the
+ * delay after which a call is hedged.
+ *
+ * The delay is the configured percentile of the last `kWindow` samples,
+ * recomputed every `kRecomputeInterval` samples. There is no delay, i.e. calls
+ * are not hedged, until `kMinSamples` samples have been recorded.
+ *
+ * This class is thread-safe.
+ */
+class HedgingDelay {
+ public:
+  static std::size_t constexpr kWindow = 256;
+  static std::size_t constexpr kMinSamples = 32;
+  static std::size_t constexpr kRecomputeInterval = 16;
+
+  explicit HedgingDelay(HedgingConfig config) : config_(config) {}
+
+  /// How long to wait for the first response before hedging, if at all.
+  optional<std::chrono::microseconds> Delay() const;
+
+  /**
+   * Record the time to the first response of a call.
+   *
+   * For a hedged call this is the time until either call responded, which is
+   * never shorter than the delay. Recording only the faster hedges would
+   * shorten the delay, and then hedge more and more calls.
+   */
+  void Record(std::chrono::microseconds latency);
+
+ private:
+  HedgingConfig const config_;
+  mutable std::mutex mu_;
+  std::vector<std::chrono::microseconds> samples_;  // GUARDED_BY(mu_)
+  std::size_t next_ = 0;                            // GUARDED_BY(mu_)
+  std::size_t recorded_ = 0;                        // GUARDED_BY(mu_)
+  optional<std::chrono::microseconds> delay_;       // GUARDED_BY(mu_)
+};
+
+/**
+ * A PartialResultSetReader that hedges a slow call with a duplicate.
+ *
+ * If the first response of the @p primary call does not arrive within the
+ * delay picked by @p delay, a second call is started with @p hedge. The first
+ * call to return a response wins, and the other one is cancelled with
+ * `TryCancel()` and finished. All the other responses come from the winner,
+ * and @p hedge_won is called if that is the hedge. A call that fails before
+ * returning a response does not win if the other call is still running.
+ *
+ * The request sent by @p hedge must be safe to send twice, e.g. a read in a
+ * single-use read-only transaction. @p hedge may return `nullptr` to skip the
+ * hedge, e.g. if there is no idle session to send it on. Only the first
+ * response is hedged, so this wraps the first call of a
+ * `PartialResultSetResume`, not the resumed calls.
+ *
+ * The delay runs on a @p cq timer. Only if it fires before the first response
+ * is a thread created to start and read the hedge, and that thread exits
+ * before the first `Read()` returns. The current deadline when this object is
+ * created is also current for @p hedge.
+ */
+class HedgedPartialResultSetReader : public PartialResultSetReader {
+ public:
+  using HedgeFactory = std::function<std::unique_ptr<PartialResultSetReader>()>;
+
+  HedgedPartialResultSetReader(std::unique_ptr<PartialResultSetReader> primary,
+                               HedgeFactory hedge,
+                               std::function<void()> hedge_won,
+                               std::shared_ptr<HedgingDelay> delay,
+                               CompletionQueue cq)
+      : primary_(std::move(primary)),
+        hedge_factory_(std::move(hedge)),
+        hedge_won_(std::move(hedge_won)),
+        delay_(std::move(delay)),
+        cq_(std::move(cq)),
+        trace_context_(CurrentTraceContext()),
+        deadline_(CurrentDeadline()),
+        winner_(primary_.get()) {}
+
+  ~HedgedPartialResultSetReader() override = default;
+
+  void TryCancel() override { winner_->TryCancel(); }
+  optional<google::spanner::v1::PartialResultSet> Read() override;
+  Status Finish() override { return winner_->Finish(); }
+
+ private:
+  optional<google::spanner::v1::PartialResultSet> FirstRead();
+
+  std::unique_ptr<PartialResultSetReader> primary_;
+  HedgeFactory hedge_factory_;
+  std::function<void()> hedge_won_;
+  std::shared_ptr<HedgingDelay> delay_;
+  CompletionQueue cq_;
+  TraceContext trace_context_;
+  OperationDeadline deadline_;
+  std::unique_ptr<PartialResultSetReader> hedge_;
+  PartialResultSetReader* winner_;
+  bool first_read_ = true;
+};
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_HEDGED_PARTIAL_RESULT_SET_READER_H
@@ -0,0 +1,365 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/hedged_partial_result_set_reader.h"
+#include "google/cloud/spanner/testing/mock_partial_result_set_reader.h"
+#include "google/cloud/internal/background_threads_impl.h"
+#include "google/cloud/internal/make_unique.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <gmock/gmock.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+namespace spanner_proto = ::google::spanner::v1;
+
+using ::google::cloud::internal::make_unique;
+using ::google::cloud::spanner_testing::MockPartialResultSetReader;
+using ::testing::AtMost;
+using ::testing::InSequence;
+using ::testing::Return;
+
+using ReadReturn = optional<spanner_proto::PartialResultSet>;
+
+ReadReturn MakeResponse(std::string const& token) {
+  spanner_proto::PartialResultSet response;
+  response.set_resume_token(token);
+  return response;
+}
+
+/// A `HedgingDelay` that hedges the calls after @p delay.
+std::shared_ptr<HedgingDelay> MakeDelay(std::chrono::microseconds delay) {
+  auto result = std::make_shared<HedgingDelay>(
+      HedgingConfig{50, std::chrono::microseconds(0)});
+  for (std::size_t i = 0; i != HedgingDelay::kMinSamples; ++i) {
+    result->Record(delay);
+  }
+  return result;
+}
+
+/// Makes the `Read()` of a mock block until `TryCancel()` is called.
+class Blocker {
+ public:
+  void Cancel() {
+    std::lock_guard<std::mutex> lk(mu_);
+    cancelled_ = true;
+    cv_.notify_all();
+  }
+
+  ReadReturn Wait() {
+    std::unique_lock<std::mutex> lk(mu_);
+    cv_.wait(lk, [this] { return cancelled_; });
+    return {};
+  }
+
+ private:
+  std::mutex mu_;
+  std::condition_variable cv_;
+  bool cancelled_ = false;
+};
+
+TEST(HedgingDelayTest, Percentile) {
+  HedgingDelay delay(HedgingConfig{90, std::chrono::microseconds(5)});
+  for (std::size_t i = 0; i != HedgingDelay::kMinSamples - 1; ++i) {
+    delay.Record(std::chrono::microseconds(i));
+    EXPECT_FALSE(delay.Delay().has_value());
+  }
+  delay.Record(std::chrono::microseconds(HedgingDelay::kMinSamples - 1));
+  ASSERT_TRUE(delay.Delay().has_value());
+  // The 90th percentile of 0 .. 31.
+  EXPECT_EQ(std::chrono::microseconds(28), *delay.Delay());
+
+  // The delay is not recomputed for every sample.
+  delay.Record(std::chrono::microseconds(1000));
+  EXPECT_EQ(std::chrono::microseconds(28), *delay.Delay());
+}
+
+TEST(HedgingDelayTest, MinDelay) {
+  HedgingDelay delay(HedgingConfig{99, std::chrono::microseconds(500)});
+  for (std::size_t i = 0; i != HedgingDelay::kMinSamples; ++i) {
+    delay.Record(std::chrono::microseconds(10));
+  }
+  ASSERT_TRUE(delay.Delay().has_value());
+  EXPECT_EQ(std::chrono::microseconds(500), *delay.Delay());
+}
+
+TEST(HedgingDelayTest, Window) {
+  HedgingDelay delay(HedgingConfig{50, std::chrono::microseconds(0)});
+  for (std::size_t i = 0; i != HedgingDelay::kWindow; ++i) {
+    delay.Record(std::chrono::microseconds(10));
+  }
+  EXPECT_EQ(std::chrono::microseconds(10), *delay.Delay());
+  // Replace the whole window with slower calls.
+  for (std::size_t i = 0; i != HedgingDelay::kWindow; ++i) {
+    delay.Record(std::chrono::microseconds(20));
+  }
+  EXPECT_EQ(std::chrono::microseconds(20), *delay.Delay());
+}
+
+/// A hedge that returns @p tokens, then finishes successfully.
+std::unique_ptr<PartialResultSetReader> MakeHedge(
+    std::vector<std::string> const& tokens) {
+  auto hedge = make_unique<MockPartialResultSetReader>();
+  InSequence sequence;
+  for (auto const& token : tokens) {
+    EXPECT_CALL(*hedge, Read()).WillOnce(Return(MakeResponse(token)));
+  }
+  EXPECT_CALL(*hedge, Read()).WillRepeatedly(Return(ReadReturn{}));
+  EXPECT_CALL(*hedge, Finish()).WillOnce(Return(Status()));
+  return std::unique_ptr<PartialResultSetReader>(std::move(hedge));
+}
+
+TEST(HedgedPartialResultSetReaderTest, NotHedgedUntilWarm) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto delay = std::make_shared<HedgingDelay>(
+      HedgingConfig{50, std::chrono::microseconds(0)});
+  auto primary = make_unique<MockPartialResultSetReader>();
+  EXPECT_CALL(*primary, Read())
+      .WillOnce(Return(MakeResponse("p0")))
+      .WillOnce(Return(ReadReturn{}));
+  EXPECT_CALL(*primary, Finish()).WillOnce(Return(Status()));
+
+  int hedges = 0;
+  HedgedPartialResultSetReader reader(
+      std::move(primary),
+      [&hedges] {
+        ++hedges;
+        return make_unique<MockPartialResultSetReader>();
+      },
+      [] { ADD_FAILURE() << "the hedge should not win"; }, delay,
+      threads.cq());
+  auto response = reader.Read();
+  ASSERT_TRUE(response.has_value());
+  EXPECT_EQ("p0", response->resume_token());
+  EXPECT_FALSE(reader.Read().has_value());
+  EXPECT_STATUS_OK(reader.Finish());
+  EXPECT_EQ(0, hedges);
+}
+
+TEST(HedgedPartialResultSetReaderTest, PrimaryWins) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto primary = make_unique<MockPartialResultSetReader>();
+  EXPECT_CALL(*primary, Read())
+      .WillOnce(Return(MakeResponse("p0")))
+      .WillOnce(Return(ReadReturn{}));
+  EXPECT_CALL(*primary, Finish()).WillOnce(Return(Status()));
+
+  int hedges = 0;
+  HedgedPartialResultSetReader reader(
+      std::move(primary),
+      [&hedges] {
+        ++hedges;
+        return make_unique<MockPartialResultSetReader>();
+      },
+      [] { ADD_FAILURE() << "the hedge should not win"; },
+      MakeDelay(std::chrono::seconds(60)), threads.cq());
+  auto response = reader.Read();
+  ASSERT_TRUE(response.has_value());
+  EXPECT_EQ("p0", response->resume_token());
+  EXPECT_FALSE(reader.Read().has_value());
+  EXPECT_STATUS_OK(reader.Finish());
+  EXPECT_EQ(0, hedges);
+}
+
+TEST(HedgedPartialResultSetReaderTest, HedgeWins) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  Blocker blocker;
+  auto primary = make_unique<MockPartialResultSetReader>();
+  EXPECT_CALL(*primary, Read())
+      .WillOnce([&blocker] { return blocker.Wait(); })
+      .WillRepeatedly(Return(ReadReturn{}));
+  EXPECT_CALL(*primary, TryCancel()).WillRepeatedly([&blocker] {
+    blocker.Cancel();
+  });
+  EXPECT_CALL(*primary, Finish())
+      .WillOnce(Return(Status(StatusCode::kCancelled, "cancelled")));
+
+  int hedge_wins = 0;
+  HedgedPartialResultSetReader reader(
+      std::move(primary), [] { return MakeHedge({"h0", "h1"}); },
+      [&hedge_wins] { ++hedge_wins; }, MakeDelay(std::chrono::milliseconds(1)),
+      threads.cq());
+  auto response = reader.Read();
+  ASSERT_TRUE(response.has_value());
+  EXPECT_EQ("h0", response->resume_token());
+  EXPECT_EQ(1, hedge_wins);
+  response = reader.Read();
+  ASSERT_TRUE(response.has_value());
+  EXPECT_EQ("h1", response->resume_token());
+  EXPECT_FALSE(reader.Read().has_value());
+  EXPECT_STATUS_OK(reader.Finish());
+}
+
+TEST(HedgedPartialResultSetReaderTest, HedgesDoNotShortenTheDelay) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto const initial = std::chrono::milliseconds(1);
+  auto delay = MakeDelay(initial);
+  // Enough hedges, which respond right away, to be most of the samples.
+  for (std::size_t i = 0; i != 2 * HedgingDelay::kMinSamples; ++i) {
+    Blocker blocker;
+    auto primary = make_unique<MockPartialResultSetReader>();
+    EXPECT_CALL(*primary, Read())
+        .WillOnce([&blocker] { return blocker.Wait(); })
+        .WillRepeatedly(Return(ReadReturn{}));
+    EXPECT_CALL(*primary, TryCancel()).WillRepeatedly([&blocker] {
+      blocker.Cancel();
+    });
+    EXPECT_CALL(*primary, Finish())
+        .WillOnce(Return(Status(StatusCode::kCancelled, "cancelled")));
+    HedgedPartialResultSetReader reader(
+        std::move(primary), [] { return MakeHedge({"h0"}); }, [] {}, delay,
+        threads.cq());
+    ASSERT_TRUE(reader.Read().has_value());
+    EXPECT_FALSE(reader.Read().has_value());
+    EXPECT_STATUS_OK(reader.Finish());
+  }
+  // The hedged calls waited for the delay before their first response.
+  ASSERT_TRUE(delay->Delay().has_value());
+  EXPECT_LE(initial, *delay->Delay());
+}
+
+TEST(HedgedPartialResultSetReaderTest, NoIdleSession) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  std::mutex mu;
+  std::condition_variable cv;
+  bool hedge_skipped = false;
+
+  auto primary = make_unique<MockPartialResultSetReader>();
+  EXPECT_CALL(*primary, Read())
+      .WillOnce([&] {
+        std::unique_lock<std::mutex> lk(mu);
+        cv.wait(lk, [&] { return hedge_skipped; });
+        return MakeResponse("p0");
+      })
+      .WillOnce(Return(ReadReturn{}));
+  EXPECT_CALL(*primary, Finish()).WillOnce(Return(Status()));
+
+  HedgedPartialResultSetReader reader(
+      std::move(primary),
+      [&] {
+        std::lock_guard<std::mutex> lk(mu);
+        hedge_skipped = true;
+        cv.notify_all();
+        return std::unique_ptr<PartialResultSetReader>{};
+      },
+      [] { ADD_FAILURE() << "the hedge should not win"; },
+      MakeDelay(std::chrono::milliseconds(1)), threads.cq());
+  auto response = reader.Read();
+  ASSERT_TRUE(response.has_value());
+  EXPECT_EQ("p0", response->resume_token());
+  EXPECT_FALSE(reader.Read().has_value());
+  EXPECT_STATUS_OK(reader.Finish());
+}
+
+TEST(HedgedPartialResultSetReaderTest, FailedPrimaryWaitsForHedge) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  std::mutex mu;
+  std::condition_variable cv;
+  bool hedge_started = false;
+  bool primary_failed = false;
+
+  // The primary fails once the hedge has started, and the hedge only
+  // responds after that.
+  auto primary = make_unique<MockPartialResultSetReader>();
+  EXPECT_CALL(*primary, Read()).WillRepeatedly([&] {
+    std::unique_lock<std::mutex> lk(mu);
+    cv.wait(lk, [&] { return hedge_started; });
+    primary_failed = true;
+    cv.notify_all();
+    return ReadReturn{};
+  });
+  EXPECT_CALL(*primary, TryCancel()).Times(AtMost(2));
+  EXPECT_CALL(*primary, Finish())
+      .WillOnce(Return(Status(StatusCode::kUnavailable, "try-again")));
+
+  HedgedPartialResultSetReader reader(
+      std::move(primary),
+      [&] {
+        {
+          std::lock_guard<std::mutex> lk(mu);
+          hedge_started = true;
+          cv.notify_all();
+        }
+        auto hedge = make_unique<MockPartialResultSetReader>();
+        EXPECT_CALL(*hedge, Read())
+            .WillOnce([&] {
+              std::unique_lock<std::mutex> lk(mu);
+              cv.wait(lk, [&] { return primary_failed; });
+              return MakeResponse("h0");
+            })
+            .WillOnce(Return(ReadReturn{}));
+        EXPECT_CALL(*hedge, Finish()).WillOnce(Return(Status()));
+        return std::unique_ptr<PartialResultSetReader>(std::move(hedge));
+      },
+      [] {}, MakeDelay(std::chrono::milliseconds(1)), threads.cq());
+  auto response = reader.Read();
+  ASSERT_TRUE(response.has_value());
+  EXPECT_EQ("h0", response->resume_token());
+  EXPECT_FALSE(reader.Read().has_value());
+  EXPECT_STATUS_OK(reader.Finish());
+}
+
+TEST(HedgedPartialResultSetReaderTest, BothFail) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  std::mutex mu;
+  std::condition_variable cv;
+  bool hedge_started = false;
+
+  auto primary = make_unique<MockPartialResultSetReader>();
+  EXPECT_CALL(*primary, Read()).WillOnce([&] {
+    std::unique_lock<std::mutex> lk(mu);
+    cv.wait(lk, [&] { return hedge_started; });
+    return ReadReturn{};
+  });
+  EXPECT_CALL(*primary, Finish())
+      .WillOnce(Return(Status(StatusCode::kUnavailable, "primary")));
+
+  HedgedPartialResultSetReader reader(
+      std::move(primary),
+      [&] {
+        {
+          std::lock_guard<std::mutex> lk(mu);
+          hedge_started = true;
+          cv.notify_all();
+        }
+        auto hedge = make_unique<MockPartialResultSetReader>();
+        EXPECT_CALL(*hedge, TryCancel());
+        EXPECT_CALL(*hedge, Read()).WillRepeatedly(Return(ReadReturn{}));
+        EXPECT_CALL(*hedge, Finish())
+            .WillOnce(Return(Status(StatusCode::kUnavailable, "hedge")));
+        return std::unique_ptr<PartialResultSetReader>(std::move(hedge));
+      },
+      [] { ADD_FAILURE() << "the hedge should not win"; },
+      MakeDelay(std::chrono::milliseconds(1)), threads.cq());
+  EXPECT_FALSE(reader.Read().has_value());
+  auto status = reader.Finish();
+  EXPECT_EQ(StatusCode::kUnavailable, status.code());
+  EXPECT_EQ("primary", status.message());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -26,12 +26,15 @@ namespace internal {
 namespace spanner_proto = ::google::spanner::v1;
 
 MetadataSpannerStub::MetadataSpannerStub(std::shared_ptr<SpannerStub> child)
-    : child_(std::move(child)), api_client_header_(ApiClientHeader()) {}
+    : child_(std::move(child)),
+      request_params_key_("x-goog-request-params"),
+      api_client_key_("x-goog-api-client"),
+      api_client_header_(ApiClientHeader()) {}
 
 StatusOr<spanner_proto::Session> MetadataSpannerStub::CreateSession(
     grpc::ClientContext& client_context,
     spanner_proto::CreateSessionRequest const& request) {
-  SetMetadata(client_context, "database=" + request.database());
+  SetMetadata(client_context, "database=", request.database());
   return child_->CreateSession(client_context, request);
 }
 
@@ -39,7 +42,7 @@ StatusOr<spanner_proto::BatchCreateSessionsResponse>
 MetadataSpannerStub::BatchCreateSessions(
     grpc::ClientContext& client_context,
     google::spanner::v1::BatchCreateSessionsRequest const& request) {
-  SetMetadata(client_context, "database=" + request.database());
+  SetMetadata(client_context, "database=", request.database());
   return child_->BatchCreateSessions(client_context, request);
 }
 
@@ -49,14 +52,14 @@ MetadataSpannerStub::AsyncBatchCreateSessions(
     grpc::ClientContext& client_context,
     spanner_proto::BatchCreateSessionsRequest const& request,
     grpc::CompletionQueue* cq) {
-  SetMetadata(client_context, "database=" + request.database());
+  SetMetadata(client_context, "database=", request.database());
   return child_->AsyncBatchCreateSessions(client_context, request, cq);
 }
 
 StatusOr<spanner_proto::Session> MetadataSpannerStub::GetSession(
     grpc::ClientContext& client_context,
     spanner_proto::GetSessionRequest const& request) {
-  SetMetadata(client_context, "name=" + request.name());
+  SetMetadata(client_context, "name=", request.name());
   return child_->GetSession(client_context, request);
 }
 
@@ -66,21 +69,21 @@ MetadataSpannerStub::AsyncGetSession(
     grpc::ClientContext& client_context,
     spanner_proto::GetSessionRequest const& request,
     grpc::CompletionQueue* cq) {
-  SetMetadata(client_context, "name=" + request.name());
+  SetMetadata(client_context, "name=", request.name());
   return child_->AsyncGetSession(client_context, request, cq);
 }
 
 StatusOr<spanner_proto::ListSessionsResponse> MetadataSpannerStub::ListSessions(
     grpc::ClientContext& client_context,
     spanner_proto::ListSessionsRequest const& request) {
-  SetMetadata(client_context, "database=" + request.database());
+  SetMetadata(client_context, "database=", request.database());
   return child_->ListSessions(client_context, request);
 }
 
 Status MetadataSpannerStub::DeleteSession(
     grpc::ClientContext& client_context,
     spanner_proto::DeleteSessionRequest const& request) {
-  SetMetadata(client_context, "name=" + request.name());
+  SetMetadata(client_context, "name=", request.name());
   return child_->DeleteSession(client_context, request);
 }
 
@@ -90,14 +93,14 @@ MetadataSpannerStub::AsyncDeleteSession(
     grpc::ClientContext& client_context,
     spanner_proto::DeleteSessionRequest const& request,
     grpc::CompletionQueue* cq) {
-  SetMetadata(client_context, "name=" + request.name());
+  SetMetadata(client_context, "name=", request.name());
   return child_->AsyncDeleteSession(client_context, request, cq);
 }
 
 StatusOr<spanner_proto::ResultSet> MetadataSpannerStub::ExecuteSql(
     grpc::ClientContext& client_context,
     spanner_proto::ExecuteSqlRequest const& request) {
-  SetMetadata(client_context, "session=" + request.session());
+  SetMetadata(client_context, "session=", request.session());
   return child_->ExecuteSql(client_context, request);
 }
 
@@ -105,7 +108,7 @@ std::unique_ptr<grpc::ClientReaderInterface<spanner_proto::PartialResultSet>>
 MetadataSpannerStub::ExecuteStreamingSql(
     grpc::ClientContext& client_context,
     spanner_proto::ExecuteSqlRequest const& request) {
-  SetMetadata(client_context, "session=" + request.session());
+  SetMetadata(client_context, "session=", request.session());
   return child_->ExecuteStreamingSql(client_context, request);
 }
 
@@ -113,56 +116,63 @@ StatusOr<spanner_proto::ExecuteBatchDmlResponse>
 MetadataSpannerStub::ExecuteBatchDml(
     grpc::ClientContext& client_context,
     spanner_proto::ExecuteBatchDmlRequest const& request) {
-  SetMetadata(client_context, "session=" + request.session());
+  SetMetadata(client_context, "session=", request.session());
   return child_->ExecuteBatchDml(client_context, request);
 }
 
 std::unique_ptr<grpc::ClientReaderInterface<spanner_proto::PartialResultSet>>
 MetadataSpannerStub::StreamingRead(grpc::ClientContext& client_context,
                                    spanner_proto::ReadRequest const& request) {
-  SetMetadata(client_context, "session=" + request.session());
+  SetMetadata(client_context, "session=", request.session());
   return child_->StreamingRead(client_context, request);
 }
 
 StatusOr<spanner_proto::Transaction> MetadataSpannerStub::BeginTransaction(
     grpc::ClientContext& client_context,
     spanner_proto::BeginTransactionRequest const& request) {
-  SetMetadata(client_context, "session=" + request.session());
+  SetMetadata(client_context, "session=", request.session());
   return child_->BeginTransaction(client_context, request);
 }
 
 StatusOr<spanner_proto::CommitResponse> MetadataSpannerStub::Commit(
     grpc::ClientContext& client_context,
     spanner_proto::CommitRequest const& request) {
-  SetMetadata(client_context, "session=" + request.session());
+  SetMetadata(client_context, "session=", request.session());
   return child_->Commit(client_context, request);
 }
 
 Status MetadataSpannerStub::Rollback(
     grpc::ClientContext& client_context,
     spanner_proto::RollbackRequest const& request) {
-  SetMetadata(client_context, "session=" + request.session());
+  SetMetadata(client_context, "session=", request.session());
   return child_->Rollback(client_context, request);
 }
 
 StatusOr<spanner_proto::PartitionResponse> MetadataSpannerStub::PartitionQuery(
     grpc::ClientContext& client_context,
     spanner_proto::PartitionQueryRequest const& request) {
-  SetMetadata(client_context, "session=" + request.session());
+  SetMetadata(client_context, "session=", request.session());
   return child_->PartitionQuery(client_context, request);
 }
 
 StatusOr<spanner_proto::PartitionResponse> MetadataSpannerStub::PartitionRead(
     grpc::ClientContext& client_context,
     spanner_proto::PartitionReadRequest const& request) {
-  SetMetadata(client_context, "session=" + request.session());
+  SetMetadata(client_context, "session=", request.session());
   return child_->PartitionRead(client_context, request);
 }
 
 void MetadataSpannerStub::SetMetadata(grpc::ClientContext& context,
-                                      std::string const& request_params) {
-  context.AddMetadata("x-goog-request-params", request_params);
-  context.AddMetadata("x-goog-api-client", api_client_header_);
+                                      char const* resource,
+                                      std::string const& name) {
+  // Build the routing parameter in a per-thread buffer, which keeps its
+  // capacity between calls, so the only allocations are the copies made by
+  // `AddMetadata()`.
+  static thread_local std::string request_params;
+  request_params.assign(resource);
+  request_params.append(name);
+  context.AddMetadata(request_params_key_, request_params);
+  context.AddMetadata(api_client_key_, api_client_header_);
 }
 
 }  // namespace internal
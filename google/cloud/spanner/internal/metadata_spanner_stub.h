@@ -16,6 +16,8 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_METADATA_SPANNER_STUB_H
 
 #include "google/cloud/spanner/internal/spanner_stub.h"
+#include <memory>
+#include <string>
 
 namespace google {
 namespace cloud {
@@ -94,10 +96,16 @@ class MetadataSpannerStub : public SpannerStub {
       google::spanner::v1::PartitionReadRequest const& request) override;
 
  private:
-  void SetMetadata(grpc::ClientContext& context,
-                   std::string const& request_params);
+  // Adds the routing parameter `<resource><name>` (e.g. `session=<name>`) and
+  // the API client header to @p context.
+  void SetMetadata(grpc::ClientContext& context, char const* resource,
+                   std::string const& name);
 
   std::shared_ptr<SpannerStub> child_;
+  // `AddMetadata()` takes `std::string` keys, keep them instead of creating
+  // them from string literals on each call.
+  std::string const request_params_key_;
+  std::string const api_client_key_;
   std::string api_client_header_;
 };
 
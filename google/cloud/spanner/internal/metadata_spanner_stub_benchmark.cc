@@ -0,0 +1,171 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/metadata_spanner_stub.h"
+#include <benchmark/benchmark.h>
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+namespace spanner_proto = ::google::spanner::v1;
+
+// A stub that does nothing, so the benchmarks measure only the decorators.
+class NullSpannerStub : public SpannerStub {
+ public:
+  NullSpannerStub() = default;
+
+  StatusOr<spanner_proto::Session> CreateSession(
+      grpc::ClientContext&,
+      spanner_proto::CreateSessionRequest const&) override {
+    return spanner_proto::Session{};
+  }
+  StatusOr<spanner_proto::BatchCreateSessionsResponse> BatchCreateSessions(
+      grpc::ClientContext&,
+      spanner_proto::BatchCreateSessionsRequest const&) override {
+    return spanner_proto::BatchCreateSessionsResponse{};
+  }
+  std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+      spanner_proto::BatchCreateSessionsResponse>>
+  AsyncBatchCreateSessions(grpc::ClientContext&,
+                           spanner_proto::BatchCreateSessionsRequest const&,
+                           grpc::CompletionQueue*) override {
+    return nullptr;
+  }
+  StatusOr<spanner_proto::Session> GetSession(
+      grpc::ClientContext&, spanner_proto::GetSessionRequest const&) override {
+    return spanner_proto::Session{};
+  }
+  std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<spanner_proto::Session>>
+  AsyncGetSession(grpc::ClientContext&, spanner_proto::GetSessionRequest const&,
+                  grpc::CompletionQueue*) override {
+    return nullptr;
+  }
+  StatusOr<spanner_proto::ListSessionsResponse> ListSessions(
+      grpc::ClientContext&,
+      spanner_proto::ListSessionsRequest const&) override {
+    return spanner_proto::ListSessionsResponse{};
+  }
+  Status DeleteSession(grpc::ClientContext&,
+                       spanner_proto::DeleteSessionRequest const&) override {
+    return Status();
+  }
+  std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<google::protobuf::Empty>>
+  AsyncDeleteSession(grpc::ClientContext&,
+                     spanner_proto::DeleteSessionRequest const&,
+                     grpc::CompletionQueue*) override {
+    return nullptr;
+  }
+  StatusOr<spanner_proto::ResultSet> ExecuteSql(
+      grpc::ClientContext&, spanner_proto::ExecuteSqlRequest const&) override {
+    return spanner_proto::ResultSet{};
+  }
+  std::unique_ptr<grpc::ClientReaderInterface<spanner_proto::PartialResultSet>>
+  ExecuteStreamingSql(grpc::ClientContext&,
+                      spanner_proto::ExecuteSqlRequest const&) override {
+    return nullptr;
+  }
+  StatusOr<spanner_proto::ExecuteBatchDmlResponse> ExecuteBatchDml(
+      grpc::ClientContext&,
+      spanner_proto::ExecuteBatchDmlRequest const&) override {
+    return spanner_proto::ExecuteBatchDmlResponse{};
+  }
+  std::unique_ptr<grpc::ClientReaderInterface<spanner_proto::PartialResultSet>>
+  StreamingRead(grpc::ClientContext&,
+                spanner_proto::ReadRequest const&) override {
+    return nullptr;
+  }
+  StatusOr<spanner_proto::Transaction> BeginTransaction(
+      grpc::ClientContext&,
+      spanner_proto::BeginTransactionRequest const&) override {
+    return spanner_proto::Transaction{};
+  }
+  StatusOr<spanner_proto::CommitResponse> Commit(
+      grpc::ClientContext&, spanner_proto::CommitRequest const&) override {
+    return spanner_proto::CommitResponse{};
+  }
+  Status Rollback(grpc::ClientContext&,
+                  spanner_proto::RollbackRequest const&) override {
+    return Status();
+  }
+  StatusOr<spanner_proto::PartitionResponse> PartitionQuery(
+      grpc::ClientContext&,
+      spanner_proto::PartitionQueryRequest const&) override {
+    return spanner_proto::PartitionResponse{};
+  }
+  StatusOr<spanner_proto::PartitionResponse> PartitionRead(
+      grpc::ClientContext&,
+      spanner_proto::PartitionReadRequest const&) override {
+    return spanner_proto::PartitionResponse{};
+  }
+};
+
+spanner_proto::ReadRequest MakeReadRequest() {
+  spanner_proto::ReadRequest request;
+  request.set_session(
+      "projects/test-project/instances/test-instance/databases/test-database/"
+      "sessions/test-session-0123456789abcdef");
+  request.set_table("Singers");
+  request.add_columns("SingerId");
+  return request;
+}
+
+// The cost of a call without any decorators, including the `ClientContext`.
+void BM_StubBaseline(benchmark::State& state) {
+  auto stub = std::make_shared<NullSpannerStub>();
+  auto const request = MakeReadRequest();
+  for (auto _ : state) {
+    grpc::ClientContext context;
+    benchmark::DoNotOptimize(stub->StreamingRead(context, request));
+  }
+}
+BENCHMARK(BM_StubBaseline);
+
+// The cost of a call through the `MetadataSpannerStub`.
+void BM_MetadataStubStreamingRead(benchmark::State& state) {
+  auto stub =
+      std::make_shared<MetadataSpannerStub>(std::make_shared<NullSpannerStub>());
+  auto const request = MakeReadRequest();
+  for (auto _ : state) {
+    grpc::ClientContext context;
+    benchmark::DoNotOptimize(stub->StreamingRead(context, request));
+  }
+}
+BENCHMARK(BM_MetadataStubStreamingRead);
+
+// Same as above, with a unary RPC, where `StatusOr<>` adds its own cost.
+void BM_MetadataStubCommit(benchmark::State& state) {
+  auto stub =
+      std::make_shared<MetadataSpannerStub>(std::make_shared<NullSpannerStub>());
+  spanner_proto::CommitRequest request;
+  request.set_session(MakeReadRequest().session());
+  for (auto _ : state) {
+    grpc::ClientContext context;
+    benchmark::DoNotOptimize(stub->Commit(context, request));
+  }
+}
+BENCHMARK(BM_MetadataStubCommit);
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,281 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/metrics_spanner_stub.h"
+#include "google/cloud/spanner/internal/stub_decorator_utils.h"
+#include "google/cloud/grpc_error_delegate.h"
+#include <chrono>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+namespace spanner_proto = ::google::spanner::v1;
+
+using PartialResultSetReader =
+    grpc::ClientReaderInterface<spanner_proto::PartialResultSet>;
+
+std::size_t ResponseBytes(Status const&) { return 0; }
+
+template <typename T>
+std::size_t ResponseBytes(StatusOr<T> const& response) {
+  return response ? response->ByteSizeLong() : 0;
+}
+
+/// Records the metrics of a streaming call as the caller reads it.
+class MetricsStreamReader : public ForwardingStreamReader {
+ public:
+  MetricsStreamReader(std::unique_ptr<PartialResultSetReader> child,
+                      std::shared_ptr<RpcMetrics> metrics, std::size_t method,
+                      std::chrono::steady_clock::time_point start)
+      : ForwardingStreamReader(std::move(child)),
+        metrics_(std::move(metrics)),
+        method_(method),
+        start_(start) {}
+
+  ~MetricsStreamReader() override {
+    if (!finished_) Record(StatusCode::kCancelled);
+  }
+
+  bool Read(spanner_proto::PartialResultSet* response) override {
+    if (!ForwardingStreamReader::Read(response)) return false;
+    metrics_->AddResponseBytes(method_, response->ByteSizeLong());
+    return true;
+  }
+
+  grpc::Status Finish() override {
+    auto status = ForwardingStreamReader::Finish();
+    Record(google::cloud::MakeStatusFromRpcError(status).code());
+    return status;
+  }
+
+ private:
+  void Record(StatusCode code) {
+    finished_ = true;
+    metrics_->Finish(method_, std::chrono::steady_clock::now() - start_, code);
+  }
+
+  std::shared_ptr<RpcMetrics> metrics_;
+  std::size_t method_;
+  std::chrono::steady_clock::time_point start_;
+  bool finished_ = false;
+};
+
+}  // namespace
+
+std::shared_ptr<RpcMetrics> MetricsSpannerStub::MakeRpcMetrics() {
+  return std::make_shared<RpcMetrics>(std::vector<std::string>{
+      "CreateSession",
+      "BatchCreateSessions",
+      "AsyncBatchCreateSessions",
+      "GetSession",
+      "AsyncGetSession",
+      "ListSessions",
+      "DeleteSession",
+      "AsyncDeleteSession",
+      "ExecuteSql",
+      "ExecuteStreamingSql",
+      "ExecuteBatchDml",
+      "StreamingRead",
+      "BeginTransaction",
+      "Commit",
+      "Rollback",
+      "PartitionQuery",
+      "PartitionRead",
+  });
+}
+
+template <typename Request, typename Functor>
+auto MetricsSpannerStub::Unary(Method method, Request const& request,
+                               Functor&& functor) -> decltype(functor()) {
+  auto const start = std::chrono::steady_clock::now();
+  metrics_->Start(method, request.ByteSizeLong());
+  auto response = functor();
+  metrics_->Finish(method, std::chrono::steady_clock::now() - start,
+                   StatusOf(response).code(), ResponseBytes(response));
+  return response;
+}
+
+template <typename Request, typename Functor>
+auto MetricsSpannerStub::Streaming(Method method, Request const& request,
+                                   Functor&& functor) -> decltype(functor()) {
+  auto const start = std::chrono::steady_clock::now();
+  metrics_->Start(method, request.ByteSizeLong());
+  auto reader = functor();
+  if (!reader) {
+    metrics_->Finish(method, std::chrono::steady_clock::now() - start,
+                     StatusCode::kUnknown);
+    return reader;
+  }
+  return std::unique_ptr<PartialResultSetReader>(new MetricsStreamReader(
+      std::move(reader), metrics_, method, start));
+}
+
+StatusOr<spanner_proto::Session> MetricsSpannerStub::CreateSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::CreateSessionRequest const& request) {
+  return Unary(kCreateSession, request, [&] {
+    return child_->CreateSession(client_context, request);
+  });
+}
+
+StatusOr<spanner_proto::BatchCreateSessionsResponse>
+MetricsSpannerStub::BatchCreateSessions(
+    grpc::ClientContext& client_context,
+    spanner_proto::BatchCreateSessionsRequest const& request) {
+  return Unary(kBatchCreateSessions, request, [&] {
+    return child_->BatchCreateSessions(client_context, request);
+  });
+}
+
+std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+    spanner_proto::BatchCreateSessionsResponse>>
+MetricsSpannerStub::AsyncBatchCreateSessions(
+    grpc::ClientContext& client_context,
+    spanner_proto::BatchCreateSessionsRequest const& request,
+    grpc::CompletionQueue* cq) {
+  metrics_->Sent(kAsyncBatchCreateSessions, request.ByteSizeLong());
+  return child_->AsyncBatchCreateSessions(client_context, request, cq);
+}
+
+StatusOr<spanner_proto::Session> MetricsSpannerStub::GetSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::GetSessionRequest const& request) {
+  return Unary(kGetSession, request, [&] {
+    return child_->GetSession(client_context, request);
+  });
+}
+
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<spanner_proto::Session>>
+MetricsSpannerStub::AsyncGetSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::GetSessionRequest const& request,
+    grpc::CompletionQueue* cq) {
+  metrics_->Sent(kAsyncGetSession, request.ByteSizeLong());
+  return child_->AsyncGetSession(client_context, request, cq);
+}
+
+StatusOr<spanner_proto::ListSessionsResponse> MetricsSpannerStub::ListSessions(
+    grpc::ClientContext& client_context,
+    spanner_proto::ListSessionsRequest const& request) {
+  return Unary(kListSessions, request, [&] {
+    return child_->ListSessions(client_context, request);
+  });
+}
+
+Status MetricsSpannerStub::DeleteSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::DeleteSessionRequest const& request) {
+  return Unary(kDeleteSession, request, [&] {
+    return child_->DeleteSession(client_context, request);
+  });
+}
+
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<google::protobuf::Empty>>
+MetricsSpannerStub::AsyncDeleteSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::DeleteSessionRequest const& request,
+    grpc::CompletionQueue* cq) {
+  metrics_->Sent(kAsyncDeleteSession, request.ByteSizeLong());
+  return child_->AsyncDeleteSession(client_context, request, cq);
+}
+
+StatusOr<spanner_proto::ResultSet> MetricsSpannerStub::ExecuteSql(
+    grpc::ClientContext& client_context,
+    spanner_proto::ExecuteSqlRequest const& request) {
+  return Unary(kExecuteSql, request, [&] {
+    return child_->ExecuteSql(client_context, request);
+  });
+}
+
+std::unique_ptr<grpc::ClientReaderInterface<spanner_proto::PartialResultSet>>
+MetricsSpannerStub::ExecuteStreamingSql(
+    grpc::ClientContext& client_context,
+    spanner_proto::ExecuteSqlRequest const& request) {
+  return Streaming(kExecuteStreamingSql, request, [&] {
+    return child_->ExecuteStreamingSql(client_context, request);
+  });
+}
+
+StatusOr<spanner_proto::ExecuteBatchDmlResponse>
+MetricsSpannerStub::ExecuteBatchDml(
+    grpc::ClientContext& client_context,
+    spanner_proto::ExecuteBatchDmlRequest const& request) {
+  return Unary(kExecuteBatchDml, request, [&] {
+    return child_->ExecuteBatchDml(client_context, request);
+  });
+}
+
+std::unique_ptr<grpc::ClientReaderInterface<spanner_proto::PartialResultSet>>
+MetricsSpannerStub::StreamingRead(grpc::ClientContext& client_context,
+                                  spanner_proto::ReadRequest const& request) {
+  return Streaming(kStreamingRead, request, [&] {
+    return child_->StreamingRead(client_context, request);
+  });
+}
+
+StatusOr<spanner_proto::Transaction> MetricsSpannerStub::BeginTransaction(
+    grpc::ClientContext& client_context,
+    spanner_proto::BeginTransactionRequest const& request) {
+  return Unary(kBeginTransaction, request, [&] {
+    return child_->BeginTransaction(client_context, request);
+  });
+}
+
+StatusOr<spanner_proto::CommitResponse> MetricsSpannerStub::Commit(
+    grpc::ClientContext& client_context,
+    spanner_proto::CommitRequest const& request) {
+  return Unary(kCommit, request,
+               [&] { return child_->Commit(client_context, request); });
+}
+
+Status MetricsSpannerStub::Rollback(
+    grpc::ClientContext& client_context,
+    spanner_proto::RollbackRequest const& request) {
+  return Unary(kRollback, request,
+               [&] { return child_->Rollback(client_context, request); });
+}
+
+StatusOr<spanner_proto::PartitionResponse> MetricsSpannerStub::PartitionQuery(
+    grpc::ClientContext& client_context,
+    spanner_proto::PartitionQueryRequest const& request) {
+  return Unary(kPartitionQuery, request, [&] {
+    return child_->PartitionQuery(client_context, request);
+  });
+}
+
+StatusOr<spanner_proto::PartitionResponse> MetricsSpannerStub::PartitionRead(
+    grpc::ClientContext& client_context,
+    spanner_proto::PartitionReadRequest const& request) {
+  return Unary(kPartitionRead, request, [&] {
+    return child_->PartitionRead(client_context, request);
+  });
+}
+
+std::shared_ptr<RpcMetrics> DefaultSpannerRpcMetrics() {
+  static auto const* const kMetrics =
+      new std::shared_ptr<RpcMetrics>(MetricsSpannerStub::MakeRpcMetrics());
+  return *kMetrics;
+}
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,159 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_METRICS_SPANNER_STUB_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_METRICS_SPANNER_STUB_H
+
+#include "google/cloud/spanner/internal/rpc_metrics.h"
+#include "google/cloud/spanner/internal/spanner_stub.h"
+#include "google/cloud/spanner/version.h"
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+/**
+ * A SpannerStub that records per-method metrics for each request.
+ *
+ * Unary calls record their latency, status code and response size when they
+ * return. Streaming calls record the size of each response as it is read, and
+ * their latency and status code when the stream is finished (or destroyed,
+ * which counts as `kCancelled`). The asynchronous calls only record the call
+ * and its request size, their completion is not observed by the stub.
+ */
+class MetricsSpannerStub : public SpannerStub {
+ public:
+  /// The index of each method in the `RpcMetrics`.
+  enum Method {
+    kCreateSession,
+    kBatchCreateSessions,
+    kAsyncBatchCreateSessions,
+    kGetSession,
+    kAsyncGetSession,
+    kListSessions,
+    kDeleteSession,
+    kAsyncDeleteSession,
+    kExecuteSql,
+    kExecuteStreamingSql,
+    kExecuteBatchDml,
+    kStreamingRead,
+    kBeginTransaction,
+    kCommit,
+    kRollback,
+    kPartitionQuery,
+    kPartitionRead,
+    kMethodCount,
+  };
+
+  /// Create `RpcMetrics` for all the methods, named as in `Method`.
+  static std::shared_ptr<RpcMetrics> MakeRpcMetrics();
+
+  MetricsSpannerStub(std::shared_ptr<SpannerStub> child,
+                     std::shared_ptr<RpcMetrics> metrics)
+      : child_(std::move(child)), metrics_(std::move(metrics)) {}
+  ~MetricsSpannerStub() override = default;
+
+  StatusOr<google::spanner::v1::Session> CreateSession(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::CreateSessionRequest const& request) override;
+  StatusOr<google::spanner::v1::BatchCreateSessionsResponse>
+  BatchCreateSessions(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::BatchCreateSessionsRequest const& request) override;
+  std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+      google::spanner::v1::BatchCreateSessionsResponse>>
+  AsyncBatchCreateSessions(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::BatchCreateSessionsRequest const& request,
+      grpc::CompletionQueue* cq) override;
+  StatusOr<google::spanner::v1::Session> GetSession(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::GetSessionRequest const& request) override;
+  std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<google::spanner::v1::Session>>
+  AsyncGetSession(grpc::ClientContext& client_context,
+                  google::spanner::v1::GetSessionRequest const& request,
+                  grpc::CompletionQueue* cq) override;
+  StatusOr<google::spanner::v1::ListSessionsResponse> ListSessions(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::ListSessionsRequest const& request) override;
+  Status DeleteSession(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::DeleteSessionRequest const& request) override;
+  std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<google::protobuf::Empty>>
+  AsyncDeleteSession(grpc::ClientContext& client_context,
+                     google::spanner::v1::DeleteSessionRequest const& request,
+                     grpc::CompletionQueue* cq) override;
+  StatusOr<google::spanner::v1::ResultSet> ExecuteSql(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::ExecuteSqlRequest const& request) override;
+  std::unique_ptr<
+      grpc::ClientReaderInterface<google::spanner::v1::PartialResultSet>>
+  ExecuteStreamingSql(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::ExecuteSqlRequest const& request) override;
+  StatusOr<google::spanner::v1::ExecuteBatchDmlResponse> ExecuteBatchDml(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::ExecuteBatchDmlRequest const& request) override;
+  std::unique_ptr<
+      grpc::ClientReaderInterface<google::spanner::v1::PartialResultSet>>
+  StreamingRead(grpc::ClientContext& client_context,
+                google::spanner::v1::ReadRequest const& request) override;
+  StatusOr<google::spanner::v1::Transaction> BeginTransaction(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::BeginTransactionRequest const& request) override;
+  StatusOr<google::spanner::v1::CommitResponse> Commit(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::CommitRequest const& request) override;
+  Status Rollback(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::RollbackRequest const& request) override;
+  StatusOr<google::spanner::v1::PartitionResponse> PartitionQuery(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::PartitionQueryRequest const& request) override;
+  StatusOr<google::spanner::v1::PartitionResponse> PartitionRead(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::PartitionReadRequest const& request) override;
+
+ private:
+  template <typename Request, typename Functor>
+  auto Unary(Method method, Request const& request, Functor&& functor)
+      -> decltype(functor());
+  template <typename Request, typename Functor>
+  auto Streaming(Method method, Request const& request, Functor&& functor)
+      -> decltype(functor());
+
+  std::shared_ptr<SpannerStub> child_;
+  std::shared_ptr<RpcMetrics> metrics_;
+};
+
+/**
+ * The metrics of the stubs created by `CreateDefaultSpannerStub()`.
+ *
+ * All the stubs in the process share these metrics, call `Snapshot()` to read
+ * them.
+ */
+std::shared_ptr<RpcMetrics> DefaultSpannerRpcMetrics();
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_METRICS_SPANNER_STUB_H
@@ -0,0 +1,189 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/metrics_spanner_stub.h"
+#include "google/cloud/spanner/testing/mock_spanner_stub.h"
+#include "google/cloud/internal/make_unique.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <gmock/gmock.h>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::internal::make_unique;
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::Pair;
+using ::testing::Return;
+namespace spanner_proto = ::google::spanner::v1;
+
+class MockGrpcReader
+    : public ::grpc::ClientReaderInterface<spanner_proto::PartialResultSet> {
+ public:
+  MOCK_METHOD1(Read, bool(spanner_proto::PartialResultSet*));
+  MOCK_METHOD1(NextMessageSize, bool(std::uint32_t*));
+  MOCK_METHOD0(Finish, grpc::Status());
+  MOCK_METHOD0(WaitForInitialMetadata, void());
+};
+
+class MetricsSpannerStubTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    mock_ = std::make_shared<spanner_testing::MockSpannerStub>();
+    metrics_ = MetricsSpannerStub::MakeRpcMetrics();
+  }
+
+  RpcMethodMetrics Metrics(MetricsSpannerStub::Method method) {
+    return metrics_->Snapshot().at(method);
+  }
+
+  std::shared_ptr<spanner_testing::MockSpannerStub> mock_;
+  std::shared_ptr<RpcMetrics> metrics_;
+};
+
+TEST_F(MetricsSpannerStubTest, MethodNames) {
+  auto const snapshot = metrics_->Snapshot();
+  ASSERT_EQ(MetricsSpannerStub::kMethodCount, snapshot.size());
+  EXPECT_EQ("CreateSession",
+            snapshot[MetricsSpannerStub::kCreateSession].method);
+  EXPECT_EQ("PartitionRead",
+            snapshot[MetricsSpannerStub::kPartitionRead].method);
+}
+
+TEST_F(MetricsSpannerStubTest, UnarySuccess) {
+  spanner_proto::Session session;
+  session.set_name("test-session-name");
+  EXPECT_CALL(*mock_, CreateSession(_, _)).WillOnce(Return(session));
+
+  MetricsSpannerStub stub(mock_, metrics_);
+  grpc::ClientContext context;
+  spanner_proto::CreateSessionRequest request;
+  request.set_database("test-database-name");
+  auto response = stub.CreateSession(context, request);
+  EXPECT_STATUS_OK(response);
+
+  auto const m = Metrics(MetricsSpannerStub::kCreateSession);
+  EXPECT_EQ(1, m.calls);
+  EXPECT_EQ(0, m.in_flight);
+  EXPECT_EQ(static_cast<std::int64_t>(request.ByteSizeLong()),
+            m.request_bytes);
+  EXPECT_EQ(static_cast<std::int64_t>(session.ByteSizeLong()),
+            m.response_bytes);
+  EXPECT_THAT(m.status_codes, ElementsAre(Pair(StatusCode::kOk, 1)));
+}
+
+TEST_F(MetricsSpannerStubTest, UnaryFailure) {
+  EXPECT_CALL(*mock_, Rollback(_, _))
+      .WillOnce(Return(Status(StatusCode::kUnavailable, "try-again")));
+
+  MetricsSpannerStub stub(mock_, metrics_);
+  grpc::ClientContext context;
+  auto status = stub.Rollback(context, spanner_proto::RollbackRequest());
+  EXPECT_EQ(StatusCode::kUnavailable, status.code());
+
+  auto const m = Metrics(MetricsSpannerStub::kRollback);
+  EXPECT_EQ(1, m.calls);
+  EXPECT_EQ(0, m.response_bytes);
+  EXPECT_THAT(m.status_codes, ElementsAre(Pair(StatusCode::kUnavailable, 1)));
+}
+
+TEST_F(MetricsSpannerStubTest, Streaming) {
+  spanner_proto::PartialResultSet response;
+  response.set_resume_token("test-resume-token");
+  EXPECT_CALL(*mock_, StreamingRead(_, _))
+      .WillOnce([&response](grpc::ClientContext&,
+                            spanner_proto::ReadRequest const&) {
+        auto reader = make_unique<MockGrpcReader>();
+        EXPECT_CALL(*reader, Read(_))
+            .WillOnce([&response](spanner_proto::PartialResultSet* r) {
+              *r = response;
+              return true;
+            })
+            .WillOnce(Return(false));
+        EXPECT_CALL(*reader, Finish()).WillOnce(Return(grpc::Status()));
+        return reader;
+      });
+
+  MetricsSpannerStub stub(mock_, metrics_);
+  grpc::ClientContext context;
+  auto reader = stub.StreamingRead(context, spanner_proto::ReadRequest());
+  ASSERT_TRUE(reader);
+  spanner_proto::PartialResultSet r;
+  EXPECT_TRUE(reader->Read(&r));
+  EXPECT_FALSE(reader->Read(&r));
+  EXPECT_EQ(1, Metrics(MetricsSpannerStub::kStreamingRead).in_flight);
+  EXPECT_TRUE(reader->Finish().ok());
+
+  auto const m = Metrics(MetricsSpannerStub::kStreamingRead);
+  EXPECT_EQ(1, m.calls);
+  EXPECT_EQ(0, m.in_flight);
+  EXPECT_EQ(static_cast<std::int64_t>(response.ByteSizeLong()),
+            m.response_bytes);
+  EXPECT_THAT(m.status_codes, ElementsAre(Pair(StatusCode::kOk, 1)));
+}
+
+TEST_F(MetricsSpannerStubTest, StreamingNotFinished) {
+  EXPECT_CALL(*mock_, ExecuteStreamingSql(_, _))
+      .WillOnce(
+          [](grpc::ClientContext&, spanner_proto::ExecuteSqlRequest const&) {
+            return make_unique<MockGrpcReader>();
+          });
+
+  MetricsSpannerStub stub(mock_, metrics_);
+  grpc::ClientContext context;
+  auto reader =
+      stub.ExecuteStreamingSql(context, spanner_proto::ExecuteSqlRequest());
+  ASSERT_TRUE(reader);
+  reader.reset();
+
+  auto const m = Metrics(MetricsSpannerStub::kExecuteStreamingSql);
+  EXPECT_EQ(1, m.calls);
+  EXPECT_EQ(0, m.in_flight);
+  EXPECT_THAT(m.status_codes, ElementsAre(Pair(StatusCode::kCancelled, 1)));
+}
+
+TEST_F(MetricsSpannerStubTest, Async) {
+  EXPECT_CALL(*mock_, AsyncGetSession(_, _, _))
+      .WillOnce([](grpc::ClientContext&,
+                   spanner_proto::GetSessionRequest const&,
+                   grpc::CompletionQueue*) {
+        return std::unique_ptr<
+            grpc::ClientAsyncResponseReaderInterface<spanner_proto::Session>>{};
+      });
+
+  MetricsSpannerStub stub(mock_, metrics_);
+  grpc::ClientContext context;
+  grpc::CompletionQueue cq;
+  spanner_proto::GetSessionRequest request;
+  request.set_name("test-session-name");
+  stub.AsyncGetSession(context, request, &cq);
+
+  auto const m = Metrics(MetricsSpannerStub::kAsyncGetSession);
+  EXPECT_EQ(1, m.calls);
+  EXPECT_EQ(0, m.in_flight);
+  EXPECT_EQ(static_cast<std::int64_t>(request.ByteSizeLong()),
+            m.request_bytes);
+  EXPECT_TRUE(m.status_codes.empty());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
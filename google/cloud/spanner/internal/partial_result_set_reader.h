@@ -21,6 +21,7 @@
 #include <google/spanner/v1/spanner.grpc.pb.h>
 #include <google/spanner/v1/spanner.pb.h>
 #include <grpcpp/grpcpp.h>
+#include <cstdint>
 #include <memory>
 
 namespace google {
@@ -44,6 +45,8 @@ class PartialResultSetReader {
   virtual void TryCancel() = 0;
   virtual optional<google::spanner::v1::PartialResultSet> Read() = 0;
   virtual Status Finish() = 0;
+  /// The number of times the stream was resumed, for readers that resume it.
+  virtual std::int64_t Resumes() const { return 0; }
 };
 
 }  // namespace internal
@@ -36,9 +36,18 @@ optional<google::spanner::v1::PartialResultSet> PartialResultSetResume::Read() {
         !retry_policy_prototype_->OnFailure(status)) {
       return {};
     }
-    std::this_thread::sleep_for(backoff_policy_prototype_->OnCompletion());
+    auto const delay = backoff_policy_prototype_->OnCompletion();
+    if (Expired(deadline_, delay)) {
+      last_status_ = DeadlineExceededError("PartialResultSetResume", status);
+      return {};
+    }
+    ScopedSpan span(trace_context_, "spanner.Resume");
+    if (span) span.SetAttribute("error", status.message());
+    std::this_thread::sleep_for(delay);
     last_status_.reset();
+    ScopedDeadline deadline(deadline_);
     child_ = factory_(last_resume_token_);
+    ++resumes_;
   } while (!retry_policy_prototype_->IsExhausted());
   return {};
 }
@@ -16,8 +16,11 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_PARTIAL_RESULT_SET_RESUME_H
 
 #include "google/cloud/spanner/backoff_policy.h"
+#include "google/cloud/spanner/internal/deadline.h"
 #include "google/cloud/spanner/internal/partial_result_set_reader.h"
+#include "google/cloud/spanner/internal/tracing.h"
 #include "google/cloud/spanner/retry_policy.h"
+#include <cstdint>
 #include <functional>
 #include <memory>
 
@@ -38,6 +41,10 @@ enum class Idempotency {
 
 /**
  * A PartialResultSetReader that resumes the streaming RPC on retryable errors.
+ *
+ * The deadline of the current `ScopedDeadline` is captured when the stream
+ * starts, and is current again when @p factory is called to resume it. The
+ * stream is not resumed if the deadline would expire during the backoff.
  */
 class PartialResultSetResume : public PartialResultSetReader {
  public:
@@ -49,6 +56,8 @@ class PartialResultSetResume : public PartialResultSetReader {
         is_idempotent_(is_idempotent),
         retry_policy_prototype_(std::move(retry_policy)),
         backoff_policy_prototype_(std::move(backoff_policy)),
+        trace_context_(CurrentTraceContext()),
+        deadline_(CurrentDeadline()),
         child_(factory_(last_resume_token_)) {}
 
   ~PartialResultSetResume() override = default;
@@ -56,15 +65,21 @@ class PartialResultSetResume : public PartialResultSetReader {
   void TryCancel() override;
   optional<google::spanner::v1::PartialResultSet> Read() override;
   Status Finish() override;
+  std::int64_t Resumes() const override { return resumes_; }
 
  private:
   PartialResultSetReaderFactory factory_;
   Idempotency is_idempotent_;
   std::unique_ptr<RetryPolicy> retry_policy_prototype_;
   std::unique_ptr<BackoffPolicy> backoff_policy_prototype_;
+  // The span of the operation that started the stream, which has usually
+  // returned by the time `Read()` resumes it.
+  TraceContext trace_context_;
+  OperationDeadline deadline_;
   std::string last_resume_token_;
   std::unique_ptr<PartialResultSetReader> child_;
   optional<Status> last_status_;
+  std::int64_t resumes_ = 0;
 };
 
 }  // namespace internal
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "google/cloud/spanner/internal/partial_result_set_resume.h"
+#include "google/cloud/spanner/testing/in_memory_tracer.h"
 #include "google/cloud/spanner/testing/matchers.h"
 #include "google/cloud/spanner/testing/mock_partial_result_set_reader.h"
 #include "google/cloud/spanner/value.h"
@@ -21,6 +22,7 @@
 #include <google/protobuf/text_format.h>
 #include <gmock/gmock.h>
 #include <array>
+#include <chrono>
 #include <cstdint>
 #include <string>
 
@@ -34,11 +36,13 @@ namespace {
 namespace spanner_proto = ::google::spanner::v1;
 
 using ::google::cloud::internal::make_unique;
+using ::google::cloud::spanner_testing::InMemoryTracer;
 using ::google::cloud::spanner_testing::IsProtoEqual;
 using ::google::cloud::spanner_testing::MockPartialResultSetReader;
 using ::google::protobuf::TextFormat;
 using ::testing::_;
 using ::testing::AtLeast;
+using ::testing::ElementsAre;
 using ::testing::HasSubstr;
 using ::testing::Return;
 
@@ -172,6 +176,45 @@ TEST(PartialResultSetResume, SuccessWithRestart) {
   ASSERT_FALSE(v.has_value());
   auto status = reader->Finish();
   EXPECT_STATUS_OK(status);
+  EXPECT_EQ(2, reader->Resumes());
+}
+
+TEST(PartialResultSetResume, TracesResumes) {
+  MockFactory mock_factory;
+  EXPECT_CALL(mock_factory, MakeReader(_))
+      .WillOnce([](std::string const&) {
+        auto mock = make_unique<MockPartialResultSetReader>();
+        EXPECT_CALL(*mock, Read()).WillOnce(Return(ReadReturn{}));
+        EXPECT_CALL(*mock, Finish())
+            .WillOnce(Return(Status(StatusCode::kUnavailable, "try-again")));
+        return mock;
+      })
+      .WillOnce([](std::string const&) {
+        auto mock = make_unique<MockPartialResultSetReader>();
+        EXPECT_CALL(*mock, Read()).WillOnce(Return(ReadReturn{}));
+        EXPECT_CALL(*mock, Finish()).WillOnce(Return(Status()));
+        return mock;
+      });
+
+  auto factory = [&mock_factory](std::string const& token) {
+    return mock_factory.MakeReader(token);
+  };
+  auto tracer = std::make_shared<InMemoryTracer>();
+  std::unique_ptr<PartialResultSetReader> reader;
+  {
+    ScopedSpan root(tracer, "root");
+    reader = MakeTestResume(factory, Idempotency::kIdempotent);
+  }
+  // The stream is resumed after the span that created it ended.
+  auto v = reader->Read();
+  ASSERT_FALSE(v.has_value());
+  EXPECT_STATUS_OK(reader->Finish());
+
+  EXPECT_THAT(tracer->SpanNames(), ElementsAre("root", "spanner.Resume"));
+  auto const spans = tracer->Spans();
+  EXPECT_EQ(0, spans[1].parent);
+  EXPECT_TRUE(spans[1].ended);
+  EXPECT_EQ("try-again", spans[1].attributes.at("error"));
 }
 
 TEST(PartialResultSetResume, PermanentError) {
@@ -295,6 +338,63 @@ TEST(PartialResultSetResume, TooManyTransients) {
   EXPECT_THAT(status.message(), HasSubstr("try-again-N"));
 }
 
+TEST(PartialResultSetResume, ResumesWithDeadline) {
+  auto const deadline =
+      std::chrono::system_clock::now() + std::chrono::seconds(30);
+  MockFactory mock_factory;
+  EXPECT_CALL(mock_factory, MakeReader(_))
+      .WillOnce([](std::string const&) {
+        auto mock = make_unique<MockPartialResultSetReader>();
+        EXPECT_CALL(*mock, Read()).WillOnce(Return(ReadReturn{}));
+        EXPECT_CALL(*mock, Finish())
+            .WillOnce(Return(Status(StatusCode::kUnavailable, "try-again")));
+        return mock;
+      })
+      .WillOnce([deadline](std::string const&) {
+        // The resumed call runs within the deadline of the operation.
+        EXPECT_EQ(deadline, CurrentDeadline().deadline);
+        auto mock = make_unique<MockPartialResultSetReader>();
+        EXPECT_CALL(*mock, Read()).WillOnce(Return(ReadReturn{}));
+        EXPECT_CALL(*mock, Finish()).WillOnce(Return(Status()));
+        return mock;
+      });
+
+  auto factory = [&mock_factory](std::string const& token) {
+    return mock_factory.MakeReader(token);
+  };
+  std::unique_ptr<PartialResultSetReader> reader;
+  {
+    ScopedDeadline scope(
+        OperationDeadline{deadline, std::chrono::milliseconds(0)});
+    reader = MakeTestResume(factory, Idempotency::kIdempotent);
+  }
+  EXPECT_FALSE(reader->Read().has_value());
+  EXPECT_STATUS_OK(reader->Finish());
+}
+
+TEST(PartialResultSetResume, DeadlineExpired) {
+  MockFactory mock_factory;
+  EXPECT_CALL(mock_factory, MakeReader(_)).WillOnce([](std::string const&) {
+    auto mock = make_unique<MockPartialResultSetReader>();
+    EXPECT_CALL(*mock, Read()).WillOnce(Return(ReadReturn{}));
+    EXPECT_CALL(*mock, Finish())
+        .WillOnce(Return(Status(StatusCode::kUnavailable, "try-again")));
+    return mock;
+  });
+
+  auto factory = [&mock_factory](std::string const& token) {
+    return mock_factory.MakeReader(token);
+  };
+  ScopedDeadline scope(OperationDeadline{
+      std::chrono::system_clock::now() - std::chrono::milliseconds(1),
+      std::chrono::milliseconds(0)});
+  auto reader = MakeTestResume(factory, Idempotency::kIdempotent);
+  EXPECT_FALSE(reader->Read().has_value());
+  auto status = reader->Finish();
+  EXPECT_EQ(StatusCode::kDeadlineExceeded, status.code());
+  EXPECT_THAT(status.message(), HasSubstr("try-again"));
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
@@ -15,6 +15,7 @@
 #include "google/cloud/spanner/internal/partial_result_set_source.h"
 #include "google/cloud/spanner/internal/merge_chunk.h"
 #include "google/cloud/log.h"
+#include <algorithm>
 
 namespace google {
 namespace cloud {
@@ -22,6 +23,15 @@ namespace spanner {
 inline namespace SPANNER_CLIENT_NS {
 namespace internal {
 
+namespace {
+
+std::chrono::nanoseconds Elapsed(std::chrono::steady_clock::time_point start,
+                                 std::chrono::steady_clock::time_point end) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+}
+
+}  // namespace
+
 StatusOr<std::unique_ptr<ResultSourceInterface>> PartialResultSetSource::Create(
     std::unique_ptr<PartialResultSetReader> reader) {
   std::unique_ptr<PartialResultSetSource> source(
@@ -69,6 +79,7 @@ StatusOr<Row> PartialResultSetSource::NextRow() {
                   "response metadata is missing row type information");
   }
 
+  auto const assembly_start = Clock::now();
   std::vector<Value> values;
   values.reserve(fields.size());
   auto iter = buffer_.begin();
@@ -77,7 +88,15 @@ StatusOr<Row> PartialResultSetSource::NextRow() {
     ++iter;
   }
   buffer_.erase(buffer_.begin(), iter);
-  return internal::MakeRow(std::move(values), columns_);
+  auto row = internal::MakeRow(std::move(values), columns_);
+  stream_stats_.row_assembly_time += Elapsed(assembly_start, Clock::now());
+  return row;
+}
+
+optional<StreamStats> PartialResultSetSource::ClientStats() const {
+  auto stats = stream_stats_;
+  stats.resumes = reader_->Resumes();
+  return stats;
 }
 
 PartialResultSetSource::~PartialResultSetSource() {
@@ -96,6 +115,7 @@ PartialResultSetSource::~PartialResultSetSource() {
 }
 
 Status PartialResultSetSource::ReadFromStream() {
+  auto const read_start = Clock::now();
   auto result_set = reader_->Read();
   if (!result_set) {
     // Read() returns false for end of stream, whether we read all the data or
@@ -103,6 +123,7 @@ Status PartialResultSetSource::ReadFromStream() {
     finished_ = true;
     return reader_->Finish();
   }
+  RecordResponse(*result_set, read_start, Clock::now());
 
   if (result_set->has_metadata()) {
     // If we got metadata more than once, log it, but use the first one.
@@ -153,7 +174,9 @@ Status PartialResultSetSource::ReadFromStream() {
                     "to merge with prior chunked_value");
     }
     auto& front = new_values[0];
+    auto const merge_start = Clock::now();
     auto merge_status = MergeChunk(*chunk_, std::move(front));
+    stream_stats_.merge_time += Elapsed(merge_start, Clock::now());
     if (!merge_status.ok()) {
       return merge_status;
     }
@@ -180,6 +203,24 @@ Status PartialResultSetSource::ReadFromStream() {
   return {};  // OK
 }
 
+void PartialResultSetSource::RecordResponse(
+    google::spanner::v1::PartialResultSet const& result_set,
+    Clock::time_point read_start, Clock::time_point read_end) {
+  if (stream_stats_.responses == 0) {
+    stream_stats_.time_to_first_response = Elapsed(start_, read_end);
+  } else {
+    auto const gap = Elapsed(read_start, read_end);
+    stream_stats_.total_response_gap += gap;
+    stream_stats_.max_response_gap =
+        (std::max)(stream_stats_.max_response_gap, gap);
+  }
+  auto const bytes = static_cast<std::int64_t>(result_set.ByteSizeLong());
+  ++stream_stats_.responses;
+  stream_stats_.response_bytes += bytes;
+  stream_stats_.max_response_bytes =
+      (std::max)(stream_stats_.max_response_bytes, bytes);
+}
+
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner
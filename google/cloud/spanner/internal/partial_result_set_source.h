@@ -24,6 +24,7 @@
 #include <google/spanner/v1/spanner.grpc.pb.h>
 #include <google/spanner/v1/spanner.pb.h>
 #include <grpcpp/grpcpp.h>
+#include <chrono>
 #include <deque>
 #include <memory>
 
@@ -56,14 +57,22 @@ class PartialResultSetSource : public internal::ResultSourceInterface {
     return stats_;
   }
 
+  optional<StreamStats> ClientStats() const override;
+
  private:
+  using Clock = std::chrono::steady_clock;
+
   explicit PartialResultSetSource(
       std::unique_ptr<PartialResultSetReader> reader)
-      : reader_(std::move(reader)) {}
+      : reader_(std::move(reader)), start_(Clock::now()) {}
 
   Status ReadFromStream();
+  void RecordResponse(google::spanner::v1::PartialResultSet const& result_set,
+                      Clock::time_point read_start, Clock::time_point read_end);
 
   std::unique_ptr<PartialResultSetReader> reader_;
+  Clock::time_point start_;
+  StreamStats stream_stats_{};
   optional<google::spanner::v1::ResultSetMetadata> metadata_;
   optional<google::spanner::v1::ResultSetStats> stats_;
   std::deque<google::protobuf::Value> buffer_;
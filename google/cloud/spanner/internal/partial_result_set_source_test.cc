@@ -21,9 +21,12 @@
 #include "google/cloud/testing_util/assert_ok.h"
 #include <google/protobuf/text_format.h>
 #include <gmock/gmock.h>
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstdint>
 #include <string>
+#include <thread>
 
 namespace google {
 namespace cloud {
@@ -459,6 +462,69 @@ TEST(PartialResultSetSourceTest, ChunkedStringValueWellFormed) {
   EXPECT_THAT((*reader)->NextRow(), IsValidAndEquals(Row{}));
 }
 
+std::int64_t Size(spanner_proto::PartialResultSet const& response) {
+  return static_cast<std::int64_t>(response.ByteSizeLong());
+}
+
+/// @test Verify the client-side statistics about the stream.
+TEST(PartialResultSetSourceTest, ClientStats) {
+  auto grpc_reader = make_unique<MockPartialResultSetReader>();
+  std::array<char const*, 2> text{{
+      R"pb(
+        metadata: {
+          row_type: {
+            fields: {
+              name: "Prose",
+              type: { code: STRING }
+            }
+          }
+        }
+        values: { string_value: "first_chunk" }
+        chunked_value: true
+      )pb",
+      R"pb(
+        values: { string_value: "second_chunk" }
+      )pb",
+  }};
+  std::array<spanner_proto::PartialResultSet, text.size()> response;
+  for (std::size_t i = 0; i != text.size(); ++i) {
+    SCOPED_TRACE("Converting text to proto [" + std::to_string(i) + "]");
+    ASSERT_TRUE(TextFormat::ParseFromString(text[i], &response[i]));
+  }
+  auto constexpr kGap = std::chrono::milliseconds(2);
+  EXPECT_CALL(*grpc_reader, Read())
+      .WillOnce(Return(response[0]))
+      .WillOnce([&] {
+        std::this_thread::sleep_for(kGap);
+        return response[1];
+      })
+      .WillOnce(Return(optional<spanner_proto::PartialResultSet>{}));
+  EXPECT_CALL(*grpc_reader, Finish()).WillOnce(Return(Status()));
+  EXPECT_CALL(*grpc_reader, Resumes()).WillRepeatedly(Return(3));
+
+  auto reader = PartialResultSetSource::Create(std::move(grpc_reader));
+  ASSERT_STATUS_OK(reader);
+  auto stats = (*reader)->ClientStats();
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_EQ(1, stats->responses);
+  EXPECT_EQ(Size(response[0]), stats->response_bytes);
+
+  EXPECT_THAT((*reader)->NextRow(),
+              IsValidAndEquals(MakeTestRow(
+                  {{"Prose", Value("first_chunksecond_chunk")}})));
+  EXPECT_THAT((*reader)->NextRow(), IsValidAndEquals(Row{}));
+
+  stats = (*reader)->ClientStats();
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_EQ(2, stats->responses);
+  EXPECT_EQ(Size(response[0]) + Size(response[1]), stats->response_bytes);
+  EXPECT_EQ((std::max)(Size(response[0]), Size(response[1])),
+            stats->max_response_bytes);
+  EXPECT_GE(stats->max_response_gap, kGap);
+  EXPECT_EQ(stats->max_response_gap, stats->total_response_gap);
+  EXPECT_EQ(3, stats->resumes);
+}
+
 /**
  * @test Verify the behavior when `chunked_value` is set but there are no
  * values in the response.
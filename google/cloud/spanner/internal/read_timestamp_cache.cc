@@ -0,0 +1,159 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/read_timestamp_cache.h"
+#include <algorithm>
+#include <chrono>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+RowStream ReadTimestampCacheConnection::Read(ReadParams params) {
+  auto const route = RouteRead(params.transaction);
+  auto rows = child_->Read(std::move(params));
+  Observe(route, rows.ReadTimestamp());
+  return rows;
+}
+
+StatusOr<std::vector<ReadPartition>>
+ReadTimestampCacheConnection::PartitionRead(PartitionReadParams params) {
+  return child_->PartitionRead(std::move(params));
+}
+
+RowStream ReadTimestampCacheConnection::ExecuteQuery(SqlParams params) {
+  auto const route = RouteRead(params.transaction);
+  auto rows = child_->ExecuteQuery(std::move(params));
+  Observe(route, rows.ReadTimestamp());
+  return rows;
+}
+
+StatusOr<DmlResult> ReadTimestampCacheConnection::ExecuteDml(SqlParams params) {
+  return child_->ExecuteDml(std::move(params));
+}
+
+ProfileQueryResult ReadTimestampCacheConnection::ProfileQuery(
+    SqlParams params) {
+  return child_->ProfileQuery(std::move(params));
+}
+
+StatusOr<ProfileDmlResult> ReadTimestampCacheConnection::ProfileDml(
+    SqlParams params) {
+  return child_->ProfileDml(std::move(params));
+}
+
+StatusOr<ExecutionPlan> ReadTimestampCacheConnection::AnalyzeSql(
+    SqlParams params) {
+  return child_->AnalyzeSql(std::move(params));
+}
+
+StatusOr<PartitionedDmlResult>
+ReadTimestampCacheConnection::ExecutePartitionedDml(
+    ExecutePartitionedDmlParams params) {
+  return child_->ExecutePartitionedDml(std::move(params));
+}
+
+StatusOr<std::vector<QueryPartition>>
+ReadTimestampCacheConnection::PartitionQuery(PartitionQueryParams params) {
+  return child_->PartitionQuery(std::move(params));
+}
+
+StatusOr<BatchDmlResult> ReadTimestampCacheConnection::ExecuteBatchDml(
+    ExecuteBatchDmlParams params) {
+  return child_->ExecuteBatchDml(std::move(params));
+}
+
+StatusOr<CommitResult> ReadTimestampCacheConnection::Commit(
+    CommitParams params) {
+  return child_->Commit(std::move(params));
+}
+
+Status ReadTimestampCacheConnection::Rollback(RollbackParams params) {
+  return child_->Rollback(std::move(params));
+}
+
+optional<Timestamp> ReadTimestampCacheConnection::cached_read_timestamp() {
+  std::lock_guard<std::mutex> lk(mu_);
+  return cached_;
+}
+
+constexpr std::chrono::seconds ReadTimestampCacheConnection::kMaxCacheAge;
+
+ReadTimestampCacheConnection::Route ReadTimestampCacheConnection::RouteRead(
+    Transaction& transaction) {
+  // Inspect the options without visiting the transaction, which would use a
+  // sequence number, and could wait for another visitor.
+  auto const options = SingleUseOptions(transaction);
+  if (!options || !options->has_read_only()) return Route::kUnchanged;
+  auto const& ro = options->read_only();
+  if (!ro.has_min_read_timestamp() && !ro.has_max_staleness()) {
+    return Route::kUnchanged;
+  }
+
+  // Whatever the bound, do not read at timestamps older than `kMaxCacheAge`.
+  std::chrono::system_clock::duration staleness = kMaxCacheAge;
+  if (ro.has_max_staleness()) {
+    staleness = (std::min)(
+        staleness,
+        std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::seconds(ro.max_staleness().seconds()) +
+            std::chrono::nanoseconds(ro.max_staleness().nanos())));
+  }
+  auto const now = clock_->Now();
+  // The oldest read timestamp the read accepts, and the timestamp before
+  // which the cache should be refreshed.
+  auto oldest = MakeTimestamp(now - staleness);
+  auto refresh_before = MakeTimestamp(now - staleness / 2);
+  if (!oldest || !refresh_before) return Route::kUnchanged;
+  if (ro.has_min_read_timestamp()) {
+    oldest = (std::max)(*oldest, TimestampFromProto(ro.min_read_timestamp()));
+  }
+
+  std::unique_lock<std::mutex> lk(mu_);
+  if (!cached_ || *cached_ < *oldest) return Route::kNegotiate;
+  if (*cached_ < *refresh_before && !refreshing_) {
+    refreshing_ = true;
+    return Route::kRefresh;
+  }
+  auto const read_timestamp = *cached_;
+  lk.unlock();
+  transaction = MakeSingleUseTransaction(Transaction::SingleUseOptions(
+      Transaction::ReadOnlyOptions(read_timestamp)));
+  return Route::kCached;
+}
+
+void ReadTimestampCacheConnection::Observe(Route route,
+                                           optional<Timestamp> read_timestamp) {
+  // Any read-only read returns a timestamp that is valid for later reads, but
+  // the reads at the cached timestamp cannot advance it.
+  if (route == Route::kCached) return;
+  std::lock_guard<std::mutex> lk(mu_);
+  if (route == Route::kRefresh) refreshing_ = false;
+  if (read_timestamp && (!cached_ || *cached_ < *read_timestamp)) {
+    cached_ = *read_timestamp;
+  }
+}
+
+std::shared_ptr<Connection> MakeReadTimestampCacheConnection(
+    std::shared_ptr<Connection> child) {
+  return std::make_shared<ReadTimestampCacheConnection>(std::move(child));
+}
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
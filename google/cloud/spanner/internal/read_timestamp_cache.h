@@ -0,0 +1,116 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_READ_TIMESTAMP_CACHE_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_READ_TIMESTAMP_CACHE_H
+
+#include "google/cloud/spanner/connection.h"
+#include "google/cloud/spanner/internal/clock.h"
+#include "google/cloud/spanner/timestamp.h"
+#include "google/cloud/spanner/transaction.h"
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/optional.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+/**
+ * A `Connection` decorator that serves bounded-staleness reads from a cached
+ * read timestamp.
+ *
+ * A single-use read or query with a bounded-staleness timestamp bound makes
+ * Spanner choose (negotiate) a read timestamp. This decorator remembers the
+ * newest read timestamp returned by the read-only reads and queries through
+ * it, and if that timestamp satisfies the bound of a later bounded-staleness
+ * read, sends the read as an exact-timestamp read instead, which any replica
+ * can serve without negotiation.
+ *
+ * Every bound is also capped at `kMaxCacheAge`, so the cached timestamp is
+ * never older than that, even for a `min_read_timestamp` bound it satisfies
+ * forever. Spanner garbage collects old versions, and a read at a timestamp
+ * older than that fails with `kFailedPrecondition`.
+ *
+ * Once the cached timestamp is older than half of a read's (capped)
+ * staleness, one read at a time is still sent with its original bound, and
+ * its read timestamp refreshes the cache. The other reads keep using the
+ * cached timestamp meanwhile.
+ *
+ * @note The bound is checked against the local clock, so clock skew between
+ *     the client and Spanner shifts the effective staleness by that amount.
+ */
+class ReadTimestampCacheConnection : public Connection {
+ public:
+  /// The maximum age of a cached read timestamp that is used for a read.
+  static constexpr std::chrono::seconds kMaxCacheAge{60};
+
+  explicit ReadTimestampCacheConnection(
+      std::shared_ptr<Connection> child,
+      std::shared_ptr<SystemClock> clock = std::make_shared<SystemClock>())
+      : child_(std::move(child)), clock_(std::move(clock)) {}
+  ~ReadTimestampCacheConnection() override = default;
+
+  RowStream Read(ReadParams) override;
+  StatusOr<std::vector<ReadPartition>> PartitionRead(
+      PartitionReadParams) override;
+  RowStream ExecuteQuery(SqlParams) override;
+  StatusOr<DmlResult> ExecuteDml(SqlParams) override;
+  ProfileQueryResult ProfileQuery(SqlParams) override;
+  StatusOr<ProfileDmlResult> ProfileDml(SqlParams) override;
+  StatusOr<ExecutionPlan> AnalyzeSql(SqlParams) override;
+  StatusOr<PartitionedDmlResult> ExecutePartitionedDml(
+      ExecutePartitionedDmlParams) override;
+  StatusOr<std::vector<QueryPartition>> PartitionQuery(
+      PartitionQueryParams) override;
+  StatusOr<BatchDmlResult> ExecuteBatchDml(ExecuteBatchDmlParams) override;
+  StatusOr<CommitResult> Commit(CommitParams) override;
+  Status Rollback(RollbackParams) override;
+
+  /// The newest read timestamp observed, if any.
+  optional<Timestamp> cached_read_timestamp();
+
+ private:
+  enum class Route {
+    kUnchanged,  // not a bounded-staleness single-use read, sent as is
+    kCached,     // rewritten to read at the cached timestamp
+    kNegotiate,  // sent with its bound, will update the cache
+    kRefresh,    // like kNegotiate, and the designated refresh
+  };
+
+  Route RouteRead(Transaction& transaction);
+  void Observe(Route route, optional<Timestamp> read_timestamp);
+
+  std::shared_ptr<Connection> child_;
+  std::shared_ptr<SystemClock> clock_;
+  std::mutex mu_;
+  optional<Timestamp> cached_;  // GUARDED_BY(mu_)
+  bool refreshing_ = false;     // GUARDED_BY(mu_)
+};
+
+/// Wraps @p child in a `ReadTimestampCacheConnection`.
+std::shared_ptr<Connection> MakeReadTimestampCacheConnection(
+    std::shared_ptr<Connection> child);
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_READ_TIMESTAMP_CACHE_H
@@ -0,0 +1,217 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/read_timestamp_cache.h"
+#include "google/cloud/spanner/mocks/mock_spanner_connection.h"
+#include "google/cloud/spanner/testing/fake_clock.h"
+#include "google/cloud/internal/make_unique.h"
+#include <gmock/gmock.h>
+#include <chrono>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+namespace spanner_proto = ::google::spanner::v1;
+
+using ::google::cloud::internal::make_unique;
+using ::google::cloud::spanner_mocks::MockConnection;
+using ::google::cloud::spanner_mocks::MockResultSetSource;
+using ::testing::_;
+using ::testing::Return;
+
+Timestamp SecondsAgo(int seconds) {
+  return MakeTimestamp(std::chrono::system_clock::now() -
+                       std::chrono::seconds(seconds))
+      .value();
+}
+
+// An empty result, whose metadata reports @p read_timestamp.
+RowStream MakeRows(Timestamp read_timestamp) {
+  spanner_proto::ResultSetMetadata metadata;
+  *metadata.mutable_transaction()->mutable_read_timestamp() =
+      TimestampToProto(read_timestamp);
+  auto source = make_unique<MockResultSetSource>();
+  EXPECT_CALL(*source, Metadata()).WillRepeatedly(Return(metadata));
+  EXPECT_CALL(*source, NextRow()).WillRepeatedly(Return(Row()));
+  return RowStream(std::move(source));
+}
+
+spanner_proto::TransactionSelector Selector(Transaction txn) {
+  return Visit(std::move(txn),
+               [](SessionHolder&, spanner_proto::TransactionSelector& s,
+                  std::int64_t) { return s; });
+}
+
+Connection::ReadParams MakeReadParams(Transaction::SingleUseOptions opts) {
+  return {MakeSingleUseTransaction(std::move(opts)), "table", KeySet::All(),
+          {"column"}, ReadOptions{}, {}};
+}
+
+TEST(ReadTimestampCacheTest, ServesBoundedReadsFromCache) {
+  auto mock = std::make_shared<MockConnection>();
+  auto const observed = SecondsAgo(1);
+  std::vector<spanner_proto::TransactionSelector> selectors;
+  EXPECT_CALL(*mock, Read(_))
+      .WillRepeatedly([&](Connection::ReadParams const& p) {
+        selectors.push_back(Selector(p.transaction));
+        return MakeRows(observed);
+      });
+
+  ReadTimestampCacheConnection conn(mock);
+  auto const bounded = Transaction::SingleUseOptions(std::chrono::minutes(1));
+  conn.Read(MakeReadParams(bounded));
+  ASSERT_TRUE(conn.cached_read_timestamp().has_value());
+  EXPECT_EQ(observed, *conn.cached_read_timestamp());
+  conn.Read(MakeReadParams(bounded));
+
+  ASSERT_EQ(2, selectors.size());
+  // The first read negotiates its timestamp, the second uses the cache.
+  EXPECT_TRUE(selectors[0].single_use().read_only().has_max_staleness());
+  auto const& cached = selectors[1].single_use().read_only();
+  ASSERT_TRUE(cached.has_read_timestamp());
+  EXPECT_EQ(observed, TimestampFromProto(cached.read_timestamp()));
+}
+
+TEST(ReadTimestampCacheTest, IgnoresTooStaleCache) {
+  auto mock = std::make_shared<MockConnection>();
+  std::vector<spanner_proto::TransactionSelector> selectors;
+  EXPECT_CALL(*mock, ExecuteQuery(_))
+      .WillRepeatedly([&](Connection::SqlParams const& p) {
+        selectors.push_back(Selector(p.transaction));
+        return MakeRows(SecondsAgo(30));
+      });
+
+  ReadTimestampCacheConnection conn(mock);
+  auto const query = [&conn](Transaction::SingleUseOptions opts) {
+    conn.ExecuteQuery({MakeSingleUseTransaction(std::move(opts)),
+                       SqlStatement("SELECT 1"),
+                       QueryOptions{},
+                       {}});
+  };
+  // A strong read also provides a usable timestamp.
+  query(Transaction::ReadOnlyOptions());
+  query(Transaction::SingleUseOptions(std::chrono::seconds(10)));
+  query(Transaction::SingleUseOptions(SecondsAgo(10)));
+
+  ASSERT_EQ(3, selectors.size());
+  EXPECT_TRUE(selectors[0].single_use().read_only().strong());
+  EXPECT_TRUE(selectors[1].single_use().read_only().has_max_staleness());
+  EXPECT_TRUE(selectors[2].single_use().read_only().has_min_read_timestamp());
+}
+
+TEST(ReadTimestampCacheTest, RefreshesAgingCache) {
+  auto mock = std::make_shared<MockConnection>();
+  auto const old_timestamp = SecondsAgo(40);
+  auto const new_timestamp = SecondsAgo(1);
+  std::vector<spanner_proto::TransactionSelector> selectors;
+  EXPECT_CALL(*mock, Read(_))
+      .WillOnce([&](Connection::ReadParams const& p) {
+        selectors.push_back(Selector(p.transaction));
+        return MakeRows(old_timestamp);
+      })
+      .WillRepeatedly([&](Connection::ReadParams const& p) {
+        selectors.push_back(Selector(p.transaction));
+        return MakeRows(new_timestamp);
+      });
+
+  ReadTimestampCacheConnection conn(mock);
+  auto const bounded = Transaction::SingleUseOptions(std::chrono::minutes(1));
+  conn.Read(MakeReadParams(bounded));  // negotiates, caches `old_timestamp`
+  conn.Read(MakeReadParams(bounded));  // refreshes, older than 30s
+  conn.Read(MakeReadParams(bounded));  // uses `new_timestamp`
+
+  ASSERT_EQ(3, selectors.size());
+  EXPECT_TRUE(selectors[1].single_use().read_only().has_max_staleness());
+  auto const& cached = selectors[2].single_use().read_only();
+  ASSERT_TRUE(cached.has_read_timestamp());
+  EXPECT_EQ(new_timestamp, TimestampFromProto(cached.read_timestamp()));
+}
+
+TEST(ReadTimestampCacheTest, RefreshesMinReadTimestampCache) {
+  auto clock = std::make_shared<spanner_testing::FakeSystemClock>();
+  clock->SetTime(std::chrono::system_clock::now());
+  auto const at = [&clock](std::chrono::seconds offset) {
+    return MakeTimestamp(clock->Now() + offset).value();
+  };
+  auto mock = std::make_shared<MockConnection>();
+  std::vector<spanner_proto::TransactionSelector> selectors;
+  std::vector<Timestamp> read_timestamps;
+  EXPECT_CALL(*mock, Read(_))
+      .WillRepeatedly([&](Connection::ReadParams const& p) {
+        selectors.push_back(Selector(p.transaction));
+        read_timestamps.push_back(at(std::chrono::seconds(0)));
+        return MakeRows(read_timestamps.back());
+      });
+
+  ReadTimestampCacheConnection conn(mock, clock);
+  // A bound that any later read timestamp satisfies, so only the age of the
+  // cached timestamp can make the reads refresh it.
+  auto const bounded =
+      Transaction::SingleUseOptions(at(-std::chrono::seconds(5)));
+  auto const max_age = ReadTimestampCacheConnection::kMaxCacheAge;
+  conn.Read(MakeReadParams(bounded));  // negotiates
+  conn.Read(MakeReadParams(bounded));  // uses the cache
+  clock->AdvanceTime(max_age / 2 + std::chrono::seconds(1));
+  conn.Read(MakeReadParams(bounded));  // refreshes
+  conn.Read(MakeReadParams(bounded));  // uses the refreshed timestamp
+  clock->AdvanceTime(max_age + std::chrono::seconds(1));
+  conn.Read(MakeReadParams(bounded));  // too old to use, negotiates
+
+  ASSERT_EQ(5, selectors.size());
+  auto const read_at = [&selectors](std::size_t i) {
+    return TimestampFromProto(
+        selectors[i].single_use().read_only().read_timestamp());
+  };
+  EXPECT_TRUE(selectors[0].single_use().read_only().has_min_read_timestamp());
+  EXPECT_EQ(read_timestamps[0], read_at(1));
+  EXPECT_TRUE(selectors[2].single_use().read_only().has_min_read_timestamp());
+  EXPECT_EQ(read_timestamps[2], read_at(3));
+  EXPECT_TRUE(selectors[4].single_use().read_only().has_min_read_timestamp());
+  EXPECT_EQ(read_timestamps[4], *conn.cached_read_timestamp());
+}
+
+TEST(ReadTimestampCacheTest, ForwardsReadWriteTransactions) {
+  auto mock = std::make_shared<MockConnection>();
+  EXPECT_CALL(*mock, Read(_)).WillOnce([](Connection::ReadParams const& p) {
+    // Routing the read did not visit the transaction, so this visit gets the
+    // first sequence number.
+    Visit(p.transaction, [](SessionHolder&,
+                            spanner_proto::TransactionSelector& s,
+                            std::int64_t seqno) {
+      EXPECT_TRUE(s.has_begin());
+      EXPECT_EQ(1, seqno);
+      return 0;
+    });
+    return RowStream(make_unique<MockResultSetSource>());
+  });
+  EXPECT_CALL(*mock, Commit(_)).WillOnce(Return(CommitResult{}));
+
+  ReadTimestampCacheConnection conn(mock);
+  auto txn = MakeReadWriteTransaction();
+  conn.Read({txn, "table", KeySet::All(), {"column"}, ReadOptions{}, {}});
+  EXPECT_TRUE(conn.Commit({txn, {}}).ok());
+  EXPECT_FALSE(conn.cached_read_timestamp().has_value());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,47 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/retry_budget_policy.h"
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+std::unique_ptr<RetryPolicy> RetryBudgetPolicy::clone() const {
+  return std::unique_ptr<RetryPolicy>(
+      new RetryBudgetPolicy(child_->clone(), budget_));
+}
+
+bool RetryBudgetPolicy::OnFailure(Status const& status) {
+  if (!child_->OnFailure(status)) return false;
+  if (budget_->AllowRetry()) return true;
+  throttled_ = true;
+  return false;
+}
+
+bool RetryBudgetPolicy::IsExhausted() const {
+  return throttled_ || child_->IsExhausted();
+}
+
+bool RetryBudgetPolicy::IsPermanentFailure(Status const& status) const {
+  return child_->IsPermanentFailure(status);
+}
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
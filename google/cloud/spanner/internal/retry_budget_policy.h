@@ -0,0 +1,60 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_RETRY_BUDGET_POLICY_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_RETRY_BUDGET_POLICY_H
+
+#include "google/cloud/spanner/retry_budget.h"
+#include "google/cloud/spanner/retry_policy.h"
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/status.h"
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+/**
+ * A `RetryPolicy` that also stops retrying when a `RetryBudget` is exhausted.
+ *
+ * All the clones share the budget. When the budget refuses a retry this
+ * policy reports itself as exhausted, so the retry loop fails fast with the
+ * last error.
+ */
+class RetryBudgetPolicy : public RetryPolicy {
+ public:
+  RetryBudgetPolicy(std::unique_ptr<RetryPolicy> child,
+                    std::shared_ptr<RetryBudget> budget)
+      : child_(std::move(child)), budget_(std::move(budget)) {}
+
+  std::unique_ptr<RetryPolicy> clone() const override;
+  bool OnFailure(Status const& status) override;
+  bool IsExhausted() const override;
+  bool IsPermanentFailure(Status const& status) const override;
+
+ private:
+  std::unique_ptr<RetryPolicy> child_;
+  std::shared_ptr<RetryBudget> budget_;
+  bool throttled_ = false;
+};
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_RETRY_BUDGET_POLICY_H
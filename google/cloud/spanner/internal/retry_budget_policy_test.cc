@@ -0,0 +1,62 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/retry_budget_policy.h"
+#include <gmock/gmock.h>
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+Status TransientError() { return Status(StatusCode::kUnavailable, "retry"); }
+
+TEST(RetryBudgetPolicyTest, FailsFastWhenThrottled) {
+  auto budget = std::make_shared<RetryBudget>(2, 0.5);
+  RetryBudgetPolicy policy(LimitedErrorCountRetryPolicy(5).clone(), budget);
+  EXPECT_TRUE(policy.OnFailure(TransientError()));
+  EXPECT_FALSE(policy.IsExhausted());
+
+  budget->Record(TransientError());
+  EXPECT_FALSE(policy.OnFailure(TransientError()));
+  EXPECT_TRUE(policy.IsExhausted());
+
+  // Clones share the budget, but not the throttled state.
+  auto clone = policy.clone();
+  EXPECT_FALSE(clone->IsExhausted());
+  EXPECT_FALSE(clone->OnFailure(TransientError()));
+  EXPECT_EQ(2, budget->Snapshot().throttled);
+}
+
+TEST(RetryBudgetPolicyTest, ChildDecidesFirst) {
+  auto budget = std::make_shared<RetryBudget>(2, 0.5);
+  RetryBudgetPolicy policy(LimitedErrorCountRetryPolicy(5).clone(), budget);
+  auto const permanent = Status(StatusCode::kPermissionDenied, "uh-oh");
+  EXPECT_TRUE(policy.IsPermanentFailure(permanent));
+  EXPECT_FALSE(policy.OnFailure(permanent));
+  EXPECT_FALSE(policy.IsExhausted());
+  auto const metrics = budget->Snapshot();
+  EXPECT_EQ(0, metrics.retries);
+  EXPECT_EQ(0, metrics.throttled);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,193 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/retry_budget_spanner_stub.h"
+#include "google/cloud/spanner/internal/deadline.h"
+#include "google/cloud/spanner/internal/stub_decorator_utils.h"
+#include "google/cloud/grpc_error_delegate.h"
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+namespace spanner_proto = ::google::spanner::v1;
+
+using PartialResultSetReader =
+    grpc::ClientReaderInterface<spanner_proto::PartialResultSet>;
+
+/// Records the result of a streaming call when the caller finishes it.
+class RetryBudgetStreamReader : public ForwardingStreamReader {
+ public:
+  RetryBudgetStreamReader(std::unique_ptr<PartialResultSetReader> child,
+                          std::shared_ptr<RetryBudget> budget)
+      : ForwardingStreamReader(std::move(child)), budget_(std::move(budget)) {}
+
+  grpc::Status Finish() override {
+    auto status = ForwardingStreamReader::Finish();
+    budget_->Record(google::cloud::MakeStatusFromRpcError(status));
+    return status;
+  }
+
+ private:
+  std::shared_ptr<RetryBudget> budget_;
+};
+
+}  // namespace
+
+template <typename Response>
+Response RetryBudgetSpannerStub::Record(grpc::ClientContext const& context,
+                                        Response response) {
+  // A call that runs out of its attempt timeout is retried like a transient
+  // failure, but one that runs out of the operation deadline is not.
+  budget_->Record(
+      AttemptStatus(StatusOf(response), context.deadline(), CurrentDeadline()));
+  return response;
+}
+
+std::unique_ptr<PartialResultSetReader> RetryBudgetSpannerStub::RecordStream(
+    std::unique_ptr<PartialResultSetReader> reader) {
+  if (!reader) return reader;
+  return std::unique_ptr<PartialResultSetReader>(
+      new RetryBudgetStreamReader(std::move(reader), budget_));
+}
+
+StatusOr<spanner_proto::Session> RetryBudgetSpannerStub::CreateSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::CreateSessionRequest const& request) {
+  return Record(client_context, child_->CreateSession(client_context, request));
+}
+
+StatusOr<spanner_proto::BatchCreateSessionsResponse>
+RetryBudgetSpannerStub::BatchCreateSessions(
+    grpc::ClientContext& client_context,
+    spanner_proto::BatchCreateSessionsRequest const& request) {
+  return Record(client_context,
+                child_->BatchCreateSessions(client_context, request));
+}
+
+std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+    spanner_proto::BatchCreateSessionsResponse>>
+RetryBudgetSpannerStub::AsyncBatchCreateSessions(
+    grpc::ClientContext& client_context,
+    spanner_proto::BatchCreateSessionsRequest const& request,
+    grpc::CompletionQueue* cq) {
+  return child_->AsyncBatchCreateSessions(client_context, request, cq);
+}
+
+StatusOr<spanner_proto::Session> RetryBudgetSpannerStub::GetSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::GetSessionRequest const& request) {
+  return Record(client_context, child_->GetSession(client_context, request));
+}
+
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<spanner_proto::Session>>
+RetryBudgetSpannerStub::AsyncGetSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::GetSessionRequest const& request,
+    grpc::CompletionQueue* cq) {
+  return child_->AsyncGetSession(client_context, request, cq);
+}
+
+StatusOr<spanner_proto::ListSessionsResponse>
+RetryBudgetSpannerStub::ListSessions(
+    grpc::ClientContext& client_context,
+    spanner_proto::ListSessionsRequest const& request) {
+  return Record(client_context, child_->ListSessions(client_context, request));
+}
+
+Status RetryBudgetSpannerStub::DeleteSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::DeleteSessionRequest const& request) {
+  return Record(client_context, child_->DeleteSession(client_context, request));
+}
+
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<google::protobuf::Empty>>
+RetryBudgetSpannerStub::AsyncDeleteSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::DeleteSessionRequest const& request,
+    grpc::CompletionQueue* cq) {
+  return child_->AsyncDeleteSession(client_context, request, cq);
+}
+
+StatusOr<spanner_proto::ResultSet> RetryBudgetSpannerStub::ExecuteSql(
+    grpc::ClientContext& client_context,
+    spanner_proto::ExecuteSqlRequest const& request) {
+  return Record(client_context, child_->ExecuteSql(client_context, request));
+}
+
+std::unique_ptr<PartialResultSetReader>
+RetryBudgetSpannerStub::ExecuteStreamingSql(
+    grpc::ClientContext& client_context,
+    spanner_proto::ExecuteSqlRequest const& request) {
+  return RecordStream(child_->ExecuteStreamingSql(client_context, request));
+}
+
+StatusOr<spanner_proto::ExecuteBatchDmlResponse>
+RetryBudgetSpannerStub::ExecuteBatchDml(
+    grpc::ClientContext& client_context,
+    spanner_proto::ExecuteBatchDmlRequest const& request) {
+  return Record(client_context,
+                child_->ExecuteBatchDml(client_context, request));
+}
+
+std::unique_ptr<PartialResultSetReader> RetryBudgetSpannerStub::StreamingRead(
+    grpc::ClientContext& client_context,
+    spanner_proto::ReadRequest const& request) {
+  return RecordStream(child_->StreamingRead(client_context, request));
+}
+
+StatusOr<spanner_proto::Transaction> RetryBudgetSpannerStub::BeginTransaction(
+    grpc::ClientContext& client_context,
+    spanner_proto::BeginTransactionRequest const& request) {
+  return Record(client_context,
+                child_->BeginTransaction(client_context, request));
+}
+
+StatusOr<spanner_proto::CommitResponse> RetryBudgetSpannerStub::Commit(
+    grpc::ClientContext& client_context,
+    spanner_proto::CommitRequest const& request) {
+  return Record(client_context, child_->Commit(client_context, request));
+}
+
+Status RetryBudgetSpannerStub::Rollback(
+    grpc::ClientContext& client_context,
+    spanner_proto::RollbackRequest const& request) {
+  return Record(client_context, child_->Rollback(client_context, request));
+}
+
+StatusOr<spanner_proto::PartitionResponse>
+RetryBudgetSpannerStub::PartitionQuery(
+    grpc::ClientContext& client_context,
+    spanner_proto::PartitionQueryRequest const& request) {
+  return Record(client_context,
+                child_->PartitionQuery(client_context, request));
+}
+
+StatusOr<spanner_proto::PartitionResponse>
+RetryBudgetSpannerStub::PartitionRead(
+    grpc::ClientContext& client_context,
+    spanner_proto::PartitionReadRequest const& request) {
+  return Record(client_context, child_->PartitionRead(client_context, request));
+}
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,148 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/retry_budget_spanner_stub.h"
+#include "google/cloud/spanner/internal/deadline.h"
+#include "google/cloud/spanner/testing/mock_spanner_stub.h"
+#include "google/cloud/internal/make_unique.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <gmock/gmock.h>
+#include <chrono>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::internal::make_unique;
+using ::testing::_;
+using ::testing::Return;
+namespace spanner_proto = ::google::spanner::v1;
+
+class MockGrpcReader
+    : public ::grpc::ClientReaderInterface<spanner_proto::PartialResultSet> {
+ public:
+  MOCK_METHOD1(Read, bool(spanner_proto::PartialResultSet*));
+  MOCK_METHOD1(NextMessageSize, bool(std::uint32_t*));
+  MOCK_METHOD0(Finish, grpc::Status());
+  MOCK_METHOD0(WaitForInitialMetadata, void());
+};
+
+class RetryBudgetSpannerStubTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    mock_ = std::make_shared<spanner_testing::MockSpannerStub>();
+    budget_ = std::make_shared<RetryBudget>(10, 0.5);
+  }
+
+  std::shared_ptr<spanner_testing::MockSpannerStub> mock_;
+  std::shared_ptr<RetryBudget> budget_;
+};
+
+TEST_F(RetryBudgetSpannerStubTest, Unary) {
+  EXPECT_CALL(*mock_, Commit(_, _))
+      .WillOnce(Return(Status(StatusCode::kUnavailable, "try-again")))
+      .WillOnce(Return(spanner_proto::CommitResponse()));
+  EXPECT_CALL(*mock_, Rollback(_, _))
+      .WillOnce(Return(Status(StatusCode::kNotFound, "not-found")));
+
+  RetryBudgetSpannerStub stub(mock_, budget_);
+  grpc::ClientContext context;
+  auto response = stub.Commit(context, spanner_proto::CommitRequest());
+  EXPECT_EQ(StatusCode::kUnavailable, response.status().code());
+  response = stub.Commit(context, spanner_proto::CommitRequest());
+  EXPECT_STATUS_OK(response);
+  auto status = stub.Rollback(context, spanner_proto::RollbackRequest());
+  EXPECT_EQ(StatusCode::kNotFound, status.code());
+
+  auto const metrics = budget_->Snapshot();
+  EXPECT_EQ(1, metrics.failures);
+  EXPECT_EQ(1, metrics.successes);
+  EXPECT_EQ(9.5, metrics.tokens);
+}
+
+TEST_F(RetryBudgetSpannerStubTest, AttemptTimeout) {
+  EXPECT_CALL(*mock_, BeginTransaction(_, _))
+      .Times(2)
+      .WillRepeatedly(Return(Status(StatusCode::kDeadlineExceeded, "slow")));
+
+  RetryBudgetSpannerStub stub(mock_, budget_);
+  auto const now = std::chrono::system_clock::now();
+  auto const deadline = now + std::chrono::minutes(1);
+  ScopedDeadline scoped(OperationDeadline{deadline, std::chrono::seconds(1)});
+
+  // The attempt ran out of its own timeout, and is retried.
+  grpc::ClientContext attempt;
+  attempt.set_deadline(now + std::chrono::seconds(1));
+  stub.BeginTransaction(attempt, spanner_proto::BeginTransactionRequest());
+  EXPECT_EQ(1, budget_->Snapshot().failures);
+
+  // The attempt ran out of the operation deadline, which is not retried.
+  grpc::ClientContext last;
+  last.set_deadline(deadline);
+  stub.BeginTransaction(last, spanner_proto::BeginTransactionRequest());
+  EXPECT_EQ(1, budget_->Snapshot().failures);
+}
+
+TEST_F(RetryBudgetSpannerStubTest, Streaming) {
+  EXPECT_CALL(*mock_, StreamingRead(_, _))
+      .WillOnce([](grpc::ClientContext&, spanner_proto::ReadRequest const&) {
+        auto reader = make_unique<MockGrpcReader>();
+        EXPECT_CALL(*reader, Read(_))
+            .WillOnce(Return(true))
+            .WillOnce(Return(false));
+        EXPECT_CALL(*reader, Finish())
+            .WillOnce(Return(
+                grpc::Status(grpc::StatusCode::UNAVAILABLE, "try-again")));
+        return reader;
+      });
+
+  RetryBudgetSpannerStub stub(mock_, budget_);
+  grpc::ClientContext context;
+  auto reader = stub.StreamingRead(context, spanner_proto::ReadRequest());
+  ASSERT_TRUE(reader);
+  spanner_proto::PartialResultSet r;
+  while (reader->Read(&r)) continue;
+  EXPECT_EQ(0, budget_->Snapshot().failures);
+  EXPECT_FALSE(reader->Finish().ok());
+  EXPECT_EQ(1, budget_->Snapshot().failures);
+}
+
+TEST_F(RetryBudgetSpannerStubTest, StreamingNotFinished) {
+  EXPECT_CALL(*mock_, ExecuteStreamingSql(_, _))
+      .WillOnce(
+          [](grpc::ClientContext&, spanner_proto::ExecuteSqlRequest const&) {
+            return make_unique<MockGrpcReader>();
+          });
+
+  RetryBudgetSpannerStub stub(mock_, budget_);
+  grpc::ClientContext context;
+  auto reader =
+      stub.ExecuteStreamingSql(context, spanner_proto::ExecuteSqlRequest());
+  ASSERT_TRUE(reader);
+  reader.reset();
+
+  auto const metrics = budget_->Snapshot();
+  EXPECT_EQ(0, metrics.successes);
+  EXPECT_EQ(0, metrics.failures);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
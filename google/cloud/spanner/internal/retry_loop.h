@@ -15,12 +15,19 @@
 #ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_RETRY_LOOP_H
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_RETRY_LOOP_H
 
+#include "google/cloud/spanner/internal/deadline.h"
+#include "google/cloud/spanner/internal/tracing.h"
 #include "google/cloud/spanner/backoff_policy.h"
 #include "google/cloud/spanner/retry_policy.h"
+#include "google/cloud/completion_queue.h"
+#include "google/cloud/future.h"
 #include "google/cloud/internal/invoke_result.h"
 #include "google/cloud/status_or.h"
 #include <grpcpp/grpcpp.h>
+#include <chrono>
+#include <memory>
 #include <thread>
+#include <type_traits>
 
 namespace google {
 namespace cloud {
@@ -45,6 +52,15 @@ Status RetryLoopError(char const* loop_message, char const* location,
  * A generic retry loop for gRPC operations.
  *
  * This function implements a retry loop suitable for *most* gRPC operations.
+ * It blocks the calling thread during the backoff, see `AsyncRetryLoop()` for
+ * an alternative.
+ * Each attempt is traced as a child of the current span, if any.
+ *
+ * The loop also enforces the deadline of the current `ScopedDeadline`, if any:
+ * each attempt gets the attempt timeout, cut short to fit the remaining time,
+ * an attempt that runs out of its own timeout is retried like a transient
+ * failure, and the loop gives up (with `kDeadlineExceeded`) rather than start
+ * a backoff that ends after the deadline.
  *
  * @param retry_policy controls the duration of the retry loop.
  * @param backoff_policy controls how the loop backsoff from a recoverable
@@ -76,25 +92,37 @@ auto RetryLoopImpl(std::unique_ptr<RetryPolicy> retry_policy,
                    Sleeper sleeper)
     -> google::cloud::internal::invoke_result_t<Functor, grpc::ClientContext&,
                                                 Request const&> {
+  auto const deadline = CurrentDeadline();
   Status last_status;
   while (!retry_policy->IsExhausted()) {
+    if (Expired(deadline)) return DeadlineExceededError(location, last_status);
     // Need to create a new context for each retry.
     grpc::ClientContext context;
+    auto const attempt_deadline = AttemptDeadline(deadline);
+    SetDeadline(context, attempt_deadline);
+    ScopedSpan span("spanner.RetryAttempt");
+    if (span) span.SetAttribute("location", location);
     auto result = functor(context, request);
     if (result.ok()) {
       return result;
     }
     last_status = GetResultStatus(std::move(result));
+    span.End(last_status);
     if (!is_idempotent) {
       return RetryLoopError("Error in non-idempotent operation", location,
                             last_status);
     }
-    if (!retry_policy->OnFailure(last_status)) {
+    if (!retry_policy->OnFailure(
+            AttemptStatus(last_status, attempt_deadline, deadline))) {
       // The retry policy is exhausted or the error is not retryable, either
       // way, exit the loop.
       break;
     }
-    sleeper(backoff_policy->OnCompletion());
+    auto const delay = backoff_policy->OnCompletion();
+    if (Expired(deadline, delay)) {
+      return DeadlineExceededError(location, last_status);
+    }
+    sleeper(delay);
   }
   if (!retry_policy->IsExhausted()) {
     // The last error cannot be retried, but it is not because the retry
@@ -123,6 +151,164 @@ auto RetryLoop(std::unique_ptr<RetryPolicy> retry_policy,
       [](std::chrono::milliseconds p) { std::this_thread::sleep_for(p); });
 }
 
+/// The type of the value in a `future<T>`.
+template <typename T>
+struct FutureValueType;
+
+template <typename T>
+struct FutureValueType<future<T>> {
+  using type = T;
+};
+
+/**
+ * The state of an `AsyncRetryLoop()`.
+ *
+ * Each attempt, and each backoff timer, keeps a reference to this object, so
+ * it lives until the loop completes.
+ */
+template <typename Functor, typename Request, typename Result>
+class AsyncRetryLoopImpl
+    : public std::enable_shared_from_this<
+          AsyncRetryLoopImpl<Functor, Request, Result>> {
+ public:
+  AsyncRetryLoopImpl(std::unique_ptr<RetryPolicy> retry_policy,
+                     std::unique_ptr<BackoffPolicy> backoff_policy,
+                     bool is_idempotent, CompletionQueue cq, Functor functor,
+                     Request request, char const* location)
+      : retry_policy_(std::move(retry_policy)),
+        backoff_policy_(std::move(backoff_policy)),
+        is_idempotent_(is_idempotent),
+        cq_(std::move(cq)),
+        functor_(std::move(functor)),
+        request_(std::move(request)),
+        location_(location),
+        trace_context_(CurrentTraceContext()),
+        deadline_(CurrentDeadline()) {}
+
+  future<Result> Start() {
+    auto f = result_.get_future();
+    StartAttempt();
+    return f;
+  }
+
+ private:
+  void StartAttempt() {
+    if (retry_policy_->IsExhausted()) {
+      return SetError("Retry policy exhausted in");
+    }
+    if (Expired(deadline_)) {
+      return result_.set_value(
+          Result(DeadlineExceededError(location_, last_status_)));
+    }
+    if (trace_context_.tracer) {
+      attempt_span_ = trace_context_.tracer->StartSpan("spanner.RetryAttempt",
+                                                       trace_context_.span);
+      if (attempt_span_) attempt_span_->SetAttribute("location", location_);
+    }
+    // Need to create a new context for each retry.
+    context_.reset(new grpc::ClientContext);
+    attempt_deadline_ = AttemptDeadline(deadline_);
+    SetDeadline(*context_, attempt_deadline_);
+    auto self = this->shared_from_this();
+    functor_(cq_, *context_, request_).then([self](future<Result> f) {
+      self->OnAttempt(f.get());
+    });
+  }
+
+  void OnAttempt(Result result) {
+    if (result.ok()) {
+      EndAttemptSpan(Status());
+      return result_.set_value(std::move(result));
+    }
+    last_status_ = GetResultStatus(std::move(result));
+    EndAttemptSpan(last_status_);
+    if (!is_idempotent_) {
+      return SetError("Error in non-idempotent operation");
+    }
+    if (!retry_policy_->OnFailure(
+            AttemptStatus(last_status_, attempt_deadline_, deadline_))) {
+      // See the comments in `RetryLoopImpl()` about "permanent errors".
+      if (!retry_policy_->IsExhausted()) {
+        return SetError("Permanent error in");
+      }
+      return SetError("Retry policy exhausted in");
+    }
+    auto const delay = backoff_policy_->OnCompletion();
+    if (Expired(deadline_, delay)) {
+      return result_.set_value(
+          Result(DeadlineExceededError(location_, last_status_)));
+    }
+    // Wait for the backoff on a timer, rather than blocking this thread.
+    auto self = this->shared_from_this();
+    cq_.MakeRelativeTimer(delay)
+        .then([self](future<StatusOr<std::chrono::system_clock::time_point>>
+                         f) {
+          auto timer = f.get();
+          if (!timer) return self->result_.set_value(Result(timer.status()));
+          self->StartAttempt();
+        });
+  }
+
+  void EndAttemptSpan(Status const& status) {
+    if (!attempt_span_) return;
+    attempt_span_->End(status);
+    attempt_span_.reset();
+  }
+
+  void SetError(char const* loop_message) {
+    result_.set_value(
+        Result(RetryLoopError(loop_message, location_, last_status_)));
+  }
+
+  std::unique_ptr<RetryPolicy> retry_policy_;
+  std::unique_ptr<BackoffPolicy> backoff_policy_;
+  bool is_idempotent_;
+  CompletionQueue cq_;
+  Functor functor_;
+  Request request_;
+  char const* location_;
+  TraceContext trace_context_;
+  OperationDeadline deadline_;
+  std::chrono::system_clock::time_point attempt_deadline_;
+  std::shared_ptr<Span> attempt_span_;
+  std::unique_ptr<grpc::ClientContext> context_;
+  Status last_status_;
+  promise<Result> result_;
+};
+
+/**
+ * An asynchronous version of `RetryLoop()`.
+ *
+ * The backoff between attempts runs on a @p cq timer, so no thread is blocked
+ * while the operation is retried. The deadline of the current `ScopedDeadline`
+ * is captured when the loop starts, and enforced like in `RetryLoop()`.
+ *
+ * @param functor the operation to retry, called with @p cq, a new
+ *     `grpc::ClientContext` for each attempt, and @p request. It must return a
+ *     `future<Status>` or a `future<StatusOr<T>>`, and keep using the context
+ *     only until that future is satisfied.
+ * @return a future satisfied with the result of the first successful call to
+ *     @p functor, or with the final error for this request, using the same
+ *     messages as `RetryLoop()`.
+ */
+template <typename Functor, typename Request,
+          typename Future = google::cloud::internal::invoke_result_t<
+              Functor, CompletionQueue&, grpc::ClientContext&, Request const&>,
+          typename Result = typename FutureValueType<Future>::type>
+future<Result> AsyncRetryLoop(std::unique_ptr<RetryPolicy> retry_policy,
+                              std::unique_ptr<BackoffPolicy> backoff_policy,
+                              bool is_idempotent, CompletionQueue cq,
+                              Functor&& functor, Request request,
+                              char const* location) {
+  using Impl =
+      AsyncRetryLoopImpl<typename std::decay<Functor>::type, Request, Result>;
+  auto loop = std::make_shared<Impl>(
+      std::move(retry_policy), std::move(backoff_policy), is_idempotent,
+      std::move(cq), std::forward<Functor>(functor), std::move(request),
+      location);
+  return loop->Start();
+}
+
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include "google/cloud/spanner/internal/retry_loop.h"
+#include "google/cloud/spanner/testing/in_memory_tracer.h"
+#include "google/cloud/internal/background_threads_impl.h"
 #include "google/cloud/testing_util/assert_ok.h"
 #include <gmock/gmock.h>
 
@@ -23,6 +25,7 @@ inline namespace SPANNER_CLIENT_NS {
 namespace internal {
 namespace {
 
+using ::google::cloud::spanner_testing::InMemoryTracer;
 using ::testing::ElementsAre;
 using ::testing::HasSubstr;
 using ::testing::Return;
@@ -153,6 +156,307 @@ TEST(RetryLoopTest, TooManyTransientFailuresIdempotent) {
   EXPECT_THAT(actual.status().message(), HasSubstr("Retry policy exhausted"));
 }
 
+TEST(RetryLoopTest, TracesAttempts) {
+  auto tracer = std::make_shared<InMemoryTracer>();
+  int counter = 0;
+  {
+    ScopedSpan root(tracer, "root");
+    StatusOr<int> actual = RetryLoop(
+        TestRetryPolicy(), TestBackoffPolicy(), true,
+        [&counter](grpc::ClientContext&, int request) {
+          if (++counter < 3) {
+            return StatusOr<int>(Status(StatusCode::kUnavailable, "try again"));
+          }
+          return StatusOr<int>(2 * request);
+        },
+        42, "error message");
+    EXPECT_STATUS_OK(actual);
+  }
+
+  auto const spans = tracer->Spans();
+  ASSERT_EQ(4, spans.size());
+  EXPECT_EQ("root", spans[0].name);
+  for (std::size_t i = 1; i != spans.size(); ++i) {
+    EXPECT_EQ("spanner.RetryAttempt", spans[i].name);
+    EXPECT_EQ(0, spans[i].parent);
+    EXPECT_TRUE(spans[i].ended);
+    EXPECT_EQ("error message", spans[i].attributes.at("location"));
+  }
+  EXPECT_EQ(StatusCode::kUnavailable, spans[1].status.code());
+  EXPECT_EQ(StatusCode::kUnavailable, spans[2].status.code());
+  EXPECT_STATUS_OK(spans[3].status);
+}
+
+TEST(RetryLoopTest, DeadlineExpired) {
+  int counter = 0;
+  ScopedDeadline deadline(OperationDeadline{
+      std::chrono::system_clock::now() - std::chrono::milliseconds(1),
+      std::chrono::milliseconds(0)});
+  StatusOr<int> actual = RetryLoop(
+      TestRetryPolicy(), TestBackoffPolicy(), true,
+      [&counter](grpc::ClientContext&, int request) {
+        ++counter;
+        return StatusOr<int>(2 * request);
+      },
+      42, "the answer to everything");
+  EXPECT_EQ(StatusCode::kDeadlineExceeded, actual.status().code());
+  EXPECT_THAT(actual.status().message(),
+              HasSubstr("the answer to everything"));
+  EXPECT_EQ(0, counter);
+}
+
+TEST(RetryLoopTest, AttemptsFitInDeadline) {
+  using std::chrono::system_clock;
+  auto const start = system_clock::now();
+  auto const deadline = start + std::chrono::seconds(30);
+  ScopedDeadline scope(
+      OperationDeadline{deadline, std::chrono::milliseconds(500)});
+  std::vector<system_clock::time_point> attempt_deadlines;
+  StatusOr<int> actual = RetryLoop(
+      TestRetryPolicy(), TestBackoffPolicy(), true,
+      [&attempt_deadlines](grpc::ClientContext& context, int request) {
+        attempt_deadlines.push_back(context.deadline());
+        // An attempt that times out is retried.
+        if (attempt_deadlines.size() < 3) {
+          return StatusOr<int>(
+              Status(StatusCode::kDeadlineExceeded, "attempt timeout"));
+        }
+        return StatusOr<int>(2 * request);
+      },
+      42, "error message");
+  EXPECT_STATUS_OK(actual);
+  ASSERT_EQ(3, attempt_deadlines.size());
+  for (auto const& d : attempt_deadlines) {
+    EXPECT_LE(start + std::chrono::milliseconds(500), d);
+    EXPECT_GT(deadline, d);
+  }
+}
+
+TEST(RetryLoopTest, AttemptTimeoutShrinksToDeadline) {
+  auto const deadline =
+      std::chrono::system_clock::now() + std::chrono::seconds(30);
+  ScopedDeadline scope(OperationDeadline{deadline, std::chrono::minutes(5)});
+  Status actual = RetryLoop(
+      TestRetryPolicy(), TestBackoffPolicy(), true,
+      [deadline](grpc::ClientContext& context, int) {
+        EXPECT_EQ(deadline, context.deadline());
+        return Status();
+      },
+      42, "error message");
+  EXPECT_STATUS_OK(actual);
+}
+
+TEST(RetryLoopTest, NoBackoffPastDeadline) {
+  using ms = std::chrono::milliseconds;
+  std::unique_ptr<MockBackoffPolicy> mock(new MockBackoffPolicy);
+  EXPECT_CALL(*mock, OnCompletion()).WillOnce(Return(ms(60 * 1000)));
+
+  ScopedDeadline scope(OperationDeadline{
+      std::chrono::system_clock::now() + std::chrono::seconds(30), ms(0)});
+  int counter = 0;
+  std::vector<ms> sleep_for;
+  StatusOr<int> actual = RetryLoopImpl(
+      TestRetryPolicy(), std::move(mock), true,
+      [&counter](grpc::ClientContext&, int) {
+        ++counter;
+        return StatusOr<int>(Status(StatusCode::kUnavailable, "try again"));
+      },
+      42, "error message", [&sleep_for](ms p) { sleep_for.push_back(p); });
+  EXPECT_EQ(StatusCode::kDeadlineExceeded, actual.status().code());
+  EXPECT_THAT(actual.status().message(), HasSubstr("try again"));
+  EXPECT_EQ(1, counter);
+  EXPECT_TRUE(sleep_for.empty());
+}
+
+TEST(AsyncRetryLoopTest, Success) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto actual =
+      AsyncRetryLoop(
+          TestRetryPolicy(), TestBackoffPolicy(), true, threads.cq(),
+          [](CompletionQueue&, grpc::ClientContext&, int request) {
+            return make_ready_future(StatusOr<int>(2 * request));
+          },
+          42, "error message")
+          .get();
+  EXPECT_STATUS_OK(actual);
+  EXPECT_EQ(84, *actual);
+}
+
+TEST(AsyncRetryLoopTest, TransientThenSuccess) {
+  using TimerFuture = future<StatusOr<std::chrono::system_clock::time_point>>;
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  int counter = 0;
+  auto actual =
+      AsyncRetryLoop(
+          TestRetryPolicy(), TestBackoffPolicy(), true, threads.cq(),
+          [&counter](CompletionQueue& cq, grpc::ClientContext&, int request) {
+            // Complete each attempt in the CompletionQueue thread, like a
+            // real asynchronous RPC.
+            auto const success = ++counter >= 3;
+            return cq.MakeRelativeTimer(std::chrono::microseconds(1))
+                .then([success, request](TimerFuture) {
+                  if (!success) {
+                    return StatusOr<int>(
+                        Status(StatusCode::kUnavailable, "try again"));
+                  }
+                  return StatusOr<int>(2 * request);
+                });
+          },
+          42, "error message")
+          .get();
+  EXPECT_STATUS_OK(actual);
+  EXPECT_EQ(84, *actual);
+  EXPECT_EQ(3, counter);
+}
+
+TEST(AsyncRetryLoopTest, ReturnJustStatus) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  int counter = 0;
+  Status actual =
+      AsyncRetryLoop(
+          TestRetryPolicy(), TestBackoffPolicy(), true, threads.cq(),
+          [&counter](CompletionQueue&, grpc::ClientContext&, int) {
+            if (++counter < 3) {
+              return make_ready_future(
+                  Status(StatusCode::kUnavailable, "try again"));
+            }
+            return make_ready_future(Status());
+          },
+          42, "error message")
+          .get();
+  EXPECT_STATUS_OK(actual);
+  EXPECT_EQ(3, counter);
+}
+
+TEST(AsyncRetryLoopTest, TransientFailureNonIdempotent) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto actual =
+      AsyncRetryLoop(
+          TestRetryPolicy(), TestBackoffPolicy(), false, threads.cq(),
+          [](CompletionQueue&, grpc::ClientContext&, int) {
+            return make_ready_future(StatusOr<int>(
+                Status(StatusCode::kUnavailable, "try again")));
+          },
+          42, "the answer to everything")
+          .get();
+  EXPECT_EQ(StatusCode::kUnavailable, actual.status().code());
+  EXPECT_THAT(actual.status().message(), HasSubstr("try again"));
+  EXPECT_THAT(actual.status().message(),
+              HasSubstr("the answer to everything"));
+  EXPECT_THAT(actual.status().message(), HasSubstr("non-idempotent"));
+}
+
+TEST(AsyncRetryLoopTest, PermanentFailure) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto actual =
+      AsyncRetryLoop(
+          TestRetryPolicy(), TestBackoffPolicy(), true, threads.cq(),
+          [](CompletionQueue&, grpc::ClientContext&, int) {
+            return make_ready_future(StatusOr<int>(
+                Status(StatusCode::kPermissionDenied, "uh oh")));
+          },
+          42, "the answer to everything")
+          .get();
+  EXPECT_EQ(StatusCode::kPermissionDenied, actual.status().code());
+  EXPECT_THAT(actual.status().message(), HasSubstr("uh oh"));
+  EXPECT_THAT(actual.status().message(), HasSubstr("Permanent error"));
+}
+
+TEST(AsyncRetryLoopTest, TooManyTransientFailures) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  int counter = 0;
+  auto actual =
+      AsyncRetryLoop(
+          TestRetryPolicy(), TestBackoffPolicy(), true, threads.cq(),
+          [&counter](CompletionQueue&, grpc::ClientContext&, int) {
+            ++counter;
+            return make_ready_future(StatusOr<int>(
+                Status(StatusCode::kUnavailable, "try again")));
+          },
+          42, "the answer to everything")
+          .get();
+  EXPECT_EQ(StatusCode::kUnavailable, actual.status().code());
+  EXPECT_THAT(actual.status().message(), HasSubstr("try again"));
+  EXPECT_THAT(actual.status().message(), HasSubstr("Retry policy exhausted"));
+  EXPECT_EQ(6, counter);
+}
+
+TEST(AsyncRetryLoopTest, TracesAttempts) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto tracer = std::make_shared<InMemoryTracer>();
+  int counter = 0;
+  future<StatusOr<int>> f;
+  {
+    ScopedSpan root(tracer, "root");
+    f = AsyncRetryLoop(
+        TestRetryPolicy(), TestBackoffPolicy(), true, threads.cq(),
+        [&counter](CompletionQueue&, grpc::ClientContext&, int request) {
+          if (++counter < 2) {
+            return make_ready_future(
+                StatusOr<int>(Status(StatusCode::kUnavailable, "try again")));
+          }
+          return make_ready_future(StatusOr<int>(2 * request));
+        },
+        42, "error message");
+  }
+  EXPECT_STATUS_OK(f.get());
+
+  EXPECT_THAT(tracer->SpanNames(),
+              ElementsAre("root", "spanner.RetryAttempt",
+                          "spanner.RetryAttempt"));
+  auto const spans = tracer->Spans();
+  EXPECT_EQ(0, spans[1].parent);
+  EXPECT_EQ(StatusCode::kUnavailable, spans[1].status.code());
+  EXPECT_EQ(0, spans[2].parent);
+  EXPECT_STATUS_OK(spans[2].status);
+}
+
+TEST(AsyncRetryLoopTest, DeadlineCapturedAtStart) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto const deadline =
+      std::chrono::system_clock::now() + std::chrono::seconds(30);
+  int counter = 0;
+  future<Status> f;
+  {
+    ScopedDeadline scope(
+        OperationDeadline{deadline, std::chrono::milliseconds(0)});
+    f = AsyncRetryLoop(
+        TestRetryPolicy(), TestBackoffPolicy(), true, threads.cq(),
+        [&counter, deadline](CompletionQueue&, grpc::ClientContext& context,
+                             int) {
+          // The retries run after the `ScopedDeadline` is destroyed.
+          EXPECT_EQ(deadline, context.deadline());
+          if (++counter < 3) {
+            return make_ready_future(
+                Status(StatusCode::kUnavailable, "try again"));
+          }
+          return make_ready_future(Status());
+        },
+        42, "error message");
+  }
+  EXPECT_STATUS_OK(f.get());
+  EXPECT_EQ(3, counter);
+}
+
+TEST(AsyncRetryLoopTest, DeadlineExpired) {
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  ScopedDeadline scope(OperationDeadline{
+      std::chrono::system_clock::now() - std::chrono::milliseconds(1),
+      std::chrono::milliseconds(0)});
+  int counter = 0;
+  auto actual =
+      AsyncRetryLoop(
+          TestRetryPolicy(), TestBackoffPolicy(), true, threads.cq(),
+          [&counter](CompletionQueue&, grpc::ClientContext&, int request) {
+            ++counter;
+            return make_ready_future(StatusOr<int>(2 * request));
+          },
+          42, "error message")
+          .get();
+  EXPECT_EQ(StatusCode::kDeadlineExceeded, actual.status().code());
+  EXPECT_EQ(0, counter);
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
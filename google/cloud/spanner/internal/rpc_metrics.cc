@@ -0,0 +1,139 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/rpc_metrics.h"
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+std::size_t constexpr RpcMetrics::kLatencyBuckets;
+std::size_t constexpr RpcMetrics::kStatusCodes;
+std::size_t constexpr RpcMetrics::kMethodCounters;
+std::size_t constexpr RpcMetrics::kShards;
+
+namespace {
+
+// The number of counters in a cache line, assuming 64-byte lines.
+std::size_t constexpr kCacheLineCounters = 64 / sizeof(std::int64_t);
+
+// Threads are assigned shards round-robin, in the order they first record a
+// metric. Hashing the thread id distributes poorly with some libraries.
+std::size_t CurrentShard(std::size_t shards) {
+  static std::atomic<std::size_t> next_shard{0};
+  thread_local std::size_t const shard = next_shard.fetch_add(1);
+  return shard % shards;
+}
+
+std::size_t LatencyBucket(std::chrono::nanoseconds latency) {
+  auto us = std::chrono::duration_cast<std::chrono::microseconds>(latency)
+                .count();
+  std::size_t bucket = 0;
+  while (us > 0 && bucket + 1 < RpcMetrics::kLatencyBuckets) {
+    us >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+}  // namespace
+
+RpcMetrics::RpcMetrics(std::vector<std::string> methods)
+    : methods_(std::move(methods)),
+      // Round up to whole cache lines, and add one more line so the shards do
+      // not share cache lines regardless of how the array is aligned.
+      shard_size_((methods_.size() * kMethodCounters + kCacheLineCounters - 1) /
+                      kCacheLineCounters * kCacheLineCounters +
+                  kCacheLineCounters),
+      counters_(new std::atomic<std::int64_t>[kShards * shard_size_]) {
+  for (std::size_t i = 0; i != kShards * shard_size_; ++i) {
+    counters_[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+void RpcMetrics::Start(std::size_t method, std::size_t request_bytes) {
+  Add(method, kCalls, 1);
+  Add(method, kInFlight, 1);
+  Add(method, kRequestBytes, static_cast<std::int64_t>(request_bytes));
+}
+
+void RpcMetrics::Sent(std::size_t method, std::size_t request_bytes) {
+  Add(method, kCalls, 1);
+  Add(method, kRequestBytes, static_cast<std::int64_t>(request_bytes));
+}
+
+void RpcMetrics::AddResponseBytes(std::size_t method,
+                                  std::size_t response_bytes) {
+  Add(method, kResponseBytes, static_cast<std::int64_t>(response_bytes));
+}
+
+void RpcMetrics::Finish(std::size_t method, std::chrono::nanoseconds latency,
+                        StatusCode code, std::size_t response_bytes) {
+  Add(method, kInFlight, -1);
+  if (response_bytes != 0) AddResponseBytes(method, response_bytes);
+  Add(method, kFixedCounters + LatencyBucket(latency), 1);
+  auto c = static_cast<std::size_t>(code);
+  // Count any codes added after this was written as `kUnknown`.
+  if (c >= kStatusCodes) c = static_cast<std::size_t>(StatusCode::kUnknown);
+  Add(method, kFixedCounters + kLatencyBuckets + c, 1);
+}
+
+std::vector<RpcMethodMetrics> RpcMetrics::Snapshot() const {
+  std::vector<std::int64_t> totals(methods_.size() * kMethodCounters);
+  for (std::size_t s = 0; s != kShards; ++s) {
+    auto const* shard = &counters_[s * shard_size_];
+    for (std::size_t i = 0; i != totals.size(); ++i) {
+      totals[i] += shard[i].load(std::memory_order_relaxed);
+    }
+  }
+
+  std::vector<RpcMethodMetrics> result;
+  result.reserve(methods_.size());
+  for (std::size_t m = 0; m != methods_.size(); ++m) {
+    auto const* t = &totals[m * kMethodCounters];
+    RpcMethodMetrics metrics{methods_[m],
+                             t[kCalls],
+                             t[kInFlight],
+                             t[kRequestBytes],
+                             t[kResponseBytes],
+                             {t + kFixedCounters,
+                              t + kFixedCounters + kLatencyBuckets},
+                             {}};
+    for (std::size_t c = 0; c != kStatusCodes; ++c) {
+      auto const count = t[kFixedCounters + kLatencyBuckets + c];
+      if (count != 0) metrics.status_codes[static_cast<StatusCode>(c)] = count;
+    }
+    result.push_back(std::move(metrics));
+  }
+  return result;
+}
+
+std::chrono::microseconds RpcMetrics::LatencyBucketLimit(std::size_t i) {
+  return std::chrono::microseconds(std::int64_t{1} << i);
+}
+
+void RpcMetrics::Add(std::size_t method, std::size_t counter,
+                     std::int64_t value) {
+  auto const index = CurrentShard(kShards) * shard_size_ +
+                     method * kMethodCounters + counter;
+  counters_[index].fetch_add(value, std::memory_order_relaxed);
+}
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,123 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_RPC_METRICS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_RPC_METRICS_H
+
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/status.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+/// A point-in-time copy of the metrics for one RPC method.
+struct RpcMethodMetrics {
+  std::string method;
+  /// The number of calls started.
+  std::int64_t calls;
+  /// The number of calls started but not finished.
+  std::int64_t in_flight;
+  std::int64_t request_bytes;
+  std::int64_t response_bytes;
+  /**
+   * The latency histogram, bucket `i` counts the calls that took less than
+   * `RpcMetrics::LatencyBucketLimit(i)`, and at least the limit of the previous
+   * bucket. The last bucket has no upper limit.
+   */
+  std::vector<std::int64_t> latency_buckets;
+  /// The number of finished calls by status code, omitting zero counts.
+  std::map<StatusCode, std::int64_t> status_codes;
+};
+
+/**
+ * Records per-method RPC counts, latencies, payload sizes and status codes.
+ *
+ * The counters are split in shards, and each thread always updates the same
+ * shard with relaxed atomic operations. Recording never takes a lock, and
+ * threads on different shards do not share cache lines. `Snapshot()` sums the
+ * shards, so it may observe a call partially recorded, e.g. started but with
+ * its request bytes not yet added.
+ */
+class RpcMetrics {
+ public:
+  static std::size_t constexpr kLatencyBuckets = 26;
+
+  /// Create the metrics for @p methods, which are referenced by their index.
+  explicit RpcMetrics(std::vector<std::string> methods);
+
+  RpcMetrics(RpcMetrics const&) = delete;
+  RpcMetrics& operator=(RpcMetrics const&) = delete;
+
+  /// Record the start of a call.
+  void Start(std::size_t method, std::size_t request_bytes);
+
+  /**
+   * Record a call whose end is not observed, such as an asynchronous call,
+   * only counting the call and its request bytes.
+   */
+  void Sent(std::size_t method, std::size_t request_bytes);
+
+  /// Record bytes received by a call, for streaming calls.
+  void AddResponseBytes(std::size_t method, std::size_t response_bytes);
+
+  /// Record the end of a call started with `Start()`.
+  void Finish(std::size_t method, std::chrono::nanoseconds latency,
+              StatusCode code, std::size_t response_bytes = 0);
+
+  /// Add up the metrics recorded so far, one element per method.
+  std::vector<RpcMethodMetrics> Snapshot() const;
+
+  /// The (exclusive) upper limit of the latency bucket @p i.
+  static std::chrono::microseconds LatencyBucketLimit(std::size_t i);
+
+ private:
+  // The counters of each method in a shard, latency buckets and status codes
+  // follow these.
+  enum Counter {
+    kCalls,
+    kInFlight,
+    kRequestBytes,
+    kResponseBytes,
+    kFixedCounters,
+  };
+  static std::size_t constexpr kStatusCodes = 17;
+  static std::size_t constexpr kMethodCounters =
+      kFixedCounters + kLatencyBuckets + kStatusCodes;
+  static std::size_t constexpr kShards = 16;
+
+  void Add(std::size_t method, std::size_t counter, std::int64_t value);
+
+  std::vector<std::string> methods_;
+  std::size_t shard_size_;
+  std::unique_ptr<std::atomic<std::int64_t>[]> counters_;
+};
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_RPC_METRICS_H
@@ -0,0 +1,124 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/rpc_metrics.h"
+#include <gmock/gmock.h>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::Pair;
+
+TEST(RpcMetricsTest, Empty) {
+  RpcMetrics metrics({"A", "B"});
+  auto snapshot = metrics.Snapshot();
+  ASSERT_EQ(2, snapshot.size());
+  EXPECT_EQ("A", snapshot[0].method);
+  EXPECT_EQ("B", snapshot[1].method);
+  for (auto const& m : snapshot) {
+    EXPECT_EQ(0, m.calls);
+    EXPECT_EQ(0, m.in_flight);
+    EXPECT_EQ(0, m.request_bytes);
+    EXPECT_EQ(0, m.response_bytes);
+    EXPECT_EQ(RpcMetrics::kLatencyBuckets, m.latency_buckets.size());
+    EXPECT_TRUE(m.status_codes.empty());
+  }
+}
+
+TEST(RpcMetricsTest, RecordsCalls) {
+  RpcMetrics metrics({"A", "B"});
+  metrics.Start(1, 10);
+  metrics.Start(1, 20);
+  metrics.Start(1, 30);
+  metrics.Finish(1, std::chrono::microseconds(0), StatusCode::kOk, 100);
+  metrics.AddResponseBytes(1, 7);
+  metrics.Finish(1, std::chrono::microseconds(3), StatusCode::kUnavailable);
+  metrics.Sent(0, 5);
+
+  auto snapshot = metrics.Snapshot();
+  ASSERT_EQ(2, snapshot.size());
+  auto const& a = snapshot[0];
+  EXPECT_EQ(1, a.calls);
+  EXPECT_EQ(0, a.in_flight);
+  EXPECT_EQ(5, a.request_bytes);
+  EXPECT_TRUE(a.status_codes.empty());
+
+  auto const& b = snapshot[1];
+  EXPECT_EQ(3, b.calls);
+  EXPECT_EQ(1, b.in_flight);
+  EXPECT_EQ(60, b.request_bytes);
+  EXPECT_EQ(107, b.response_bytes);
+  EXPECT_EQ(1, b.latency_buckets[0]);
+  EXPECT_EQ(1, b.latency_buckets[2]);
+  EXPECT_THAT(b.status_codes, ElementsAre(Pair(StatusCode::kOk, 1),
+                                          Pair(StatusCode::kUnavailable, 1)));
+}
+
+TEST(RpcMetricsTest, LatencyBuckets) {
+  RpcMetrics metrics({"A"});
+  auto const last = RpcMetrics::kLatencyBuckets - 1;
+  for (std::size_t i = 0; i != last; ++i) {
+    // The smallest and largest latencies in each bucket.
+    auto const limit = RpcMetrics::LatencyBucketLimit(i);
+    metrics.Finish(0, limit / 2, StatusCode::kOk);
+    metrics.Finish(0, limit - std::chrono::microseconds(1), StatusCode::kOk);
+  }
+  metrics.Finish(0, RpcMetrics::LatencyBucketLimit(last), StatusCode::kOk);
+  metrics.Finish(0, std::chrono::hours(1), StatusCode::kOk);
+
+  auto const buckets = metrics.Snapshot()[0].latency_buckets;
+  // Both latencies in bucket 0 are `0us`.
+  for (std::size_t i = 0; i != RpcMetrics::kLatencyBuckets; ++i) {
+    EXPECT_EQ(2, buckets[i]) << "i=" << i;
+  }
+}
+
+TEST(RpcMetricsTest, ConcurrentThreads) {
+  RpcMetrics metrics({"A"});
+  auto constexpr kThreads = 8;
+  auto constexpr kCalls = 1000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kThreads; ++t) {
+    threads.emplace_back([&metrics] {
+      for (int i = 0; i != kCalls; ++i) {
+        metrics.Start(0, 1);
+        metrics.Finish(0, std::chrono::microseconds(1), StatusCode::kOk, 2);
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+
+  auto const a = metrics.Snapshot()[0];
+  EXPECT_EQ(kThreads * kCalls, a.calls);
+  EXPECT_EQ(0, a.in_flight);
+  EXPECT_EQ(kThreads * kCalls, a.request_bytes);
+  EXPECT_EQ(2 * kThreads * kCalls, a.response_bytes);
+  EXPECT_EQ(kThreads * kCalls, a.latency_buckets[1]);
+  EXPECT_THAT(a.status_codes, ElementsAre(Pair(StatusCode::kOk,
+                                               kThreads * kCalls)));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,311 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/sampled_logging_spanner_stub.h"
+#include "google/cloud/spanner/internal/log_wrapper.h"
+#include "google/cloud/spanner/internal/stub_decorator_utils.h"
+#include "google/cloud/grpc_error_delegate.h"
+#include "google/cloud/log.h"
+#include <string>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+namespace spanner_proto = ::google::spanner::v1;
+
+using PartialResultSetReader =
+    grpc::ClientReaderInterface<spanner_proto::PartialResultSet>;
+
+bool IsSlow(RpcSamplingConfig const& config,
+            std::chrono::microseconds latency) {
+  return config.latency_threshold.count() > 0 &&
+         latency >= config.latency_threshold;
+}
+
+void Record(RpcTraceBuffer& buffer, char const* method,
+            std::chrono::microseconds latency, Status status,
+            std::string request, std::string response,
+            std::int64_t responses) {
+  RpcTraceRecord record{
+      method,
+      std::chrono::time_point_cast<std::chrono::system_clock::duration>(
+          std::chrono::system_clock::now() - latency),
+      latency,
+      std::move(status),
+      std::move(request),
+      std::move(response),
+      responses};
+  GCP_LOG(DEBUG) << record;
+  buffer.Push(std::move(record));
+}
+
+std::string ResponseString(Status const&, TracingOptions const&) { return {}; }
+
+template <typename T>
+std::string ResponseString(StatusOr<T> const& response,
+                           TracingOptions const& options) {
+  if (!response) return {};
+  return DebugString(*response, options);
+}
+
+/// Records a streaming call when it finishes, if it is selected.
+class SampledStreamReader : public ForwardingStreamReader {
+ public:
+  SampledStreamReader(std::unique_ptr<PartialResultSetReader> child,
+                      std::shared_ptr<RpcTraceBuffer> buffer,
+                      RpcSamplingConfig config, char const* method,
+                      std::chrono::steady_clock::time_point start,
+                      bool sampled, std::string request)
+      : ForwardingStreamReader(std::move(child)),
+        buffer_(std::move(buffer)),
+        config_(config),
+        method_(method),
+        start_(start),
+        sampled_(sampled),
+        request_(std::move(request)) {}
+
+  ~SampledStreamReader() override {
+    if (!finished_) Finished(Status(StatusCode::kCancelled, "not finished"));
+  }
+
+  bool Read(spanner_proto::PartialResultSet* response) override {
+    if (!ForwardingStreamReader::Read(response)) return false;
+    ++responses_;
+    return true;
+  }
+
+  grpc::Status Finish() override {
+    auto status = ForwardingStreamReader::Finish();
+    Finished(google::cloud::MakeStatusFromRpcError(status));
+    return status;
+  }
+
+ private:
+  void Finished(Status status) {
+    finished_ = true;
+    auto const latency = ElapsedSince(start_);
+    if (!sampled_ && !IsSlow(config_, latency)) return;
+    Record(*buffer_, method_, latency, std::move(status), std::move(request_),
+           {}, responses_);
+  }
+
+  std::shared_ptr<RpcTraceBuffer> buffer_;
+  RpcSamplingConfig config_;
+  char const* method_;
+  std::chrono::steady_clock::time_point start_;
+  bool sampled_;
+  std::string request_;
+  std::int64_t responses_ = 0;
+  bool finished_ = false;
+};
+
+}  // namespace
+
+bool SampledLoggingSpannerStub::SampleByRate() const {
+  if (config_.sample_rate <= 0) return false;
+  // A per-thread counter avoids contention between the threads.
+  thread_local std::int64_t calls = 0;
+  return ++calls % config_.sample_rate == 0;
+}
+
+template <typename Request, typename Functor>
+auto SampledLoggingSpannerStub::Unary(char const* method,
+                                      Request const& request, Functor&& functor)
+    -> decltype(functor()) {
+  auto const sampled = SampleByRate();
+  auto const start = std::chrono::steady_clock::now();
+  auto response = functor();
+  auto const latency = ElapsedSince(start);
+  if (sampled || IsSlow(config_, latency)) {
+    Record(*buffer_, method, latency, StatusOf(response),
+           DebugString(request, tracing_options_),
+           ResponseString(response, tracing_options_), 0);
+  }
+  return response;
+}
+
+template <typename Request, typename Functor>
+auto SampledLoggingSpannerStub::Streaming(char const* method,
+                                          Request const& request,
+                                          Functor&& functor)
+    -> decltype(functor()) {
+  auto const sampled = SampleByRate();
+  auto const start = std::chrono::steady_clock::now();
+  auto reader = functor();
+  if (!reader) return reader;
+  std::string request_string;
+  if (sampled) request_string = DebugString(request, tracing_options_);
+  return std::unique_ptr<PartialResultSetReader>(new SampledStreamReader(
+      std::move(reader), buffer_, config_, method, start, sampled,
+      std::move(request_string)));
+}
+
+StatusOr<spanner_proto::Session>
+SampledLoggingSpannerStub::CreateSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::CreateSessionRequest const& request) {
+  return Unary(__func__, request, [&] {
+    return child_->CreateSession(client_context, request);
+  });
+}
+
+StatusOr<spanner_proto::BatchCreateSessionsResponse>
+SampledLoggingSpannerStub::BatchCreateSessions(
+    grpc::ClientContext& client_context,
+    spanner_proto::BatchCreateSessionsRequest const& request) {
+  return Unary(__func__, request, [&] {
+    return child_->BatchCreateSessions(client_context, request);
+  });
+}
+
+std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+    spanner_proto::BatchCreateSessionsResponse>>
+SampledLoggingSpannerStub::AsyncBatchCreateSessions(
+    grpc::ClientContext& client_context,
+    spanner_proto::BatchCreateSessionsRequest const& request,
+    grpc::CompletionQueue* cq) {
+  return child_->AsyncBatchCreateSessions(client_context, request, cq);
+}
+
+StatusOr<spanner_proto::Session>
+SampledLoggingSpannerStub::GetSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::GetSessionRequest const& request) {
+  return Unary(__func__, request, [&] {
+    return child_->GetSession(client_context, request);
+  });
+}
+
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<spanner_proto::Session>>
+SampledLoggingSpannerStub::AsyncGetSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::GetSessionRequest const& request,
+    grpc::CompletionQueue* cq) {
+  return child_->AsyncGetSession(client_context, request, cq);
+}
+
+StatusOr<spanner_proto::ListSessionsResponse>
+SampledLoggingSpannerStub::ListSessions(
+    grpc::ClientContext& client_context,
+    spanner_proto::ListSessionsRequest const& request) {
+  return Unary(__func__, request, [&] {
+    return child_->ListSessions(client_context, request);
+  });
+}
+
+Status SampledLoggingSpannerStub::DeleteSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::DeleteSessionRequest const& request) {
+  return Unary(__func__, request, [&] {
+    return child_->DeleteSession(client_context, request);
+  });
+}
+
+std::unique_ptr<
+    grpc::ClientAsyncResponseReaderInterface<google::protobuf::Empty>>
+SampledLoggingSpannerStub::AsyncDeleteSession(
+    grpc::ClientContext& client_context,
+    spanner_proto::DeleteSessionRequest const& request,
+    grpc::CompletionQueue* cq) {
+  return child_->AsyncDeleteSession(client_context, request, cq);
+}
+
+StatusOr<spanner_proto::ResultSet>
+SampledLoggingSpannerStub::ExecuteSql(
+    grpc::ClientContext& client_context,
+    spanner_proto::ExecuteSqlRequest const& request) {
+  return Unary(__func__, request, [&] {
+    return child_->ExecuteSql(client_context, request);
+  });
+}
+
+std::unique_ptr<grpc::ClientReaderInterface<spanner_proto::PartialResultSet>>
+SampledLoggingSpannerStub::ExecuteStreamingSql(
+    grpc::ClientContext& client_context,
+    spanner_proto::ExecuteSqlRequest const& request) {
+  return Streaming(__func__, request, [&] {
+    return child_->ExecuteStreamingSql(client_context, request);
+  });
+}
+
+StatusOr<spanner_proto::ExecuteBatchDmlResponse>
+SampledLoggingSpannerStub::ExecuteBatchDml(
+    grpc::ClientContext& client_context,
+    spanner_proto::ExecuteBatchDmlRequest const& request) {
+  return Unary(__func__, request, [&] {
+    return child_->ExecuteBatchDml(client_context, request);
+  });
+}
+
+std::unique_ptr<grpc::ClientReaderInterface<spanner_proto::PartialResultSet>>
+SampledLoggingSpannerStub::StreamingRead(grpc::ClientContext& client_context,
+                                  spanner_proto::ReadRequest const& request) {
+  return Streaming(__func__, request, [&] {
+    return child_->StreamingRead(client_context, request);
+  });
+}
+
+StatusOr<spanner_proto::Transaction>
+SampledLoggingSpannerStub::BeginTransaction(
+    grpc::ClientContext& client_context,
+    spanner_proto::BeginTransactionRequest const& request) {
+  return Unary(__func__, request, [&] {
+    return child_->BeginTransaction(client_context, request);
+  });
+}
+
+StatusOr<spanner_proto::CommitResponse>
+SampledLoggingSpannerStub::Commit(
+    grpc::ClientContext& client_context,
+    spanner_proto::CommitRequest const& request) {
+  return Unary(__func__, request,
+               [&] { return child_->Commit(client_context, request); });
+}
+
+Status SampledLoggingSpannerStub::Rollback(
+    grpc::ClientContext& client_context,
+    spanner_proto::RollbackRequest const& request) {
+  return Unary(__func__, request,
+               [&] { return child_->Rollback(client_context, request); });
+}
+
+StatusOr<spanner_proto::PartitionResponse>
+SampledLoggingSpannerStub::PartitionQuery(
+    grpc::ClientContext& client_context,
+    spanner_proto::PartitionQueryRequest const& request) {
+  return Unary(__func__, request, [&] {
+    return child_->PartitionQuery(client_context, request);
+  });
+}
+
+StatusOr<spanner_proto::PartitionResponse>
+SampledLoggingSpannerStub::PartitionRead(
+    grpc::ClientContext& client_context,
+    spanner_proto::PartitionReadRequest const& request) {
+  return Unary(__func__, request, [&] {
+    return child_->PartitionRead(client_context, request);
+  });
+}
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,149 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_SAMPLED_LOGGING_SPANNER_STUB_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_SAMPLED_LOGGING_SPANNER_STUB_H
+
+#include "google/cloud/spanner/internal/spanner_stub.h"
+#include "google/cloud/spanner/rpc_trace_buffer.h"
+#include "google/cloud/spanner/tracing_options.h"
+#include "google/cloud/spanner/version.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+/// Select the RPCs traced by `SampledLoggingSpannerStub`.
+struct RpcSamplingConfig {
+  /// Trace one in every `sample_rate` calls (per thread), 0 disables this.
+  std::int64_t sample_rate;
+  /// Also trace the calls slower than this, 0 disables this.
+  std::chrono::microseconds latency_threshold;
+};
+
+/**
+ * A SpannerStub that logs a sample of the requests.
+ *
+ * Unlike `LoggingSpannerStub`, which formats every request and response, this
+ * stub only formats the calls selected by its `RpcSamplingConfig`: one in
+ * every N calls, and the calls slower than a threshold. The selected calls are
+ * logged and stored in an `RpcTraceBuffer`, which can be dumped to debug tail
+ * latency. The calls that are not selected only pay for reading the clock.
+ *
+ * Streaming calls are recorded when they finish. Their request is only
+ * captured if the call was sampled by rate, as the request is gone by the time
+ * the latency is known. The asynchronous calls are not traced.
+ */
+class SampledLoggingSpannerStub : public SpannerStub {
+ public:
+  SampledLoggingSpannerStub(std::shared_ptr<SpannerStub> child,
+                            RpcSamplingConfig config,
+                            std::shared_ptr<RpcTraceBuffer> buffer,
+                            TracingOptions tracing_options)
+      : child_(std::move(child)),
+        config_(config),
+        buffer_(std::move(buffer)),
+        tracing_options_(std::move(tracing_options)) {}
+  ~SampledLoggingSpannerStub() override = default;
+
+  StatusOr<google::spanner::v1::Session> CreateSession(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::CreateSessionRequest const& request) override;
+  StatusOr<google::spanner::v1::BatchCreateSessionsResponse>
+  BatchCreateSessions(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::BatchCreateSessionsRequest const& request) override;
+  std::unique_ptr<grpc::ClientAsyncResponseReaderInterface<
+      google::spanner::v1::BatchCreateSessionsResponse>>
+  AsyncBatchCreateSessions(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::BatchCreateSessionsRequest const& request,
+      grpc::CompletionQueue* cq) override;
+  StatusOr<google::spanner::v1::Session> GetSession(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::GetSessionRequest const& request) override;
+  std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<google::spanner::v1::Session>>
+  AsyncGetSession(grpc::ClientContext& client_context,
+                  google::spanner::v1::GetSessionRequest const& request,
+                  grpc::CompletionQueue* cq) override;
+  StatusOr<google::spanner::v1::ListSessionsResponse> ListSessions(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::ListSessionsRequest const& request) override;
+  Status DeleteSession(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::DeleteSessionRequest const& request) override;
+  std::unique_ptr<
+      grpc::ClientAsyncResponseReaderInterface<google::protobuf::Empty>>
+  AsyncDeleteSession(grpc::ClientContext& client_context,
+                     google::spanner::v1::DeleteSessionRequest const& request,
+                     grpc::CompletionQueue* cq) override;
+  StatusOr<google::spanner::v1::ResultSet> ExecuteSql(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::ExecuteSqlRequest const& request) override;
+  std::unique_ptr<
+      grpc::ClientReaderInterface<google::spanner::v1::PartialResultSet>>
+  ExecuteStreamingSql(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::ExecuteSqlRequest const& request) override;
+  StatusOr<google::spanner::v1::ExecuteBatchDmlResponse> ExecuteBatchDml(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::ExecuteBatchDmlRequest const& request) override;
+  std::unique_ptr<
+      grpc::ClientReaderInterface<google::spanner::v1::PartialResultSet>>
+  StreamingRead(grpc::ClientContext& client_context,
+                google::spanner::v1::ReadRequest const& request) override;
+  StatusOr<google::spanner::v1::Transaction> BeginTransaction(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::BeginTransactionRequest const& request) override;
+  StatusOr<google::spanner::v1::CommitResponse> Commit(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::CommitRequest const& request) override;
+  Status Rollback(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::RollbackRequest const& request) override;
+  StatusOr<google::spanner::v1::PartitionResponse> PartitionQuery(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::PartitionQueryRequest const& request) override;
+  StatusOr<google::spanner::v1::PartitionResponse> PartitionRead(
+      grpc::ClientContext& client_context,
+      google::spanner::v1::PartitionReadRequest const& request) override;
+
+ private:
+  bool SampleByRate() const;
+  template <typename Request, typename Functor>
+  auto Unary(char const* method, Request const& request, Functor&& functor)
+      -> decltype(functor());
+  template <typename Request, typename Functor>
+  auto Streaming(char const* method, Request const& request, Functor&& functor)
+      -> decltype(functor());
+
+  std::shared_ptr<SpannerStub> child_;
+  RpcSamplingConfig config_;
+  std::shared_ptr<RpcTraceBuffer> buffer_;
+  TracingOptions tracing_options_;
+};
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_SAMPLED_LOGGING_SPANNER_STUB_H
@@ -0,0 +1,179 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/sampled_logging_spanner_stub.h"
+#include "google/cloud/spanner/testing/mock_spanner_stub.h"
+#include "google/cloud/internal/make_unique.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <gmock/gmock.h>
+#include <chrono>
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::internal::make_unique;
+using ::testing::_;
+using ::testing::HasSubstr;
+using ::testing::Return;
+namespace spanner_proto = ::google::spanner::v1;
+
+class MockGrpcReader
+    : public ::grpc::ClientReaderInterface<spanner_proto::PartialResultSet> {
+ public:
+  MOCK_METHOD1(Read, bool(spanner_proto::PartialResultSet*));
+  MOCK_METHOD1(NextMessageSize, bool(std::uint32_t*));
+  MOCK_METHOD0(Finish, grpc::Status());
+  MOCK_METHOD0(WaitForInitialMetadata, void());
+};
+
+class SampledLoggingSpannerStubTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    mock_ = std::make_shared<spanner_testing::MockSpannerStub>();
+    buffer_ = std::make_shared<RpcTraceBuffer>(16);
+  }
+
+  std::shared_ptr<spanner_testing::MockSpannerStub> mock_;
+  std::shared_ptr<RpcTraceBuffer> buffer_;
+};
+
+RpcSamplingConfig SampleAll() {
+  return RpcSamplingConfig{1, std::chrono::microseconds(0)};
+}
+
+RpcSamplingConfig SampleNone() {
+  return RpcSamplingConfig{0, std::chrono::microseconds(0)};
+}
+
+TEST_F(SampledLoggingSpannerStubTest, Sampled) {
+  spanner_proto::Session session;
+  session.set_name("test-session-name");
+  EXPECT_CALL(*mock_, CreateSession(_, _)).WillOnce(Return(session));
+
+  SampledLoggingSpannerStub stub(mock_, SampleAll(), buffer_, TracingOptions{});
+  grpc::ClientContext context;
+  spanner_proto::CreateSessionRequest request;
+  request.set_database("test-database-name");
+  auto response = stub.CreateSession(context, request);
+  EXPECT_STATUS_OK(response);
+
+  auto const records = buffer_->Dump();
+  ASSERT_EQ(1, records.size());
+  EXPECT_EQ("CreateSession", records[0].method);
+  EXPECT_STATUS_OK(records[0].status);
+  EXPECT_THAT(records[0].request, HasSubstr("test-database-name"));
+  EXPECT_THAT(records[0].response, HasSubstr("test-session-name"));
+}
+
+TEST_F(SampledLoggingSpannerStubTest, NotSampled) {
+  EXPECT_CALL(*mock_, Rollback(_, _))
+      .WillOnce(Return(Status(StatusCode::kUnavailable, "try-again")));
+
+  SampledLoggingSpannerStub stub(mock_, SampleNone(), buffer_,
+                                 TracingOptions{});
+  grpc::ClientContext context;
+  auto status = stub.Rollback(context, spanner_proto::RollbackRequest());
+  EXPECT_EQ(StatusCode::kUnavailable, status.code());
+  EXPECT_TRUE(buffer_->Dump().empty());
+}
+
+TEST_F(SampledLoggingSpannerStubTest, SlowCall) {
+  EXPECT_CALL(*mock_, Commit(_, _))
+      .WillOnce([](grpc::ClientContext&, spanner_proto::CommitRequest const&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        return Status(StatusCode::kUnavailable, "try-again");
+      })
+      .WillOnce(Return(spanner_proto::CommitResponse()));
+
+  auto const config = RpcSamplingConfig{0, std::chrono::milliseconds(1)};
+  SampledLoggingSpannerStub stub(mock_, config, buffer_, TracingOptions{});
+  grpc::ClientContext context;
+  spanner_proto::CommitRequest request;
+  request.set_session("test-session-name");
+  auto response = stub.Commit(context, request);
+  EXPECT_EQ(StatusCode::kUnavailable, response.status().code());
+  // This call is fast enough, so it is not recorded.
+  response = stub.Commit(context, request);
+  EXPECT_STATUS_OK(response);
+
+  auto const records = buffer_->Dump();
+  ASSERT_EQ(1, records.size());
+  EXPECT_EQ("Commit", records[0].method);
+  EXPECT_EQ(StatusCode::kUnavailable, records[0].status.code());
+  EXPECT_GE(records[0].latency, std::chrono::milliseconds(2));
+  EXPECT_THAT(records[0].request, HasSubstr("test-session-name"));
+}
+
+TEST_F(SampledLoggingSpannerStubTest, Streaming) {
+  EXPECT_CALL(*mock_, StreamingRead(_, _))
+      .WillOnce([](grpc::ClientContext&, spanner_proto::ReadRequest const&) {
+        auto reader = make_unique<MockGrpcReader>();
+        EXPECT_CALL(*reader, Read(_))
+            .WillOnce(Return(true))
+            .WillOnce(Return(true))
+            .WillOnce(Return(false));
+        EXPECT_CALL(*reader, Finish()).WillOnce(Return(grpc::Status()));
+        return reader;
+      });
+
+  SampledLoggingSpannerStub stub(mock_, SampleAll(), buffer_, TracingOptions{});
+  grpc::ClientContext context;
+  spanner_proto::ReadRequest request;
+  request.set_table("test-table");
+  auto reader = stub.StreamingRead(context, request);
+  ASSERT_TRUE(reader);
+  spanner_proto::PartialResultSet r;
+  while (reader->Read(&r)) continue;
+  EXPECT_TRUE(buffer_->Dump().empty());
+  EXPECT_TRUE(reader->Finish().ok());
+
+  auto const records = buffer_->Dump();
+  ASSERT_EQ(1, records.size());
+  EXPECT_EQ("StreamingRead", records[0].method);
+  EXPECT_STATUS_OK(records[0].status);
+  EXPECT_EQ(2, records[0].responses);
+  EXPECT_THAT(records[0].request, HasSubstr("test-table"));
+}
+
+TEST_F(SampledLoggingSpannerStubTest, StreamingNotFinished) {
+  EXPECT_CALL(*mock_, ExecuteStreamingSql(_, _))
+      .WillOnce(
+          [](grpc::ClientContext&, spanner_proto::ExecuteSqlRequest const&) {
+            return make_unique<MockGrpcReader>();
+          });
+
+  SampledLoggingSpannerStub stub(mock_, SampleAll(), buffer_, TracingOptions{});
+  grpc::ClientContext context;
+  auto reader =
+      stub.ExecuteStreamingSql(context, spanner_proto::ExecuteSqlRequest());
+  ASSERT_TRUE(reader);
+  reader.reset();
+
+  auto const records = buffer_->Dump();
+  ASSERT_EQ(1, records.size());
+  EXPECT_EQ("ExecuteStreamingSql", records[0].method);
+  EXPECT_EQ(StatusCode::kCancelled, records[0].status.code());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -13,9 +13,11 @@
 // limitations under the License.
 
 #include "google/cloud/spanner/internal/session_pool.h"
+#include "google/cloud/spanner/internal/channel_health_spanner_stub.h"
 #include "google/cloud/spanner/internal/connection_impl.h"
 #include "google/cloud/spanner/internal/retry_loop.h"
 #include "google/cloud/spanner/internal/session.h"
+#include "google/cloud/spanner/internal/tracing.h"
 #include "google/cloud/completion_queue.h"
 #include "google/cloud/internal/async_retry_unary_rpc.h"
 #include "google/cloud/internal/make_unique.h"
@@ -23,6 +25,7 @@
 #include "google/cloud/status.h"
 #include <algorithm>
 #include <chrono>
+#include <iterator>
 #include <random>
 #include <thread>
 #include <utility>
@@ -41,10 +44,11 @@ std::shared_ptr<SessionPool> MakeSessionPool(
     SessionPoolOptions options, google::cloud::CompletionQueue cq,
     std::unique_ptr<RetryPolicy> retry_policy,
     std::unique_ptr<BackoffPolicy> backoff_policy,
-    std::shared_ptr<Session::Clock> clock) {
+    std::shared_ptr<Session::Clock> clock, SpannerStubFactory stub_factory) {
   auto pool = std::make_shared<SessionPool>(
       std::move(db), std::move(stubs), std::move(options), std::move(cq),
-      std::move(retry_policy), std::move(backoff_policy), std::move(clock));
+      std::move(retry_policy), std::move(backoff_policy), std::move(clock),
+      std::move(stub_factory));
   pool->Initialize();
   return pool;
 }
@@ -55,7 +59,8 @@ SessionPool::SessionPool(Database db,
                          google::cloud::CompletionQueue cq,
                          std::unique_ptr<RetryPolicy> retry_policy,
                          std::unique_ptr<BackoffPolicy> backoff_policy,
-                         std::shared_ptr<Session::Clock> clock)
+                         std::shared_ptr<Session::Clock> clock,
+                         SpannerStubFactory stub_factory)
     : db_(std::move(db)),
       options_(std::move(
           options.EnforceConstraints(static_cast<int>(stubs.size())))),
@@ -63,6 +68,7 @@ SessionPool::SessionPool(Database db,
       retry_policy_prototype_(std::move(retry_policy)),
       backoff_policy_prototype_(std::move(backoff_policy)),
       clock_(std::move(clock)),
+      stub_factory_(std::move(stub_factory)),
       max_pool_size_(options_.max_sessions_per_channel() *
                      static_cast<int>(stubs.size())),
       random_generator_(std::random_device()()) {
@@ -73,7 +79,15 @@ SessionPool::SessionPool(Database db,
 
   channels_.reserve(stubs.size());
   for (auto& stub : stubs) {
-    channels_.push_back(std::make_shared<Channel>(std::move(stub)));
+    auto const id = static_cast<int>(channels_.size());
+    if (!stub_factory_) {
+      channels_.push_back(std::make_shared<Channel>(std::move(stub), id));
+      continue;
+    }
+    auto health = std::make_shared<ChannelHealth>();
+    stub = std::make_shared<ChannelHealthSpannerStub>(std::move(stub), health);
+    channels_.push_back(
+        std::make_shared<Channel>(std::move(stub), id, std::move(health)));
   }
   // `channels_` is never resized after this point.
   next_dissociated_stub_channel_ = channels_.begin();
@@ -117,11 +131,41 @@ void SessionPool::ScheduleBackgroundWork(std::chrono::seconds relative_time) {
 }
 
 void SessionPool::DoBackgroundWork() {
+  CheckChannelHealth();
   MaintainPoolSize();
   RefreshExpiringSessions();
   ScheduleBackgroundWork(std::chrono::seconds(5));
 }
 
+// Mark the channels that were unhealthy since the last check, and recreate
+// them.
+void SessionPool::CheckChannelHealth() {
+  if (!stub_factory_) return;
+  // `channels_` is never resized, and each `Channel` is thread-safe.
+  std::vector<ChannelStats> stats;
+  stats.reserve(channels_.size());
+  for (auto const& channel : channels_) {
+    stats.push_back(channel->health->TakeStats());
+  }
+  for (auto i : FindUnhealthyChannels(stats)) {
+    channels_[i]->health->MarkUnhealthy();
+  }
+  // Recreate at most half of the channels (but at least one) at a time. When
+  // most channels look unhealthy the service, not the channels, is probably
+  // at fault, and reconnecting all of them would only add to its load. The
+  // remaining channels are still avoided, and recreated in the next checks.
+  auto recreate = (std::max)(channels_.size() / 2, std::size_t{1});
+  for (auto const& channel : channels_) {
+    if (recreate == 0) break;
+    if (!channel->unhealthy()) continue;
+    --recreate;
+    GCP_LOG(INFO) << "Recreating unhealthy channel " << channel->id;
+    channel->set_stub(std::make_shared<ChannelHealthSpannerStub>(
+        stub_factory_(channel->id, ++channel->generation), channel->health));
+    channel->health->Reset();
+  }
+}
+
 // Ensure the pool size conforms to what was specified in the `SessionOptions`,
 // creating or deleting sessions as necessary.
 void SessionPool::MaintainPoolSize() {
@@ -147,7 +191,7 @@ void SessionPool::RefreshExpiringSessions() {
       for (auto const& session : sessions_) {
         auto last_use_time = session->last_use_time();
         if (last_use_time <= refresh_limit) {
-          sessions_to_refresh.emplace_back(session->channel()->stub,
+          sessions_to_refresh.emplace_back(session->channel()->stub(),
                                            session->session_name());
           session->update_last_use_time();
         } else if (last_use_time < last_use_time_lower_bound_) {
@@ -266,12 +310,20 @@ Status SessionPool::CreateSessions(
 }
 
 StatusOr<SessionHolder> SessionPool::Allocate(bool dissociate_from_pool) {
+  ScopedSpan span("spanner.SessionPool.Allocate");
   std::unique_lock<std::mutex> lk(mu_);
   for (;;) {
     if (!sessions_.empty()) {
-      // return the most recently used session.
-      auto session = std::move(sessions_.back());
-      sessions_.pop_back();
+      // return the most recently used session, preferring healthy channels.
+      auto healthy = std::find_if(
+          sessions_.rbegin(), sessions_.rend(),
+          [](std::unique_ptr<Session> const& s) {
+            return !s->channel() || !s->channel()->unhealthy();
+          });
+      auto pos = healthy == sessions_.rend() ? sessions_.end() - 1
+                                             : std::next(healthy).base();
+      auto session = std::move(*pos);
+      sessions_.erase(pos);
       if (dissociate_from_pool) {
         --total_sessions_;
         auto const& channel = session->channel();
@@ -286,11 +338,19 @@ StatusOr<SessionHolder> SessionPool::Allocate(bool dissociate_from_pool) {
     // session to the pool then try again.
     if (total_sessions_ >= max_pool_size_) {
       if (options_.action_on_exhaustion() == ActionOnExhaustion::kFail) {
-        return Status(StatusCode::kResourceExhausted, "session pool exhausted");
+        Status status(StatusCode::kResourceExhausted, "session pool exhausted");
+        span.End(status);
+        return status;
+      }
+      if (!Wait(lk, [this] {
+            return !sessions_.empty() || total_sessions_ < max_pool_size_;
+          })) {
+        auto status = DeadlineExceededError(
+            __func__,
+            Status(StatusCode::kResourceExhausted, "session pool exhausted"));
+        span.End(status);
+        return status;
       }
-      Wait(lk, [this] {
-        return !sessions_.empty() || total_sessions_ < max_pool_size_;
-      });
       continue;
     }
 
@@ -301,9 +361,13 @@ StatusOr<SessionHolder> SessionPool::Allocate(bool dissociate_from_pool) {
     // simulaneous calls if additional sessions are needed. We can also use the
     // number of waiters in the `sessions_to_create` calculation below.
     if (create_calls_in_progress_ > 0) {
-      Wait(lk, [this] {
-        return !sessions_.empty() || create_calls_in_progress_ == 0;
-      });
+      if (!Wait(lk, [this] {
+            return !sessions_.empty() || create_calls_in_progress_ == 0;
+          })) {
+        auto status = DeadlineExceededError(__func__, Status());
+        span.End(status);
+        return status;
+      }
       continue;
     }
 
@@ -312,6 +376,7 @@ StatusOr<SessionHolder> SessionPool::Allocate(bool dissociate_from_pool) {
     auto status =
         Grow(lk, options_.min_sessions() + 1, WaitForSessionAllocation::kWait);
     if (!status.ok()) {
+      span.End(status);
       return status;
     }
   }
@@ -320,18 +385,58 @@ StatusOr<SessionHolder> SessionPool::Allocate(bool dissociate_from_pool) {
 std::shared_ptr<SpannerStub> SessionPool::GetStub(Session const& session) {
   auto const& channel = session.channel();
   if (channel) {
-    return channel->stub;
+    return channel->stub();
   }
 
   // Sessions that were created for partitioned Reads/Queries do not have
   // their own channel/stub; return a stub to use by round-robining between
   // the channels.
   std::unique_lock<std::mutex> lk(mu_);
-  auto stub = (*next_dissociated_stub_channel_)->stub;
-  if (++next_dissociated_stub_channel_ == channels_.end()) {
-    next_dissociated_stub_channel_ = channels_.begin();
+  return NextChannel()->stub();
+}
+
+std::function<SessionHolder()> SessionPool::HedgeSessionAllocator(
+    Session const& session) {
+  std::weak_ptr<SessionPool> pool = shared_from_this();
+  auto channel = session.channel();
+  return [pool, channel]() -> SessionHolder {
+    auto shared_pool = pool.lock();
+    if (!shared_pool) return nullptr;
+    return shared_pool->AllocateHedgeSession(channel);
+  };
+}
+
+SessionHolder SessionPool::AllocateHedgeSession(
+    std::shared_ptr<Channel> const& channel) {
+  std::unique_lock<std::mutex> lk(mu_);
+  auto const healthy = [](std::unique_ptr<Session> const& s) {
+    return !s->channel() || !s->channel()->unhealthy();
+  };
+  // The most recently used session on another channel, or on any channel.
+  auto pos = std::find_if(sessions_.rbegin(), sessions_.rend(),
+                          [&](std::unique_ptr<Session> const& s) {
+                            return healthy(s) && s->channel() != channel;
+                          });
+  if (pos == sessions_.rend()) {
+    pos = std::find_if(sessions_.rbegin(), sessions_.rend(), healthy);
+  }
+  if (pos == sessions_.rend()) return nullptr;
+  auto hedge = std::move(*pos);
+  sessions_.erase(std::next(pos).base());
+  return MakeSessionHolder(std::move(hedge), false);
+}
+
+std::shared_ptr<Channel> SessionPool::NextChannel() {
+  std::shared_ptr<Channel> fallback;
+  for (std::size_t i = 0; i != channels_.size(); ++i) {
+    auto channel = *next_dissociated_stub_channel_;
+    if (++next_dissociated_stub_channel_ == channels_.end()) {
+      next_dissociated_stub_channel_ = channels_.begin();
+    }
+    if (!channel->unhealthy()) return channel;
+    if (!fallback) fallback = std::move(channel);
   }
-  return stub;
+  return fallback;
 }
 
 void SessionPool::Release(std::unique_ptr<Session> session) {
@@ -363,7 +468,7 @@ Status SessionPool::CreateSessionsSync(
   request.mutable_session_template()->mutable_labels()->insert(labels.begin(),
                                                                labels.end());
   request.set_session_count(std::int32_t{num_sessions});
-  auto const& stub = channel->stub;
+  auto const stub = channel->stub();
   auto response = RetryLoop(
       retry_policy_prototype_->clone(), backoff_policy_prototype_->clone(),
       true,
@@ -379,7 +484,7 @@ void SessionPool::CreateSessionsAsync(
     std::shared_ptr<Channel> const& channel,
     std::map<std::string, std::string> const& labels, int num_sessions) {
   std::weak_ptr<SessionPool> pool = shared_from_this();
-  AsyncBatchCreateSessions(cq_, channel->stub, labels, num_sessions)
+  AsyncBatchCreateSessions(cq_, channel->stub(), labels, num_sessions)
       .then([pool, channel](
                 future<StatusOr<spanner_proto::BatchCreateSessionsResponse>>
                     result) {
@@ -18,6 +18,7 @@
 #include "google/cloud/spanner/backoff_policy.h"
 #include "google/cloud/spanner/database.h"
 #include "google/cloud/spanner/internal/channel.h"
+#include "google/cloud/spanner/internal/deadline.h"
 #include "google/cloud/spanner/internal/session.h"
 #include "google/cloud/spanner/internal/spanner_stub.h"
 #include "google/cloud/spanner/retry_policy.h"
@@ -30,6 +31,7 @@
 #include <chrono>
 #include <condition_variable>
 #include <cstddef>
+#include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -57,6 +59,11 @@ struct SessionPoolFriendForTest;
  * Allocation from the pool is LIFO to take advantage of the fact the Spanner
  * backends maintain a cache of sessions which is valid for 30 seconds, so
  * re-using Sessions as quickly as possible has performance advantages.
+ *
+ * If the pool can recreate its stubs, it also tracks the health of each
+ * channel, see `MakeSessionPool()`. Sessions on an unhealthy channel are not
+ * allocated while there are sessions on other channels, and the unhealthy
+ * channels are recreated in the background.
  */
 class SessionPool : public std::enable_shared_from_this<SessionPool> {
  public:
@@ -70,7 +77,8 @@ class SessionPool : public std::enable_shared_from_this<SessionPool> {
               SessionPoolOptions options, google::cloud::CompletionQueue cq,
               std::unique_ptr<RetryPolicy> retry_policy,
               std::unique_ptr<BackoffPolicy> backoff_policy,
-              std::shared_ptr<Session::Clock> clock);
+              std::shared_ptr<Session::Clock> clock,
+              SpannerStubFactory stub_factory = {});
 
   ~SessionPool();
 
@@ -99,6 +107,18 @@ class SessionPool : public std::enable_shared_from_this<SessionPool> {
    */
   std::shared_ptr<SpannerStub> GetStub(Session const& session);
 
+  /**
+   * Return a function that allocates an idle `Session` to send a duplicate of
+   * a call made using @p session, preferring a session on a different
+   * (healthy) channel.
+   *
+   * Unlike `Allocate()` the function never waits for a session, nor creates
+   * new ones: a duplicate is only worth sending if it can start right away.
+   * It returns `nullptr` if no session on a healthy channel is idle. The
+   * function does not keep @p session, nor this pool, alive.
+   */
+  std::function<SessionHolder()> HedgeSessionAllocator(Session const& session);
+
  private:
   // Represents a request to create `session_count` sessions on `channel`
   // See `ComputeCreateCounts` and `CreateSessions`.
@@ -111,13 +131,24 @@ class SessionPool : public std::enable_shared_from_this<SessionPool> {
   // Release session back to the pool.
   void Release(std::unique_ptr<Session> session);
 
+  // See `HedgeSessionAllocator()`.
+  SessionHolder AllocateHedgeSession(std::shared_ptr<Channel> const& channel);
+
   // Called when a thread needs to wait for a `Session` to become available.
-  // @p specifies the condition to wait for.
+  // @p specifies the condition to wait for. Returns false if the deadline of
+  // the current operation expired first.
   template <typename Predicate>
-  void Wait(std::unique_lock<std::mutex>& lk, Predicate&& p) {
+  bool Wait(std::unique_lock<std::mutex>& lk, Predicate&& p) {
+    auto const deadline = CurrentDeadline().deadline;
+    bool ready = true;
     ++num_waiting_for_session_;
-    cond_.wait(lk, std::forward<Predicate>(p));
+    if (deadline == std::chrono::system_clock::time_point::max()) {
+      cond_.wait(lk, std::forward<Predicate>(p));
+    } else {
+      ready = cond_.wait_until(lk, deadline, std::forward<Predicate>(p));
+    }
     --num_waiting_for_session_;
+    return ready;
   }
 
   Status Grow(std::unique_lock<std::mutex>& lk, int sessions_to_create,
@@ -156,8 +187,13 @@ class SessionPool : public std::enable_shared_from_this<SessionPool> {
 
   void UpdateNextChannelForCreateSessions();  // EXCLUSIVE_LOCKS_REQUIRED(mu_)
 
+  // Round-robin over the channels, skipping the unhealthy channels unless
+  // all of them are.
+  std::shared_ptr<Channel> NextChannel();  // EXCLUSIVE_LOCKS_REQUIRED(mu_)
+
   void ScheduleBackgroundWork(std::chrono::seconds relative_time);
   void DoBackgroundWork();
+  void CheckChannelHealth();
   void MaintainPoolSize();
   void RefreshExpiringSessions();
 
@@ -167,6 +203,7 @@ class SessionPool : public std::enable_shared_from_this<SessionPool> {
   std::unique_ptr<RetryPolicy const> retry_policy_prototype_;
   std::unique_ptr<BackoffPolicy const> backoff_policy_prototype_;
   std::shared_ptr<Session::Clock> clock_;
+  SpannerStubFactory const stub_factory_;
   int const max_pool_size_;
   std::mt19937 random_generator_;
 
@@ -197,13 +234,19 @@ class SessionPool : public std::enable_shared_from_this<SessionPool> {
  * The parameters allow the `SessionPool` to make remote calls needed to manage
  * the pool, and to associate `Session`s with the stubs used to create them.
  * `stubs` must not be empty.
+ *
+ * If @p stub_factory is set, the pool tracks the health of each channel, from
+ * the error rates and the latency of its calls, and replaces the stub of an
+ * unhealthy channel `i` with `stub_factory(i, n)`, where `n` counts the times
+ * the channel was recreated.
  */
 std::shared_ptr<SessionPool> MakeSessionPool(
     Database db, std::vector<std::shared_ptr<SpannerStub>> stubs,
     SessionPoolOptions options, google::cloud::CompletionQueue cq,
     std::unique_ptr<RetryPolicy> retry_policy,
     std::unique_ptr<BackoffPolicy> backoff_policy,
-    std::shared_ptr<Session::Clock> clock = std::make_shared<Session::Clock>());
+    std::shared_ptr<Session::Clock> clock = std::make_shared<Session::Clock>(),
+    SpannerStubFactory stub_factory = {});
 
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
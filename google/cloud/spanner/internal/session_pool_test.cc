@@ -13,9 +13,13 @@
 // limitations under the License.
 
 #include "google/cloud/spanner/internal/session_pool.h"
+#include "google/cloud/spanner/internal/channel_health.h"
 #include "google/cloud/spanner/internal/clock.h"
+#include "google/cloud/spanner/internal/deadline.h"
 #include "google/cloud/spanner/internal/session.h"
+#include "google/cloud/spanner/internal/tracing.h"
 #include "google/cloud/spanner/testing/fake_clock.h"
+#include "google/cloud/spanner/testing/in_memory_tracer.h"
 #include "google/cloud/spanner/testing/mock_spanner_stub.h"
 #include "google/cloud/internal/background_threads_impl.h"
 #include "google/cloud/internal/make_unique.h"
@@ -28,6 +32,7 @@
 #include <memory>
 #include <string>
 #include <thread>
+#include <utility>
 #include <vector>
 
 namespace google {
@@ -38,10 +43,12 @@ namespace internal {
 namespace {
 
 using ::google::cloud::spanner_testing::FakeSteadyClock;
+using ::google::cloud::spanner_testing::InMemoryTracer;
 using ::google::cloud::testing_util::MockAsyncResponseReader;
 using ::google::cloud::testing_util::MockCompletionQueue;
 using ::testing::_;
 using ::testing::ByMove;
+using ::testing::ElementsAre;
 using ::testing::HasSubstr;
 using ::testing::Invoke;
 using ::testing::Return;
@@ -75,14 +82,15 @@ spanner_proto::BatchCreateSessionsResponse MakeSessionsResponse(
 std::shared_ptr<SessionPool> MakeSessionPool(
     Database db, std::vector<std::shared_ptr<SpannerStub>> stubs,
     SessionPoolOptions options, CompletionQueue cq,
-    std::shared_ptr<SteadyClock> clock = std::make_shared<SteadyClock>()) {
+    std::shared_ptr<SteadyClock> clock = std::make_shared<SteadyClock>(),
+    SpannerStubFactory stub_factory = {}) {
   return MakeSessionPool(
       std::move(db), std::move(stubs), std::move(options), std::move(cq),
       google::cloud::internal::make_unique<LimitedTimeRetryPolicy>(
           std::chrono::minutes(10)),
       google::cloud::internal::make_unique<ExponentialBackoffPolicy>(
           std::chrono::milliseconds(100), std::chrono::minutes(1), 2.0),
-      std::move(clock));
+      std::move(clock), std::move(stub_factory));
 }
 
 TEST(SessionPool, Allocate) {
@@ -276,6 +284,38 @@ TEST(SessionPool, MaxSessionsFailOnExhaustion) {
   EXPECT_EQ(session.status().message(), "session pool exhausted");
 }
 
+TEST(SessionPool, AllocateTraced) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto db = Database("project", "instance", "database");
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1"}))));
+
+  SessionPoolOptions options;
+  options.set_max_sessions_per_channel(1).set_action_on_exhaustion(
+      ActionOnExhaustion::kFail);
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto pool = MakeSessionPool(db, {mock}, options, threads.cq());
+  auto tracer = std::make_shared<InMemoryTracer>();
+  {
+    ScopedSpan root(tracer, "root");
+    auto s1 = pool->Allocate();
+    ASSERT_STATUS_OK(s1);
+    auto s2 = pool->Allocate();
+    EXPECT_EQ(StatusCode::kResourceExhausted, s2.status().code());
+  }
+
+  EXPECT_THAT(tracer->SpanNames(),
+              ElementsAre("root", "spanner.SessionPool.Allocate",
+                          "spanner.RetryAttempt",
+                          "spanner.SessionPool.Allocate"));
+  auto const spans = tracer->Spans();
+  EXPECT_EQ(0, spans[1].parent);
+  EXPECT_STATUS_OK(spans[1].status);
+  EXPECT_EQ(1, spans[2].parent);
+  EXPECT_EQ(0, spans[3].parent);
+  EXPECT_EQ(StatusCode::kResourceExhausted, spans[3].status.code());
+}
+
 TEST(SessionPool, MaxSessionsBlockUntilRelease) {
   int const max_sessions_per_channel = 1;
   auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
@@ -303,6 +343,29 @@ TEST(SessionPool, MaxSessionsBlockUntilRelease) {
   t.join();
 }
 
+TEST(SessionPool, MaxSessionsBlockUntilDeadline) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto db = Database("project", "instance", "database");
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1"}))));
+
+  SessionPoolOptions options;
+  options.set_max_sessions_per_channel(1).set_action_on_exhaustion(
+      ActionOnExhaustion::kBlock);
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  auto pool = MakeSessionPool(db, {mock}, options, threads.cq());
+  auto session = pool->Allocate();
+  ASSERT_STATUS_OK(session);
+
+  // Nobody releases s1, so this gives up at the deadline.
+  ScopedDeadline deadline(OperationDeadline{
+      std::chrono::system_clock::now() + std::chrono::milliseconds(10),
+      std::chrono::milliseconds(0)});
+  auto blocked = pool->Allocate();
+  EXPECT_EQ(StatusCode::kDeadlineExceeded, blocked.status().code());
+  EXPECT_THAT(blocked.status().message(), HasSubstr("session pool exhausted"));
+}
+
 TEST(SessionPool, Labels) {
   auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
   auto db = Database("project", "instance", "database");
@@ -393,6 +456,167 @@ TEST(SessionPool, GetStubForStublessSession) {
   EXPECT_EQ(pool->GetStub(*session), mock);
 }
 
+TEST(SessionPool, AllocateHedgeSession) {
+  auto mock1 = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto mock2 = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto db = Database("project", "instance", "database");
+  EXPECT_CALL(*mock1, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"c1s1"}))));
+  EXPECT_CALL(*mock2, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"c2s1"}))));
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  SessionPoolOptions options;
+  options.set_min_sessions(2);
+  auto pool = MakeSessionPool(db, {mock1, mock2}, options, threads.cq());
+  auto session = pool->Allocate();
+  ASSERT_STATUS_OK(session);
+  auto allocate_hedge = pool->HedgeSessionAllocator(**session);
+  // The hedge gets the idle session, which is on the other channel.
+  auto hedge = allocate_hedge();
+  ASSERT_NE(nullptr, hedge);
+  EXPECT_NE((*session)->session_name(), hedge->session_name());
+  EXPECT_NE(pool->GetStub(**session), pool->GetStub(*hedge));
+
+  // There are no idle sessions left, and the hedge does not create any.
+  EXPECT_EQ(nullptr, allocate_hedge());
+
+  // The hedge session goes back to the pool.
+  auto const hedge_name = hedge->session_name();
+  hedge.reset();
+  hedge = allocate_hedge();
+  ASSERT_NE(nullptr, hedge);
+  EXPECT_EQ(hedge_name, hedge->session_name());
+}
+
+TEST(SessionPool, AllocateHedgeSessionSingleChannel) {
+  auto mock = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto db = Database("project", "instance", "database");
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1", "s2"}))));
+
+  google::cloud::internal::AutomaticallyCreatedBackgroundThreads threads;
+  SessionPoolOptions options;
+  options.set_min_sessions(2);
+  auto pool = MakeSessionPool(db, {mock}, options, threads.cq());
+  auto session = pool->Allocate();
+  ASSERT_STATUS_OK(session);
+  // With a single channel the hedge uses another session on that channel.
+  auto hedge = pool->HedgeSessionAllocator(**session)();
+  ASSERT_NE(nullptr, hedge);
+  EXPECT_NE((*session)->session_name(), hedge->session_name());
+  EXPECT_EQ(mock, pool->GetStub(*hedge));
+}
+
+TEST(SessionPool, AllocateAvoidsUnhealthyChannel) {
+  auto mock1 = std::make_shared<spanner_testing::MockSpannerStub>();
+  auto mock2 = std::make_shared<spanner_testing::MockSpannerStub>();
+  EXPECT_CALL(*mock1, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"c1s1"}))));
+  EXPECT_CALL(*mock2, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"c2s1"}))));
+  EXPECT_CALL(*mock1, Commit(_, _))
+      .Times(ChannelHealth::kConsecutiveFailures)
+      .WillRepeatedly(Return(Status(StatusCode::kUnavailable, "try-again")));
+
+  auto db = Database("project", "instance", "database");
+  // Use a `MockCompletionQueue` so the background work never runs.
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto pool = MakeSessionPool(
+      db, {mock1, mock2}, {}, CompletionQueue(impl),
+      std::make_shared<SteadyClock>(),
+      [](int, int) {
+        return std::make_shared<spanner_testing::MockSpannerStub>();
+      });
+  {
+    std::vector<SessionHolder> sessions;
+    for (int i = 0; i != 2; ++i) {
+      auto session = pool->Allocate();
+      ASSERT_STATUS_OK(session);
+      sessions.push_back(*std::move(session));
+    }
+    // Release "c1s1" last, so it would be the next one allocated.
+    if (sessions[0]->session_name() == "c1s1") {
+      std::swap(sessions[0], sessions[1]);
+    }
+    ASSERT_EQ("c1s1", sessions[1]->session_name());
+
+    // The calls go through a stub that watches the health of the channel.
+    auto stub = pool->GetStub(*sessions[1]);
+    EXPECT_NE(stub, mock1);
+    for (int i = 0; i != ChannelHealth::kConsecutiveFailures; ++i) {
+      grpc::ClientContext context;
+      auto response = stub->Commit(context, spanner_proto::CommitRequest{});
+      EXPECT_EQ(StatusCode::kUnavailable, response.status().code());
+    }
+    sessions[0].reset();
+    sessions[1].reset();
+  }
+
+  auto session = pool->Allocate();
+  ASSERT_STATUS_OK(session);
+  EXPECT_EQ("c2s1", (*session)->session_name());
+  // Dissociated sessions avoid the unhealthy channel too.
+  auto other = pool->GetStub(*MakeDissociatedSessionHolder("session_id"));
+  EXPECT_EQ(other, pool->GetStub(**session));
+  // And so do hedges, even if that leaves them without a session.
+  EXPECT_EQ(nullptr, pool->HedgeSessionAllocator(**session)());
+}
+
+TEST(SessionPool, RecreateUnhealthyChannel) {
+  auto mock = std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+  EXPECT_CALL(*mock, BatchCreateSessions(_, _))
+      .WillOnce(Return(ByMove(MakeSessionsResponse({"s1"}))));
+  EXPECT_CALL(*mock, Commit(_, _))
+      .Times(ChannelHealth::kConsecutiveFailures)
+      .WillRepeatedly(Return(Status(StatusCode::kUnavailable, "try-again")));
+  auto replacement =
+      std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
+  EXPECT_CALL(*replacement, Commit(_, _))
+      .WillOnce(Return(spanner_proto::CommitResponse{}))
+      .WillRepeatedly(Return(Status(StatusCode::kUnavailable, "try-again")));
+
+  std::vector<std::pair<int, int>> recreated;
+  auto db = Database("project", "instance", "database");
+  auto impl = std::make_shared<MockCompletionQueue>();
+  auto pool = MakeSessionPool(db, {mock}, {}, CompletionQueue(impl),
+                              std::make_shared<FakeSteadyClock>(),
+                              [&](int channel_id, int generation) {
+                                recreated.emplace_back(channel_id, generation);
+                                return replacement;
+                              });
+
+  auto session = pool->Allocate();
+  ASSERT_STATUS_OK(session);
+  auto commit = [&] {
+    grpc::ClientContext context;
+    return pool->GetStub(**session)->Commit(context,
+                                            spanner_proto::CommitRequest{});
+  };
+  for (int i = 0; i != ChannelHealth::kConsecutiveFailures; ++i) {
+    EXPECT_EQ(StatusCode::kUnavailable, commit().status().code());
+  }
+
+  // Run the background work, which recreates the unhealthy channel. The
+  // session stays on the channel, and uses the new stub.
+  impl->SimulateCompletion(true);
+  EXPECT_THAT(recreated, ElementsAre(std::make_pair(0, 1)));
+  EXPECT_STATUS_OK(commit());
+
+  // A healthy channel is left alone.
+  impl->SimulateCompletion(true);
+  EXPECT_THAT(recreated, ElementsAre(std::make_pair(0, 1)));
+
+  // Each time the channel is recreated it gets a new generation, so it does
+  // not share the connections of the previous channels.
+  for (int i = 0; i != ChannelHealth::kConsecutiveFailures; ++i) {
+    EXPECT_EQ(StatusCode::kUnavailable, commit().status().code());
+  }
+  impl->SimulateCompletion(true);
+  EXPECT_THAT(recreated,
+              ElementsAre(std::make_pair(0, 1), std::make_pair(0, 2)));
+}
+
 TEST(SessionPool, SessionRefresh) {
   auto mock = std::make_shared<StrictMock<spanner_testing::MockSpannerStub>>();
   EXPECT_CALL(*mock, BatchCreateSessions(_, _))
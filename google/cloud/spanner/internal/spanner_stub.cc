@@ -15,6 +15,8 @@
 #include "google/cloud/spanner/internal/spanner_stub.h"
 #include "google/cloud/spanner/internal/logging_spanner_stub.h"
 #include "google/cloud/spanner/internal/metadata_spanner_stub.h"
+#include "google/cloud/spanner/internal/metrics_spanner_stub.h"
+#include "google/cloud/spanner/internal/sampled_logging_spanner_stub.h"
 #include "google/cloud/grpc_error_delegate.h"
 #include "google/cloud/log.h"
 #include <google/spanner/v1/spanner.grpc.pb.h>
@@ -284,14 +286,21 @@ StatusOr<spanner_proto::PartitionResponse> DefaultSpannerStub::PartitionRead(
 
 }  // namespace
 
-std::shared_ptr<SpannerStub> CreateDefaultSpannerStub(ConnectionOptions options,
-                                                      int channel_id) {
+std::shared_ptr<SpannerStub> CreateDefaultSpannerStub(
+    ConnectionOptions options, int channel_id,
+    ConnectionTuningOptions const& tuning_options, int generation) {
   options = internal::EmulatorOverrides(std::move(options));
 
   grpc::ChannelArguments channel_arguments = options.CreateChannelArguments();
   // Newer versions of gRPC include a macro (`GRPC_ARG_CHANNEL_ID`) but use
   // its value here to allow compiling against older versions.
   channel_arguments.SetInt("grpc.channel_id", channel_id);
+  // gRPC shares the connections of the channels with the same arguments, so
+  // a recreated channel needs a new argument to get away from a bad one.
+  if (generation != 0) {
+    channel_arguments.SetInt("google.cloud.spanner.channel_generation",
+                             generation);
+  }
 
   auto spanner_grpc_stub =
       spanner_proto::Spanner::NewStub(grpc::CreateCustomChannel(
@@ -300,12 +309,22 @@ std::shared_ptr<SpannerStub> CreateDefaultSpannerStub(ConnectionOptions options,
   std::shared_ptr<SpannerStub> stub =
       std::make_shared<DefaultSpannerStub>(std::move(spanner_grpc_stub));
   stub = std::make_shared<MetadataSpannerStub>(std::move(stub));
+  stub = std::make_shared<MetricsSpannerStub>(std::move(stub),
+                                              DefaultSpannerRpcMetrics());
 
   if (options.tracing_enabled("rpc")) {
     GCP_LOG(INFO) << "Enabled logging for gRPC calls";
     return std::make_shared<LoggingSpannerStub>(std::move(stub),
                                                 options.tracing_options());
   }
+  if (tuning_options.rpc_trace_buffer()) {
+    GCP_LOG(INFO) << "Enabled sampled logging for gRPC calls";
+    return std::make_shared<SampledLoggingSpannerStub>(
+        std::move(stub),
+        RpcSamplingConfig{tuning_options.rpc_sample_rate(),
+                          tuning_options.rpc_slow_threshold()},
+        tuning_options.rpc_trace_buffer(), options.tracing_options());
+  }
   return stub;
 }
 
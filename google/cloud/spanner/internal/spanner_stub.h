@@ -16,6 +16,7 @@
 #define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_SPANNER_STUB_H
 
 #include "google/cloud/spanner/connection_options.h"
+#include "google/cloud/spanner/connection_tuning_options.h"
 #include "google/cloud/spanner/version.h"
 #include "google/cloud/completion_queue.h"
 #include "google/cloud/status.h"
@@ -23,6 +24,7 @@
 #include <google/spanner/v1/spanner.grpc.pb.h>
 #include <google/spanner/v1/spanner.pb.h>
 #include <grpcpp/grpcpp.h>
+#include <functional>
 #include <memory>
 
 namespace google {
@@ -120,10 +122,22 @@ class SpannerStub {
  * Creates a SpannerStub configured with @p options and @p channel_id.
  *
  * @p channel_id should be unique among all stubs in the same Connection pool,
- * to ensure they use different underlying connections.
+ * to ensure they use different underlying connections. If
+ * @p tuning_options has an `rpc_trace_buffer()`, the stub records a sample of
+ * the RPCs in it. A non-zero @p generation, which should be different each
+ * time a channel is recreated, makes gRPC open new connections rather than
+ * reuse those of the previous channels.
  */
-std::shared_ptr<SpannerStub> CreateDefaultSpannerStub(ConnectionOptions options,
-                                                      int channel_id);
+std::shared_ptr<SpannerStub> CreateDefaultSpannerStub(
+    ConnectionOptions options, int channel_id,
+    ConnectionTuningOptions const& tuning_options = {}, int generation = 0);
+
+/**
+ * Creates a new SpannerStub for the channel @p channel_id of a Connection,
+ * when it is recreated for the @p generation -th time.
+ */
+using SpannerStubFactory =
+    std::function<std::shared_ptr<SpannerStub>(int channel_id, int generation)>;
 
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
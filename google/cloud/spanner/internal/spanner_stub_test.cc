@@ -62,6 +62,30 @@ TEST(SpannerStub, CreateDefaultStubWithLogging) {
   google::cloud::LogSink::Instance().RemoveBackend(id);
 }
 
+TEST(SpannerStub, CreateDefaultStubWithSampling) {
+  auto buffer = std::make_shared<RpcTraceBuffer>(16);
+  auto const tuning_options = ConnectionTuningOptions{}
+                                  .set_rpc_trace_buffer(buffer)
+                                  .set_rpc_sample_rate(1);
+  auto stub = CreateDefaultSpannerStub(
+      ConnectionOptions(grpc::InsecureChannelCredentials())
+          .set_endpoint("localhost:1"),
+      /*channel_id=*/0, tuning_options);
+  EXPECT_NE(stub, nullptr);
+
+  grpc::ClientContext context;
+  context.set_deadline(std::chrono::system_clock::now() +
+                       std::chrono::milliseconds(5));
+  auto session =
+      stub->CreateSession(context, google::spanner::v1::CreateSessionRequest());
+  EXPECT_FALSE(session.ok());
+
+  auto const records = buffer->Dump();
+  ASSERT_EQ(1, records.size());
+  EXPECT_EQ("CreateSession", records[0].method);
+  EXPECT_EQ(session.status().code(), records[0].status.code());
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
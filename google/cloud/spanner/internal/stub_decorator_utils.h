@@ -0,0 +1,87 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_STUB_DECORATOR_UTILS_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_STUB_DECORATOR_UTILS_H
+
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/status.h"
+#include "google/cloud/status_or.h"
+#include <google/spanner/v1/spanner.pb.h>
+#include <grpcpp/grpcpp.h>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+/// The status of the result of a unary `SpannerStub` call.
+inline Status const& StatusOf(Status const& status) { return status; }
+
+/// @copydoc StatusOf(Status const&)
+template <typename T>
+Status const& StatusOf(StatusOr<T> const& response) {
+  return response.status();
+}
+
+/// The time elapsed since @p start, in microseconds.
+inline std::chrono::microseconds ElapsedSince(
+    std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start);
+}
+
+/**
+ * A streaming reader that forwards every call to another reader.
+ *
+ * The `SpannerStub` decorators derive from this class to observe the streaming
+ * calls, overriding only the member functions they are interested in.
+ */
+class ForwardingStreamReader
+    : public grpc::ClientReaderInterface<
+          google::spanner::v1::PartialResultSet> {
+ public:
+  using Reader =
+      grpc::ClientReaderInterface<google::spanner::v1::PartialResultSet>;
+
+  explicit ForwardingStreamReader(std::unique_ptr<Reader> child)
+      : child_(std::move(child)) {}
+
+  bool Read(google::spanner::v1::PartialResultSet* response) override {
+    return child_->Read(response);
+  }
+
+  bool NextMessageSize(std::uint32_t* sz) override {
+    return child_->NextMessageSize(sz);
+  }
+
+  grpc::Status Finish() override { return child_->Finish(); }
+
+  void WaitForInitialMetadata() override { child_->WaitForInitialMetadata(); }
+
+ private:
+  std::unique_ptr<Reader> child_;
+};
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_STUB_DECORATOR_UTILS_H
@@ -88,21 +88,73 @@ char const* ParseInt(char const* dp, T min, T max, T* vp) {
   return dp;
 }
 
-inline bool LeapYear(int y) {
+inline bool LeapYear(std::intmax_t y) {
   return y % 4 == 0 && (y % 100 != 0 || y % 400 == 0);
 }
 
-// Note: tm.tm_year and tm.tm_mon are unadjusted (i.e., have true values).
-bool ValidDay(std::tm const& tm) {
+// Note: `year` and tm.tm_mon are unadjusted (i.e., have true values).
+bool ValidDay(std::intmax_t year, std::tm const& tm) {
   static constexpr std::array<int, 1 + 12> kMonthDays = {
       {-1, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31}  // non leap year
   };
-  if (tm.tm_mon == 2 && LeapYear(tm.tm_year)) {
+  if (tm.tm_mon == 2 && LeapYear(year)) {
     return tm.tm_mday <= 29;
   }
   return tm.tm_mday <= kMonthDays[tm.tm_mon];
 }
 
+inline bool IsDigit(char c) { return static_cast<unsigned>(c - '0') < 10; }
+
+// Parses two digits known to satisfy IsDigit().
+inline int Parse2d(char const* dp) {
+  return (dp[0] - '0') * 10 + (dp[1] - '0');
+}
+
+// The canonical "%Y-%m-%dT%H:%M:%S" rendering for years in [0 .. 9999], with
+// 'd' marking the positions that must hold a digit.
+constexpr char kFixedLayout[] = "dddd-dd-ddTdd:dd:dd";
+constexpr std::size_t kFixedLayoutSize = sizeof(kFixedLayout) - 1;
+
+// Parses `s` if it starts with the canonical fixed-width layout, which is
+// what Spanner always sends. Validating against a layout table lets us avoid
+// the general field-by-field parse (and its range checks on the separators).
+// Returns std::string::npos if `s` does not match, in which case the caller
+// should fall back to the general parser.
+std::size_t ParseFixedTime(std::string const& s, std::tm* tm) {
+  if (s.size() < kFixedLayoutSize) return std::string::npos;
+  char const* const dp = s.data();
+  for (std::size_t i = 0; i != kFixedLayoutSize; ++i) {
+    char const c = dp[i];
+    bool const ok = kFixedLayout[i] == 'd'
+                        ? IsDigit(c)
+                        : (c == kFixedLayout[i] || (i == 10 && c == 't'));
+    if (!ok) return std::string::npos;
+  }
+  // A digit immediately after the seconds means this is not the canonical
+  // layout after all (e.g., a 3-digit seconds field), so let the general
+  // parser report the error.
+  if (s.size() > kFixedLayoutSize && IsDigit(dp[kFixedLayoutSize])) {
+    return std::string::npos;
+  }
+  std::tm tmp{};
+  tmp.tm_year = Parse2d(dp) * 100 + Parse2d(dp + 2);
+  tmp.tm_mon = Parse2d(dp + 5);
+  tmp.tm_mday = Parse2d(dp + 8);
+  tmp.tm_hour = Parse2d(dp + 11);
+  tmp.tm_min = Parse2d(dp + 14);
+  tmp.tm_sec = Parse2d(dp + 17);
+  // The tm_sec range allows for a positive leap second (see ParseTime()).
+  if (tmp.tm_mon < 1 || tmp.tm_mon > 12 || tmp.tm_mday < 1 ||
+      !ValidDay(tmp.tm_year, tmp) || tmp.tm_hour > 23 || tmp.tm_min > 59 ||
+      tmp.tm_sec > 60) {
+    return std::string::npos;
+  }
+  tmp.tm_year -= 1900;
+  tmp.tm_mon -= 1;
+  *tm = tmp;
+  return kFixedLayoutSize;
+}
+
 }  // namespace
 
 std::string FormatTime(char const* fmt, std::tm const& tm) {
@@ -182,6 +234,9 @@ std::size_t ParseTime(char const* fmt, std::string const& s, std::tm* tm) {
 }
 
 std::size_t ParseTime(std::string const& s, std::tm* tm) {
+  auto const pos = ParseFixedTime(s, tm);
+  if (pos != std::string::npos) return pos;
+
   std::tm tmp{};
   std::intmax_t year;
   char const* dp = ParseInt(s.c_str(), kYearMin, kYearMax, &year);
@@ -189,7 +244,8 @@ std::size_t ParseTime(std::string const& s, std::tm* tm) {
     dp = ParseInt(dp + 1, 1, 12, &tmp.tm_mon);
     if (dp != nullptr && *dp == '-') {
       dp = ParseInt(dp + 1, 1, 31, &tmp.tm_mday);  // refine range next
-      if (dp != nullptr && ValidDay(tmp) && (*dp == 'T' || *dp == 't')) {
+      if (dp != nullptr && ValidDay(year, tmp) &&
+          (*dp == 'T' || *dp == 't')) {
         dp = ParseInt(dp + 1, 0, 23, &tmp.tm_hour);
         if (dp != nullptr && *dp == ':') {
           dp = ParseInt(dp + 1, 0, 59, &tmp.tm_min);
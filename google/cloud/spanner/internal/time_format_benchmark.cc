@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "google/cloud/spanner/internal/time_format.h"
+#include "google/cloud/spanner/timestamp.h"
 #include <benchmark/benchmark.h>
 #include <string>
 
@@ -75,6 +76,17 @@ void BM_ParseTime(benchmark::State& state) {
 }
 BENCHMARK(BM_ParseTime);
 
+// Years outside [0 .. 9999] do not match the fixed-width layout, so this
+// measures the general field-by-field parser used before the fast path.
+void BM_ParseTimeGeneral(benchmark::State& state) {
+  std::tm tm;
+  std::string s = "12020-01-17T18:54:12";
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ParseTime(s, &tm));
+  }
+}
+BENCHMARK(BM_ParseTimeGeneral);
+
 void BM_ParseTimeWithFmt(benchmark::State& state) {
   std::tm tm;
   std::string s = "2020-01-17T18:54:12";
@@ -84,6 +96,44 @@ void BM_ParseTimeWithFmt(benchmark::State& state) {
 }
 BENCHMARK(BM_ParseTimeWithFmt);
 
+void BM_TimestampToRFC3339(benchmark::State& state) {
+  auto ts = TimestampFromRFC3339("2020-01-17T18:54:12.123456789Z").value();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TimestampToRFC3339(ts));
+  }
+}
+BENCHMARK(BM_TimestampToRFC3339);
+
+// Successive timestamps on different days defeat the cached date prefix in
+// ToRFC3339(), measuring the full civil-time conversion on every call.
+void BM_TimestampToRFC3339DayChanges(benchmark::State& state) {
+  Timestamp const ts[] = {
+      TimestampFromRFC3339("2020-01-17T18:54:12.123456789Z").value(),
+      TimestampFromRFC3339("2020-01-18T18:54:12.123456789Z").value(),
+  };
+  std::size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TimestampToRFC3339(ts[i++ % 2]));
+  }
+}
+BENCHMARK(BM_TimestampToRFC3339DayChanges);
+
+void BM_TimestampFromRFC3339(benchmark::State& state) {
+  std::string s = "2020-01-17T18:54:12.123456789Z";
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TimestampFromRFC3339(s));
+  }
+}
+BENCHMARK(BM_TimestampFromRFC3339);
+
+void BM_TimestampFromRFC3339Offset(benchmark::State& state) {
+  std::string s = "2020-01-17T10:54:12.123456789-08:00";
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TimestampFromRFC3339(s));
+  }
+}
+BENCHMARK(BM_TimestampFromRFC3339Offset);
+
 }  // namespace
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
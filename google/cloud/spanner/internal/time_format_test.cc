@@ -153,6 +153,37 @@ TEST(TimeFormat, ParseFixed) {
   EXPECT_EQ(std::string::npos, ParseTime("garbage in", &tm));
 }
 
+TEST(TimeFormat, ParseFixedFallback) {
+  std::tm tm{};
+
+  // Lowercase "t" and years outside [0 .. 9999] are still accepted.
+  EXPECT_EQ(19, ParseTime("2019-06-21t16:52:22", &tm));
+  EXPECT_EQ(tm.tm_year, 2019 - 1900);
+  EXPECT_EQ(tm.tm_hour, 16);
+
+  EXPECT_EQ(20, ParseTime("10000-06-21T16:52:22Z", &tm));
+  EXPECT_EQ(tm.tm_year, 10000 - 1900);
+  EXPECT_EQ(tm.tm_mday, 21);
+
+  EXPECT_EQ(19, ParseTime("-012-06-21T16:52:22", &tm));
+  EXPECT_EQ(tm.tm_year, -12 - 1900);
+  EXPECT_EQ(tm.tm_sec, 22);
+
+  // A leap second is allowed, but not a 3-digit seconds field.
+  EXPECT_EQ(19, ParseTime("2016-12-31T23:59:60", &tm));
+  EXPECT_EQ(tm.tm_sec, 60);
+  EXPECT_EQ(std::string::npos, ParseTime("2019-06-21T16:52:220", &tm));
+
+  // Fields out of range.
+  EXPECT_EQ(std::string::npos, ParseTime("2019-13-21T16:52:22", &tm));
+  EXPECT_EQ(std::string::npos, ParseTime("2019-00-21T16:52:22", &tm));
+  EXPECT_EQ(std::string::npos, ParseTime("2019-02-29T16:52:22", &tm));
+  EXPECT_EQ(std::string::npos, ParseTime("2019-06-00T16:52:22", &tm));
+  EXPECT_EQ(std::string::npos, ParseTime("2019-06-21T24:52:22", &tm));
+  EXPECT_EQ(std::string::npos, ParseTime("2019-06-21T16:60:22", &tm));
+  EXPECT_EQ(std::string::npos, ParseTime("2019-06-21T16:52:61", &tm));
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
@@ -0,0 +1,68 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/tracing.h"
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+// The innermost active span on this thread.
+thread_local ScopedSpan* current_span = nullptr;
+
+}  // namespace
+
+TraceContext CurrentTraceContext() {
+  if (current_span == nullptr) return {};
+  return current_span->context();
+}
+
+ScopedSpan::ScopedSpan(char const* name) {
+  if (current_span != nullptr) Start(current_span->context(), name);
+}
+
+ScopedSpan::ScopedSpan(TraceContext const& parent, char const* name) {
+  if (parent.tracer) Start(parent, name);
+}
+
+ScopedSpan::~ScopedSpan() {
+  if (!span_) return;
+  End(Status());
+  current_span = previous_;
+}
+
+void ScopedSpan::Start(std::shared_ptr<Tracer> const& tracer,
+                       char const* name) {
+  std::shared_ptr<Span> parent;
+  if (current_span != nullptr) parent = current_span->span_;
+  Start(TraceContext{tracer, std::move(parent)}, name);
+}
+
+void ScopedSpan::Start(TraceContext const& parent, char const* name) {
+  tracer_ = parent.tracer;
+  span_ = tracer_->StartSpan(name, parent.span);
+  if (!span_) return;
+  previous_ = current_span;
+  current_span = this;
+}
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,107 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_TRACING_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_TRACING_H
+
+#include "google/cloud/spanner/tracer.h"
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/status.h"
+#include <memory>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+
+/// A span and its tracer, to create child spans later or on other threads.
+struct TraceContext {
+  std::shared_ptr<Tracer> tracer;
+  std::shared_ptr<Span> span;
+};
+
+/// The innermost `ScopedSpan` active on this thread, empty if there is none.
+TraceContext CurrentTraceContext();
+
+/**
+ * Starts a span, and makes it the current span of this thread until the
+ * `ScopedSpan` is destroyed.
+ *
+ * Only the root spans need a tracer, the other spans are children of the
+ * current span, so code that cannot reach a tracer (e.g. `RetryLoop()`) is
+ * traced when it runs within a traced operation. When tracing is disabled,
+ * the constructors only check a pointer and the other members do nothing.
+ *
+ * Objects of this class must be destroyed in the reverse order they were
+ * created in, on the thread that created them, which is always the case for
+ * local variables.
+ */
+class ScopedSpan {
+ public:
+  /**
+   * Start a span with @p tracer, a child of the current span if any, otherwise
+   * a root span. Does nothing if @p tracer is `nullptr`.
+   */
+  ScopedSpan(std::shared_ptr<Tracer> const& tracer, char const* name) {
+    if (tracer) Start(tracer, name);
+  }
+
+  /// Start a child of the current span. Does nothing if there is none.
+  explicit ScopedSpan(char const* name);
+
+  /// Start a child of @p parent. Does nothing if @p parent is empty.
+  ScopedSpan(TraceContext const& parent, char const* name);
+
+  ~ScopedSpan();
+
+  ScopedSpan(ScopedSpan const&) = delete;
+  ScopedSpan& operator=(ScopedSpan const&) = delete;
+
+  /// True if a span was started.
+  explicit operator bool() const { return span_ != nullptr; }
+
+  /// The tracer and span, empty if no span was started.
+  TraceContext context() const { return TraceContext{tracer_, span_}; }
+
+  void SetAttribute(std::string const& key, std::string const& value) {
+    if (span_) span_->SetAttribute(key, value);
+  }
+
+  /// End the span with @p status, otherwise the destructor ends it with OK.
+  void End(Status const& status) {
+    if (span_ && !ended_) {
+      ended_ = true;
+      span_->End(status);
+    }
+  }
+
+ private:
+  void Start(std::shared_ptr<Tracer> const& tracer, char const* name);
+  void Start(TraceContext const& parent, char const* name);
+
+  std::shared_ptr<Tracer> tracer_;
+  std::shared_ptr<Span> span_;
+  ScopedSpan* previous_ = nullptr;
+  bool ended_ = false;
+};
+
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_INTERNAL_TRACING_H
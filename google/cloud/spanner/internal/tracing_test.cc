@@ -0,0 +1,123 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/internal/tracing.h"
+#include "google/cloud/spanner/testing/in_memory_tracer.h"
+#include <gmock/gmock.h>
+#include <thread>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace internal {
+namespace {
+
+using ::google::cloud::spanner_testing::InMemoryTracer;
+using ::google::cloud::spanner_testing::SpanData;
+using ::testing::ElementsAre;
+using ::testing::Pair;
+
+TEST(TracingTest, Disabled) {
+  ScopedSpan root(std::shared_ptr<Tracer>{}, "root");
+  EXPECT_FALSE(root);
+  ScopedSpan child("child");
+  EXPECT_FALSE(child);
+  child.SetAttribute("key", "value");
+  child.End(Status(StatusCode::kUnavailable, "try-again"));
+  EXPECT_FALSE(CurrentTraceContext().tracer);
+}
+
+TEST(TracingTest, NoCurrentSpan) {
+  ScopedSpan child("child");
+  EXPECT_FALSE(child);
+  ScopedSpan captured(CurrentTraceContext(), "captured");
+  EXPECT_FALSE(captured);
+}
+
+TEST(TracingTest, Nested) {
+  auto tracer = std::make_shared<InMemoryTracer>();
+  {
+    ScopedSpan root(tracer, "root");
+    ASSERT_TRUE(root);
+    root.SetAttribute("key", "value");
+    {
+      ScopedSpan child("child");
+      ASSERT_TRUE(child);
+      child.End(Status(StatusCode::kUnavailable, "try-again"));
+      ScopedSpan grandchild("grandchild");
+      EXPECT_TRUE(grandchild);
+    }
+    // The current span is restored when the children are destroyed.
+    ScopedSpan sibling("sibling");
+    EXPECT_TRUE(sibling);
+  }
+  EXPECT_FALSE(CurrentTraceContext().tracer);
+
+  auto const spans = tracer->Spans();
+  ASSERT_EQ(4, spans.size());
+  EXPECT_EQ("root", spans[0].name);
+  EXPECT_EQ(SpanData::kNoParent, spans[0].parent);
+  EXPECT_THAT(spans[0].attributes, ElementsAre(Pair("key", "value")));
+  EXPECT_EQ("child", spans[1].name);
+  EXPECT_EQ(0, spans[1].parent);
+  EXPECT_EQ(StatusCode::kUnavailable, spans[1].status.code());
+  EXPECT_EQ("grandchild", spans[2].name);
+  EXPECT_EQ(1, spans[2].parent);
+  EXPECT_EQ("sibling", spans[3].name);
+  EXPECT_EQ(0, spans[3].parent);
+  for (auto const& s : spans) EXPECT_TRUE(s.ended) << s.name;
+  EXPECT_TRUE(spans[0].status.ok());
+  EXPECT_TRUE(spans[3].status.ok());
+}
+
+TEST(TracingTest, RootWithinSpan) {
+  auto tracer = std::make_shared<InMemoryTracer>();
+  ScopedSpan outer(tracer, "outer");
+  ScopedSpan inner(tracer, "inner");
+  auto const spans = tracer->Spans();
+  ASSERT_EQ(2, spans.size());
+  EXPECT_EQ(0, spans[1].parent);
+}
+
+TEST(TracingTest, CapturedContext) {
+  auto tracer = std::make_shared<InMemoryTracer>();
+  TraceContext captured;
+  {
+    ScopedSpan root(tracer, "root");
+    captured = CurrentTraceContext();
+    EXPECT_EQ(tracer, captured.tracer);
+  }
+  // The parent ended, and the child runs on a different thread.
+  std::thread t([&captured] {
+    EXPECT_FALSE(CurrentTraceContext().tracer);
+    ScopedSpan later(captured, "later");
+    EXPECT_TRUE(later);
+    ScopedSpan child("child");
+    EXPECT_TRUE(child);
+  });
+  t.join();
+
+  EXPECT_THAT(tracer->SpanNames(), ElementsAre("root", "later", "child"));
+  auto const spans = tracer->Spans();
+  EXPECT_EQ(0, spans[1].parent);
+  EXPECT_EQ(1, spans[2].parent);
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
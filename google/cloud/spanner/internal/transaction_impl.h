@@ -19,7 +19,9 @@
 #include "google/cloud/spanner/version.h"
 #include "google/cloud/internal/invoke_result.h"
 #include "google/cloud/internal/port_platform.h"
+#include "google/cloud/optional.h"
 #include <google/spanner/v1/transaction.pb.h>
+#include <atomic>
 #include <condition_variable>
 #include <cstdint>
 #include <memory>
@@ -50,11 +52,10 @@ class TransactionImpl {
 
   TransactionImpl(SessionHolder session,
                   google::spanner::v1::TransactionSelector selector)
-      : session_(std::move(session)),
+      : state_(selector.has_begin() ? State::kBegin : State::kDone),
+        session_(std::move(session)),
         selector_(std::move(selector)),
-        seqno_(0) {
-    state_ = selector_.has_begin() ? State::kBegin : State::kDone;
-  }
+        seqno_(0) {}
 
   ~TransactionImpl();
 
@@ -69,6 +70,10 @@ class TransactionImpl {
   // the functor should not modify the selector.
   //
   // A monotonically-increasing sequence number is also passed to the functor.
+  //
+  // Visitors are only serialized while the transaction has no ID. Once it
+  // has one, the session and selector no longer change, so visitors skip
+  // `mu_` and go straight to the functor.
   template <typename Functor>
   VisitInvokeResult<Functor> Visit(Functor&& f) {
     static_assert(
@@ -76,11 +81,18 @@ class TransactionImpl {
             Functor, SessionHolder&, google::spanner::v1::TransactionSelector&,
             std::int64_t>::value,
         "TransactionImpl::Visit() functor has incompatible type.");
+    // The sequence number is only taken once the visitor may run, so that
+    // the visitor that begins the transaction gets a lower number than the
+    // visitors that wait for it. At one increment per statement, a 64-bit
+    // counter cannot overflow.
+    if (state_.load(std::memory_order_acquire) == State::kDone) {
+      return f(session_, selector_, ++seqno_);
+    }
     std::int64_t seqno;
     {
       std::unique_lock<std::mutex> lock(mu_);
-      seqno = ++seqno_;  // what about overflow?
       cond_.wait(lock, [this] { return state_ != State::kPending; });
+      seqno = ++seqno_;
       if (state_ == State::kDone) {
         lock.unlock();
         return f(session_, selector_, seqno);
@@ -116,19 +128,30 @@ class TransactionImpl {
 #endif
   }
 
+  // The options of a single-use transaction, or nothing for other
+  // transactions. Unlike `Visit()`, this does not use a sequence number, nor
+  // wait for a pending `begin`. The selector of a single-use transaction never
+  // changes, and other selectors are not inspected until they are `kDone`.
+  optional<google::spanner::v1::TransactionOptions> SingleUseOptions() const {
+    if (state_.load(std::memory_order_acquire) != State::kDone) return {};
+    if (!selector_.has_single_use()) return {};
+    return selector_.single_use();
+  }
+
  private:
   enum class State {
     kBegin,    // waiting for a future visitor to assign a transaction ID
     kPending,  // waiting for an active visitor to assign a transaction ID
     kDone,     // a transaction ID has been assigned (or we are single-use)
   };
-  State state_;
+  // Only changed while holding `mu_`, but read without it once `kDone`.
+  std::atomic<State> state_;
 
   std::mutex mu_;
   std::condition_variable cond_;
   SessionHolder session_;
   google::spanner::v1::TransactionSelector selector_;
-  std::int64_t seqno_;
+  std::atomic<std::int64_t> seqno_;
 };
 
 }  // namespace internal
@@ -0,0 +1,153 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/mutation_batcher.h"
+#include <algorithm>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+namespace {
+
+// Errors that may be caused by the data in a single request, rather than by
+// the batch as a whole. When a batch fails with one of these we retry its
+// requests individually.
+bool IsRequestError(Status const& status) {
+  switch (status.code()) {
+    case StatusCode::kInvalidArgument:
+    case StatusCode::kNotFound:
+    case StatusCode::kAlreadyExists:
+    case StatusCode::kFailedPrecondition:
+    case StatusCode::kOutOfRange:
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+MutationBatcher::MutationBatcher(Client client, MutationBatcherOptions options)
+    : client_(std::move(client)), options_(std::move(options)) {
+  auto const thread_count = (std::max)(options_.max_concurrent_commits(), 1);
+  workers_.reserve(thread_count);
+  for (int i = 0; i != thread_count; ++i) {
+    workers_.emplace_back([this] { Run(); });
+  }
+}
+
+MutationBatcher::~MutationBatcher() {
+  {
+    std::lock_guard<std::mutex> lk(mu_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  for (auto& t : workers_) t.join();
+}
+
+future<StatusOr<CommitResult>> MutationBatcher::Commit(Mutations mutations) {
+  std::size_t cell_count = 0;
+  for (auto const& m : mutations) {
+    cell_count += internal::MutationCellCount(m);
+  }
+  Request request{std::move(mutations), cell_count,
+                  std::chrono::steady_clock::now() + options_.max_delay(),
+                  promise<StatusOr<CommitResult>>{}};
+  auto f = request.result.get_future();
+
+  std::unique_lock<std::mutex> lk(mu_);
+  // Only wake the workers when there is a new deadline to wait for, or when
+  // the queued requests fill a commit.
+  auto const limit = options_.max_mutations_per_commit();
+  bool const notify = queue_.empty() || queued_cells_ + cell_count >= limit;
+  queue_.push_back(std::move(request));
+  queued_cells_ += cell_count;
+  lk.unlock();
+  if (notify) cv_.notify_all();
+  return f;
+}
+
+void MutationBatcher::Run() {
+  std::unique_lock<std::mutex> lk(mu_);
+  for (;;) {
+    cv_.wait(lk, [this] { return shutdown_ || !queue_.empty(); });
+    if (queue_.empty()) return;  // shutting down, and nothing left to commit
+
+    // Give other requests a chance to join the batch.
+    auto const deadline = queue_.front().deadline;
+    cv_.wait_until(lk, deadline,
+                   [this] { return queue_.empty() || BatchReady(); });
+    // Another worker may have taken the batch while we were waiting.
+    if (queue_.empty() || !BatchReady()) continue;
+
+    auto batch = TakeBatch();
+    lk.unlock();
+    CommitBatch(std::move(batch));
+    lk.lock();
+  }
+}
+
+bool MutationBatcher::BatchReady() const {
+  return shutdown_ || queued_cells_ >= options_.max_mutations_per_commit() ||
+         queue_.front().deadline <= std::chrono::steady_clock::now();
+}
+
+std::vector<MutationBatcher::Request> MutationBatcher::TakeBatch() {
+  auto const limit = options_.max_mutations_per_commit();
+  std::vector<Request> batch;
+  std::size_t cell_count = 0;
+  while (!queue_.empty()) {
+    auto& request = queue_.front();
+    if (!batch.empty() && cell_count + request.cell_count > limit) break;
+    cell_count += request.cell_count;
+    batch.push_back(std::move(request));
+    queue_.pop_front();
+  }
+  queued_cells_ -= cell_count;
+  // The remaining requests may already fill another commit.
+  if (!queue_.empty()) cv_.notify_one();
+  return batch;
+}
+
+void MutationBatcher::CommitBatch(std::vector<Request> batch) {
+  if (batch.size() == 1) {
+    auto& request = batch.front();
+    request.result.set_value(client_.Commit(std::move(request.mutations)));
+    return;
+  }
+
+  Mutations mutations;
+  for (auto const& request : batch) {
+    mutations.insert(mutations.end(), request.mutations.begin(),
+                     request.mutations.end());
+  }
+  auto result = client_.Commit(std::move(mutations));
+  if (!result && IsRequestError(result.status())) {
+    for (auto& request : batch) {
+      request.result.set_value(client_.Commit(std::move(request.mutations)));
+    }
+    return;
+  }
+  for (auto& request : batch) {
+    request.result.set_value(result);
+  }
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,168 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_MUTATION_BATCHER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_MUTATION_BATCHER_H
+
+#include "google/cloud/spanner/client.h"
+#include "google/cloud/spanner/commit_result.h"
+#include "google/cloud/spanner/mutations.h"
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/future.h"
+#include "google/cloud/status_or.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+/**
+ * Controls how a `MutationBatcher` groups mutations into commits.
+ */
+class MutationBatcherOptions {
+ public:
+  /**
+   * Set how long a request may wait for other requests to join its batch.
+   *
+   * A batch is committed as soon as it reaches `max_mutations_per_commit()`,
+   * or when its oldest request has waited this long, whichever comes first.
+   */
+  MutationBatcherOptions& set_max_delay(std::chrono::microseconds delay) {
+    max_delay_ = delay;
+    return *this;
+  }
+
+  /// Return how long a request may wait for other requests to join its batch.
+  std::chrono::microseconds max_delay() const { return max_delay_; }
+
+  /**
+   * Set the maximum number of mutations (as counted by Spanner, i.e., one per
+   * column value written, or per key deleted) in a single commit.
+   *
+   * Spanner rejects commits with more than 20,000 mutations, and writes to
+   * indexed columns count once more for each index, so the default leaves
+   * some room for secondary indexes. A single request that exceeds this limit
+   * is still committed, on its own.
+   */
+  MutationBatcherOptions& set_max_mutations_per_commit(std::size_t count) {
+    max_mutations_per_commit_ = count;
+    return *this;
+  }
+
+  /// Return the maximum number of mutations in a single commit.
+  std::size_t max_mutations_per_commit() const {
+    return max_mutations_per_commit_;
+  }
+
+  /**
+   * Set the maximum number of commits in flight at once.
+   * Values <= 1 are treated as 1.
+   */
+  MutationBatcherOptions& set_max_concurrent_commits(int count) {
+    max_concurrent_commits_ = count;
+    return *this;
+  }
+
+  /// Return the maximum number of commits in flight at once.
+  int max_concurrent_commits() const { return max_concurrent_commits_; }
+
+ private:
+  std::chrono::microseconds max_delay_ = std::chrono::milliseconds(10);
+  std::size_t max_mutations_per_commit_ = 10000;
+  int max_concurrent_commits_ = 4;
+};
+
+/**
+ * Coalesces many small, independent, blind writes into fewer commits.
+ *
+ * Each call to `Commit()` queues a group of mutations. Background threads
+ * commit the queued groups together, in arrival order, so that many callers
+ * share the cost of a single read-write transaction. Every caller whose
+ * mutations were in the same commit receives the same `CommitResult`.
+ *
+ * The mutations in one `Commit()` call are always applied atomically, but
+ * are *not* isolated from other callers' mutations in the same batch. Only
+ * use this class for writes that do not depend on values read in the same
+ * transaction, and that may be committed together with unrelated writes.
+ *
+ * If a batched commit fails with an error that one request's data can cause
+ * (e.g., `kAlreadyExists` for an insert), the requests in that batch are
+ * retried with one commit each, so that one bad request does not fail its
+ * neighbors.
+ *
+ * Destroying a `MutationBatcher` commits any queued requests, and blocks until
+ * all the commits complete.
+ *
+ * @par Example
+ * @code
+ * spanner::MutationBatcher batcher(client);
+ * auto f = batcher.Commit({spanner::MakeInsertMutation(
+ *     "Singers", {"SingerId", "FirstName"}, 1, "Marc")});
+ * auto result = f.get();
+ * @endcode
+ */
+class MutationBatcher {
+ public:
+  explicit MutationBatcher(Client client, MutationBatcherOptions options = {});
+  ~MutationBatcher();
+
+  // This class owns background threads, it cannot be copied or moved.
+  MutationBatcher(MutationBatcher const&) = delete;
+  MutationBatcher& operator=(MutationBatcher const&) = delete;
+  MutationBatcher(MutationBatcher&&) = delete;
+  MutationBatcher& operator=(MutationBatcher&&) = delete;
+
+  /**
+   * Queues @p mutations to be committed atomically, in a batch with other
+   * requests. The returned future is satisfied when the batch commits.
+   */
+  future<StatusOr<CommitResult>> Commit(Mutations mutations);
+
+ private:
+  struct Request {
+    Mutations mutations;
+    std::size_t cell_count;
+    std::chrono::steady_clock::time_point deadline;
+    promise<StatusOr<CommitResult>> result;
+  };
+
+  void Run();
+  bool BatchReady() const;
+  std::vector<Request> TakeBatch();
+  void CommitBatch(std::vector<Request> batch);
+
+  Client client_;
+  MutationBatcherOptions options_;
+
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<Request> queue_;     // GUARDED_BY(mu_)
+  std::size_t queued_cells_ = 0;  // GUARDED_BY(mu_)
+  bool shutdown_ = false;         // GUARDED_BY(mu_)
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_MUTATION_BATCHER_H
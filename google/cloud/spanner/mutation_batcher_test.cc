@@ -0,0 +1,170 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/mutation_batcher.h"
+#include "google/cloud/spanner/mocks/mock_spanner_connection.h"
+#include "google/cloud/spanner/mutations.h"
+#include "google/cloud/spanner/timestamp.h"
+#include "google/cloud/testing_util/assert_ok.h"
+#include <gmock/gmock.h>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+using ::google::cloud::spanner_mocks::MockConnection;
+using ::testing::_;
+
+Mutation MakeRow(std::int64_t key) {
+  return MakeInsertMutation("table", {"Key", "Value"}, key,
+                            "value-" + std::to_string(key));
+}
+
+// Options that batch only by size, with a single commit thread, so that the
+// composition of each batch is deterministic.
+MutationBatcherOptions SizeOnlyOptions(std::size_t max_mutations) {
+  return MutationBatcherOptions{}
+      .set_max_delay(std::chrono::hours(1))
+      .set_max_mutations_per_commit(max_mutations)
+      .set_max_concurrent_commits(1);
+}
+
+Timestamp MakeCommitTimestamp(std::int64_t seconds) {
+  return MakeTimestamp(std::chrono::system_clock::from_time_t(seconds))
+      .value();
+}
+
+TEST(MutationBatcher, CellCount) {
+  EXPECT_EQ(2U, internal::MutationCellCount(MakeRow(1)));
+  auto const rows = InsertMutationBuilder("table", {"A", "B", "C"})
+                        .EmplaceRow(1, 2, 3)
+                        .EmplaceRow(4, 5, 6)
+                        .Build();
+  EXPECT_EQ(6U, internal::MutationCellCount(rows));
+  auto const keys = MakeDeleteMutation(
+      "table", KeySet().AddKey(MakeKey(1)).AddKey(MakeKey(2)));
+  EXPECT_EQ(2U, internal::MutationCellCount(keys));
+  EXPECT_EQ(1U, internal::MutationCellCount(
+                   MakeDeleteMutation("table", KeySet::All())));
+  EXPECT_EQ(0U, internal::MutationCellCount(Mutation()));
+}
+
+TEST(MutationBatcher, CommitsFullBatchTogether) {
+  auto const ts = MakeCommitTimestamp(1);
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, Commit(_))
+      .WillOnce([&ts](Connection::CommitParams const& p) {
+        EXPECT_EQ((Mutations{MakeRow(1), MakeRow(2), MakeRow(3)}), p.mutations);
+        return CommitResult{ts};
+      });
+
+  // Each row has two cells, so the third request fills the batch, long before
+  // the delay expires.
+  MutationBatcher batcher(Client(conn), SizeOnlyOptions(6));
+  auto f1 = batcher.Commit({MakeRow(1)});
+  auto f2 = batcher.Commit({MakeRow(2)});
+  auto f3 = batcher.Commit({MakeRow(3)});
+  for (auto* f : {&f1, &f2, &f3}) {
+    auto r = f->get();
+    ASSERT_STATUS_OK(r);
+    EXPECT_EQ(ts, r->commit_timestamp);
+  }
+}
+
+TEST(MutationBatcher, SplitsAtMutationLimit) {
+  auto conn = std::make_shared<MockConnection>();
+  std::vector<std::size_t> batch_sizes;
+  EXPECT_CALL(*conn, Commit(_))
+      .WillRepeatedly([&batch_sizes](Connection::CommitParams const& p) {
+        batch_sizes.push_back(p.mutations.size());
+        return CommitResult{MakeCommitTimestamp(2)};
+      });
+
+  {
+    MutationBatcher batcher(Client(conn), SizeOnlyOptions(4));
+    std::vector<future<StatusOr<CommitResult>>> results;
+    for (std::int64_t key = 0; key != 5; ++key) {
+      results.push_back(batcher.Commit({MakeRow(key)}));
+    }
+    // A single request larger than the limit is committed on its own.
+    results.push_back(batcher.Commit({MakeRow(5), MakeRow(6), MakeRow(7)}));
+    // The destructor commits whatever is still queued.
+    for (auto& r : results) EXPECT_STATUS_OK(r.get());
+  }
+  EXPECT_EQ(std::vector<std::size_t>({2, 2, 1, 3}), batch_sizes);
+}
+
+TEST(MutationBatcher, CommitsAfterDelay) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, Commit(_))
+      .WillOnce([](Connection::CommitParams const& p) {
+        EXPECT_EQ(1U, p.mutations.size());
+        return CommitResult{MakeCommitTimestamp(3)};
+      });
+
+  MutationBatcher batcher(
+      Client(conn),
+      MutationBatcherOptions{}.set_max_delay(std::chrono::milliseconds(1)));
+  auto r = batcher.Commit({MakeRow(1)}).get();
+  ASSERT_STATUS_OK(r);
+  EXPECT_EQ(MakeCommitTimestamp(3), r->commit_timestamp);
+}
+
+TEST(MutationBatcher, RetriesRequestsIndividually) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, Commit(_))
+      .WillRepeatedly([](Connection::CommitParams const& p) {
+        for (auto const& m : p.mutations) {
+          if (m == MakeRow(2)) {
+            return StatusOr<CommitResult>(
+                Status(StatusCode::kAlreadyExists, "row exists"));
+          }
+        }
+        return StatusOr<CommitResult>(CommitResult{MakeCommitTimestamp(4)});
+      });
+
+  MutationBatcher batcher(Client(conn), SizeOnlyOptions(6));
+  auto f1 = batcher.Commit({MakeRow(1)});
+  auto f2 = batcher.Commit({MakeRow(2)});
+  auto f3 = batcher.Commit({MakeRow(3)});
+  EXPECT_STATUS_OK(f1.get());
+  EXPECT_EQ(StatusCode::kAlreadyExists, f2.get().status().code());
+  EXPECT_STATUS_OK(f3.get());
+}
+
+TEST(MutationBatcher, SharesOtherErrors) {
+  auto conn = std::make_shared<MockConnection>();
+  EXPECT_CALL(*conn, Commit(_))
+      .WillOnce([](Connection::CommitParams const&) {
+        return Status(StatusCode::kPermissionDenied, "uh-oh");
+      });
+
+  MutationBatcher batcher(Client(conn), SizeOnlyOptions(4));
+  auto f1 = batcher.Commit({MakeRow(1)});
+  auto f2 = batcher.Commit({MakeRow(2)});
+  EXPECT_EQ(StatusCode::kPermissionDenied, f1.get().status().code());
+  EXPECT_EQ(StatusCode::kPermissionDenied, f2.get().status().code());
+}
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
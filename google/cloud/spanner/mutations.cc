@@ -30,6 +30,37 @@ void PrintTo(Mutation const& m, std::ostream* os) {
   *os << "Mutation={" << m.m_.DebugString() << "}";
 }
 
+namespace internal {
+
+std::size_t MutationCellCount(Mutation const& m) {
+  // Spanner counts each (row, column) value in a write, and each key or key
+  // range in a delete, against its per-commit mutation limit.
+  auto write_cells = [](google::spanner::v1::Mutation::Write const& w) {
+    return static_cast<std::size_t>(w.columns_size()) *
+           static_cast<std::size_t>(w.values_size());
+  };
+  auto const& proto = m.m_;
+  switch (proto.operation_case()) {
+    case google::spanner::v1::Mutation::kInsert:
+      return write_cells(proto.insert());
+    case google::spanner::v1::Mutation::kUpdate:
+      return write_cells(proto.update());
+    case google::spanner::v1::Mutation::kInsertOrUpdate:
+      return write_cells(proto.insert_or_update());
+    case google::spanner::v1::Mutation::kReplace:
+      return write_cells(proto.replace());
+    case google::spanner::v1::Mutation::kDelete: {
+      auto const& ks = proto.delete_().key_set();
+      return static_cast<std::size_t>(ks.keys_size() + ks.ranges_size()) +
+             (ks.all() ? 1 : 0);
+    }
+    default:
+      return 0;
+  }
+}
+
+}  // namespace internal
+
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner
 }  // namespace cloud
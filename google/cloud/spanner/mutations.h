@@ -17,7 +17,12 @@
 
 #include "google/cloud/spanner/keys.h"
 #include "google/cloud/spanner/value.h"
+#include "google/cloud/internal/throw_delegate.h"
 #include <google/spanner/v1/mutation.pb.h>
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 namespace google {
@@ -25,10 +30,15 @@ namespace cloud {
 namespace spanner {
 inline namespace SPANNER_CLIENT_NS {
 
+class Mutation;
+
 namespace internal {
 template <typename Op>
 class WriteMutationBuilder;
+template <typename Op, typename... Ts>
+class BulkWriteMutationBuilder;
 class DeleteMutationBuilder;
+std::size_t MutationCellCount(Mutation const& m);
 }  // namespace internal
 
 /**
@@ -82,7 +92,10 @@ class Mutation {
 
   template <typename Op>
   friend class internal::WriteMutationBuilder;
+  template <typename Op, typename... Ts>
+  friend class internal::BulkWriteMutationBuilder;
   friend class internal::DeleteMutationBuilder;
+  friend std::size_t internal::MutationCellCount(Mutation const&);
   explicit Mutation(google::spanner::v1::Mutation m) : m_(std::move(m)) {}
 
   google::spanner::v1::Mutation m_;
@@ -115,9 +128,12 @@ class WriteMutationBuilder {
   Mutation&& Build() && { return std::move(m_); }
 
   WriteMutationBuilder& AddRow(std::vector<Value> values) & {
+    // The column types are implied by the table schema, so only the values
+    // are moved into the row, and the `Type` protos are never copied.
     auto& lv = *Op::mutable_field(m_.proto()).add_values();
+    lv.mutable_values()->Reserve(static_cast<int>(values.size()));
     for (auto& v : values) {
-      std::tie(std::ignore, *lv.add_values()) = internal::ToProto(std::move(v));
+      *lv.add_values() = internal::ToProtoValue(std::move(v));
     }
     return *this;
   }
@@ -168,6 +184,118 @@ struct ReplaceOp {
   }
 };
 
+template <typename... Ts>
+struct AllValueTypes : std::true_type {};
+
+template <typename T, typename... Ts>
+struct AllValueTypes<T, Ts...>
+    : std::integral_constant<bool, std::is_constructible<Value, T>::value &&
+                                       AllValueTypes<Ts...>::value> {};
+
+template <typename Op, typename... Ts>
+class BulkWriteMutationBuilder {
+  static_assert(sizeof...(Ts) != 0, "at least one column is required");
+  static_assert(AllValueTypes<Ts...>::value,
+                "every column must have a supported Spanner value type");
+
+ public:
+  BulkWriteMutationBuilder(std::string table_name,
+                           std::vector<std::string> column_names) {
+    if (column_names.size() != sizeof...(Ts)) {
+      google::cloud::internal::ThrowInvalidArgument(
+          "column names do not match the column types");
+    }
+    auto& field = Op::mutable_field(m_.proto());
+    field.set_table(std::move(table_name));
+    field.mutable_columns()->Reserve(static_cast<int>(column_names.size()));
+    for (auto& name : column_names) {
+      field.add_columns(std::move(name));
+    }
+  }
+
+  Mutation Build() const& { return m_; }
+  Mutation&& Build() && { return std::move(m_); }
+
+  /// Appends a single row with one (typed) value per column.
+  BulkWriteMutationBuilder& AddRow(Ts... values) & {
+    AppendRow(*Op::mutable_field(m_.proto()).add_values(),
+              std::move(values)...);
+    return *this;
+  }
+
+  BulkWriteMutationBuilder&& AddRow(Ts... values) && {
+    return std::move(AddRow(std::move(values)...));
+  }
+
+  /**
+   * Appends one row for each element of the @p columns, which must all have
+   * the same size. The column elements are copied into the mutation.
+   */
+  BulkWriteMutationBuilder& AddColumns(std::vector<Ts> const&... columns) & {
+    auto const row_count = RowCount({columns.size()...});
+    auto& rows = ReserveRows(row_count);
+    for (std::size_t i = 0; i != row_count; ++i) {
+      AppendRow(*rows.Add(), columns[i]...);
+    }
+    return *this;
+  }
+
+  /// @copydoc AddColumns(std::vector<Ts> const&...)
+  BulkWriteMutationBuilder&& AddColumns(std::vector<Ts> const&... columns) && {
+    return std::move(AddColumns(columns...));
+  }
+
+  /**
+   * Appends one row for each element of the @p columns, which must all have
+   * the same size. The column elements are moved into the mutation.
+   */
+  BulkWriteMutationBuilder& AddColumns(std::vector<Ts>&&... columns) & {
+    auto const row_count = RowCount({columns.size()...});
+    auto& rows = ReserveRows(row_count);
+    for (std::size_t i = 0; i != row_count; ++i) {
+      AppendRow(*rows.Add(), std::move(columns[i])...);
+    }
+    return *this;
+  }
+
+  /// @copydoc AddColumns(std::vector<Ts>&&...)
+  BulkWriteMutationBuilder&& AddColumns(std::vector<Ts>&&... columns) && {
+    return std::move(AddColumns(std::move(columns)...));
+  }
+
+ private:
+  static std::size_t RowCount(std::initializer_list<std::size_t> sizes) {
+    auto const row_count = *sizes.begin();
+    for (auto size : sizes) {
+      if (size != row_count) {
+        google::cloud::internal::ThrowInvalidArgument(
+            "columns must all have the same number of rows");
+      }
+    }
+    return row_count;
+  }
+
+  google::protobuf::RepeatedPtrField<google::protobuf::ListValue>& ReserveRows(
+      std::size_t row_count) {
+    auto& rows = *Op::mutable_field(m_.proto()).mutable_values();
+    rows.Reserve(rows.size() + static_cast<int>(row_count));
+    return rows;
+  }
+
+  template <typename... Vs>
+  static void AppendRow(google::protobuf::ListValue& row, Vs&&... values) {
+    auto& cells = *row.mutable_values();
+    cells.Reserve(static_cast<int>(sizeof...(Ts)));
+    // Expand the parameter pack in order, one cell per column.
+    using Expand = int[];
+    (void)Expand{0, (*cells.Add() = internal::MakeValueProto<Ts>(
+                         std::forward<Vs>(values)),
+                     0)...};
+  }
+
+  Mutation m_;
+};
+
 class DeleteMutationBuilder {
  public:
   DeleteMutationBuilder(std::string table_name, KeySet keys) {
@@ -327,6 +455,62 @@ Mutation MakeReplaceMutation(std::string table_name,
       .Build();
 }
 
+/**
+ * A helper class to efficiently construct "insert" mutations with many rows.
+ *
+ * The column types are given by @p Ts, and are checked at compile time. Rows
+ * may be added one at a time with `AddRow()`, or in bulk from column-oriented
+ * vectors with `AddColumns()`. In both cases the values are encoded directly
+ * into the mutation, without creating a `Value` for each cell.
+ *
+ * @par Example
+ * @code
+ * auto mutation =
+ *     spanner::BulkInsertMutationBuilder<std::int64_t, std::string>(
+ *         "Singers", {"SingerId", "FirstName"})
+ *         .AddColumns({1, 2, 3}, {"Melissa", "Dylan", "Marc"})
+ *         .Build();
+ * @endcode
+ *
+ * @throws std::invalid_argument (or terminates when exceptions are disabled)
+ *   if the number of column names does not match the number of types, or if
+ *   the vectors given to `AddColumns()` have different sizes.
+ *
+ * @see The Mutation class documentation for an overview of the Cloud Spanner
+ *   mutation API
+ */
+template <typename... Ts>
+using BulkInsertMutationBuilder =
+    internal::BulkWriteMutationBuilder<internal::InsertOp, Ts...>;
+
+/**
+ * A helper class to efficiently construct "update" mutations with many rows.
+ *
+ * @see `BulkInsertMutationBuilder` for details.
+ */
+template <typename... Ts>
+using BulkUpdateMutationBuilder =
+    internal::BulkWriteMutationBuilder<internal::UpdateOp, Ts...>;
+
+/**
+ * A helper class to efficiently construct "insert_or_update" mutations with
+ * many rows.
+ *
+ * @see `BulkInsertMutationBuilder` for details.
+ */
+template <typename... Ts>
+using BulkInsertOrUpdateMutationBuilder =
+    internal::BulkWriteMutationBuilder<internal::InsertOrUpdateOp, Ts...>;
+
+/**
+ * A helper class to efficiently construct "replace" mutations with many rows.
+ *
+ * @see `BulkInsertMutationBuilder` for details.
+ */
+template <typename... Ts>
+using BulkReplaceMutationBuilder =
+    internal::BulkWriteMutationBuilder<internal::ReplaceOp, Ts...>;
+
 /**
  * A helper class to construct "delete" mutations.
  *
@@ -0,0 +1,102 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/mutations.h"
+#include "google/cloud/spanner/timestamp.h"
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+// The columns of a typical "events" table: a key, a payload, and a couple of
+// timestamps that fall within the same few seconds.
+struct Columns {
+  std::vector<std::int64_t> keys;
+  std::vector<std::string> names;
+  std::vector<Timestamp> created;
+  std::vector<Timestamp> updated;
+};
+
+Columns MakeColumns(std::int64_t row_count) {
+  auto const now = std::chrono::system_clock::now();
+  Columns c;
+  for (std::int64_t i = 0; i != row_count; ++i) {
+    auto const ts = now + std::chrono::microseconds(i);
+    c.keys.push_back(i);
+    c.names.push_back("name-" + std::to_string(i));
+    c.created.push_back(MakeTimestamp(ts).value());
+    c.updated.push_back(MakeTimestamp(ts).value());
+  }
+  return c;
+}
+
+std::vector<std::string> ColumnNames() {
+  return {"Key", "Name", "Created", "Updated"};
+}
+
+void BM_InsertMutationBuilder(benchmark::State& state) {
+  auto const columns = MakeColumns(state.range(0));
+  for (auto _ : state) {
+    InsertMutationBuilder builder("Events", ColumnNames());
+    for (std::size_t i = 0; i != columns.keys.size(); ++i) {
+      builder.EmplaceRow(columns.keys[i], columns.names[i], columns.created[i],
+                         columns.updated[i]);
+    }
+    benchmark::DoNotOptimize(std::move(builder).Build());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_InsertMutationBuilder)->Range(1, 1 << 14);
+
+void BM_BulkInsertMutationBuilderRows(benchmark::State& state) {
+  auto const columns = MakeColumns(state.range(0));
+  for (auto _ : state) {
+    BulkInsertMutationBuilder<std::int64_t, std::string, Timestamp, Timestamp>
+        builder("Events", ColumnNames());
+    for (std::size_t i = 0; i != columns.keys.size(); ++i) {
+      builder.AddRow(columns.keys[i], columns.names[i], columns.created[i],
+                     columns.updated[i]);
+    }
+    benchmark::DoNotOptimize(std::move(builder).Build());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BulkInsertMutationBuilderRows)->Range(1, 1 << 14);
+
+void BM_BulkInsertMutationBuilderColumns(benchmark::State& state) {
+  auto const columns = MakeColumns(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        BulkInsertMutationBuilder<std::int64_t, std::string, Timestamp,
+                                  Timestamp>("Events", ColumnNames())
+            .AddColumns(columns.keys, columns.names, columns.created,
+                        columns.updated)
+            .Build());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BulkInsertMutationBuilderColumns)->Range(1, 1 << 14);
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
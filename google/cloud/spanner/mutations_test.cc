@@ -18,8 +18,10 @@
 #include <google/protobuf/text_format.h>
 #include <google/protobuf/util/message_differencer.h>
 #include <gmock/gmock.h>
+#include <chrono>
 #include <cstdint>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <tuple>
 #include <type_traits>
@@ -36,6 +38,7 @@ namespace spanner_proto = ::google::spanner::v1;
 
 using ::google::cloud::spanner_testing::IsProtoEqual;
 using ::google::protobuf::TextFormat;
+using ::testing::ElementsAre;
 using ::testing::HasSubstr;
 
 TEST(MutationsTest, Default) {
@@ -400,6 +403,87 @@ TEST(MutationsTest, FluentReplaceBuilder) {
   EXPECT_EQ(data, actual.replace().values(1).values(0).string_value());
 }
 
+TEST(MutationsTest, BulkInsertMatchesInsertBuilder) {
+  auto const ts = MakeTimestamp(std::chrono::system_clock::from_time_t(0));
+  ASSERT_TRUE(ts.ok());
+  std::vector<std::string> const columns{"Id", "Name", "Flag", "Ts", "Score"};
+
+  auto expected =
+      InsertMutationBuilder("table-name", columns)
+          .EmplaceRow(1, "one", true, *ts, optional<double>{1.5})
+          .EmplaceRow(2, "two", false, *ts, optional<double>{})
+          .EmplaceRow(3, "three", true, *ts, optional<double>{3.5})
+          .Build();
+
+  using Builder = BulkInsertMutationBuilder<std::int64_t, std::string, bool,
+                                            Timestamp, optional<double>>;
+  auto by_rows = Builder("table-name", columns)
+                     .AddRow(1, "one", true, *ts, 1.5)
+                     .AddRow(2, "two", false, *ts, {})
+                     .AddRow(3, "three", true, *ts, 3.5)
+                     .Build();
+  EXPECT_EQ(expected, by_rows);
+
+  auto by_columns = Builder("table-name", columns)
+                        .AddColumns({1, 2}, {"one", "two"}, {true, false},
+                                    {*ts, *ts}, {1.5, {}})
+                        .AddColumns({3}, {"three"}, {true}, {*ts}, {3.5})
+                        .Build();
+  EXPECT_EQ(expected, by_columns);
+}
+
+TEST(MutationsTest, BulkBuilderOps) {
+  std::vector<std::string> const columns{"Key", "Value"};
+  std::vector<std::int64_t> const keys{1, 2};
+  std::vector<std::string> const values{"a", "b"};
+
+  EXPECT_EQ(UpdateMutationBuilder("t", columns)
+                .EmplaceRow(1, "a")
+                .EmplaceRow(2, "b")
+                .Build(),
+            (BulkUpdateMutationBuilder<std::int64_t, std::string>("t", columns)
+                 .AddColumns(keys, values)
+                 .Build()));
+  EXPECT_EQ(
+      InsertOrUpdateMutationBuilder("t", columns)
+          .EmplaceRow(1, "a")
+          .EmplaceRow(2, "b")
+          .Build(),
+      (BulkInsertOrUpdateMutationBuilder<std::int64_t, std::string>("t",
+                                                                    columns)
+           .AddColumns(keys, values)
+           .Build()));
+  EXPECT_EQ(ReplaceMutationBuilder("t", columns)
+                .EmplaceRow(1, "a")
+                .EmplaceRow(2, "b")
+                .Build(),
+            (BulkReplaceMutationBuilder<std::int64_t, std::string>("t", columns)
+                 .AddColumns(keys, values)
+                 .Build()));
+}
+
+TEST(MutationsTest, BulkBuilderCopiesOrMovesColumns) {
+  using Builder = BulkInsertMutationBuilder<std::int64_t, std::string>;
+  std::vector<std::int64_t> keys{1, 2};
+  std::vector<std::string> values{"a", "b"};
+  auto copied = Builder("t", {"Key", "Value"}).AddColumns(keys, values).Build();
+  EXPECT_THAT(values, ElementsAre("a", "b"));
+
+  auto moved = Builder("t", {"Key", "Value"})
+                   .AddColumns(std::move(keys), std::move(values))
+                   .Build();
+  EXPECT_EQ(copied, moved);
+}
+
+#if GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+TEST(MutationsTest, BulkBuilderMismatchedSizes) {
+  using Builder = BulkInsertMutationBuilder<std::int64_t, std::string>;
+  EXPECT_THROW(Builder("t", {"Key"}), std::invalid_argument);
+  Builder builder("t", {"Key", "Value"});
+  EXPECT_THROW(builder.AddColumns({1, 2}, {"a"}), std::invalid_argument);
+}
+#endif  // GOOGLE_CLOUD_CPP_HAVE_EXCEPTIONS
+
 TEST(MutationsTest, FluentDeleteBuilder) {
   static_assert(
       std::is_rvalue_reference<decltype(
@@ -69,6 +69,10 @@ optional<Timestamp> RowStream::ReadTimestamp() const {
   return GetReadTimestamp(source_);
 }
 
+optional<StreamStats> RowStream::ClientStats() const {
+  return source_->ClientStats();
+}
+
 optional<Timestamp> ProfileQueryResult::ReadTimestamp() const {
   return GetReadTimestamp(source_);
 }
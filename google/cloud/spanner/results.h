@@ -19,6 +19,8 @@
 #include "google/cloud/spanner/timestamp.h"
 #include "google/cloud/optional.h"
 #include <google/spanner/v1/spanner.pb.h>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -39,6 +41,42 @@ inline namespace SPANNER_CLIENT_NS {
  */
 using ExecutionPlan = ::google::spanner::v1::QueryPlan;
 
+/**
+ * Client-side statistics about a streaming read or query.
+ *
+ * These complement the statistics returned by Cloud Spanner, separating the
+ * time waiting for the service from the time the client spends decoding the
+ * results.
+ */
+struct StreamStats {
+  /// The time from starting the streaming RPC until the first response.
+  std::chrono::nanoseconds time_to_first_response;
+
+  /// The total time spent waiting for responses after the first one.
+  std::chrono::nanoseconds total_response_gap;
+
+  /// The longest time spent waiting for a response after the first one.
+  std::chrono::nanoseconds max_response_gap;
+
+  /// The number of `PartialResultSet` responses received.
+  std::int64_t responses;
+
+  /// The total size of the responses, as serialized protos.
+  std::int64_t response_bytes;
+
+  /// The size of the largest response.
+  std::int64_t max_response_bytes;
+
+  /// The time spent merging values split across responses.
+  std::chrono::nanoseconds merge_time;
+
+  /// The time spent assembling the `Row`s returned so far.
+  std::chrono::nanoseconds row_assembly_time;
+
+  /// The number of times the streaming RPC was resumed after an error.
+  std::int64_t resumes;
+};
+
 namespace internal {
 class ResultSourceInterface {
  public:
@@ -47,6 +85,8 @@ class ResultSourceInterface {
   virtual StatusOr<Row> NextRow() = 0;
   virtual optional<google::spanner::v1::ResultSetMetadata> Metadata() = 0;
   virtual optional<google::spanner::v1::ResultSetStats> Stats() const = 0;
+  // Only sources that read a stream provide these.
+  virtual optional<StreamStats> ClientStats() const { return {}; }
 };
 }  // namespace internal
 
@@ -91,6 +131,14 @@ class RowStream {
    */
   optional<Timestamp> ReadTimestamp() const;
 
+  /**
+   * Retrieves the client-side statistics about the stream, which are updated
+   * as the rows are iterated.
+   *
+   * @note Only available for the results of a streaming read or query.
+   */
+  optional<StreamStats> ClientStats() const;
+
  private:
   std::unique_ptr<internal::ResultSourceInterface> source_;
 };
@@ -0,0 +1,87 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/retry_budget.h"
+#include "google/cloud/spanner/retry_policy.h"
+#include <algorithm>
+#include <cmath>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+// The tokens are stored in thousandths, as in gRPC.
+std::int64_t constexpr kTokenScale = 1000;
+
+bool IsBudgetFailure(Status const& status) {
+  return internal::SafeGrpcRetry::IsTransientFailure(status);
+}
+
+}  // namespace
+
+RetryBudget::RetryBudget(std::int64_t max_tokens, double token_ratio)
+    : max_tokens_((std::max)(max_tokens, std::int64_t{0}) * kTokenScale),
+      token_ratio_((std::max)(
+          static_cast<std::int64_t>(std::llround(token_ratio * kTokenScale)),
+          std::int64_t{1})),
+      tokens_(max_tokens_) {}
+
+void RetryBudget::Record(Status const& status) {
+  if (status.ok()) {
+    successes_.fetch_add(1, std::memory_order_relaxed);
+    AddTokens(token_ratio_);
+    return;
+  }
+  if (!IsBudgetFailure(status)) return;
+  failures_.fetch_add(1, std::memory_order_relaxed);
+  AddTokens(-kTokenScale);
+}
+
+bool RetryBudget::AllowRetry() {
+  if (tokens_.load(std::memory_order_relaxed) > max_tokens_ / 2) {
+    retries_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+  throttled_.fetch_add(1, std::memory_order_relaxed);
+  return false;
+}
+
+RetryBudgetMetrics RetryBudget::Snapshot() const {
+  auto const scale = static_cast<double>(kTokenScale);
+  return RetryBudgetMetrics{
+      static_cast<double>(max_tokens_) / scale,
+      static_cast<double>(tokens_.load(std::memory_order_relaxed)) / scale,
+      successes_.load(std::memory_order_relaxed),
+      failures_.load(std::memory_order_relaxed),
+      retries_.load(std::memory_order_relaxed),
+      throttled_.load(std::memory_order_relaxed)};
+}
+
+void RetryBudget::AddTokens(std::int64_t delta) {
+  auto current = tokens_.load(std::memory_order_relaxed);
+  std::int64_t updated;
+  do {
+    updated = (std::min)((std::max)(current + delta, std::int64_t{0}),
+                         max_tokens_);
+  } while (current != updated &&
+           !tokens_.compare_exchange_weak(current, updated,
+                                          std::memory_order_relaxed));
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,101 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_RETRY_BUDGET_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_RETRY_BUDGET_H
+
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/status.h"
+#include <atomic>
+#include <cstdint>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+/// A point-in-time copy of the state of a `RetryBudget`.
+struct RetryBudgetMetrics {
+  double max_tokens;
+  double tokens;
+  /// The number of calls that succeeded, and failed with a retryable error.
+  std::int64_t successes;
+  std::int64_t failures;
+  /// The number of retries allowed, and refused, by the budget.
+  std::int64_t retries;
+  std::int64_t throttled;
+};
+
+/**
+ * A token bucket that limits the retries when most calls are failing.
+ *
+ * Install a budget with `ConnectionTuningOptions::set_retry_budget()` to stop
+ * a `Connection` from multiplying the load on a struggling service, and call
+ * `Snapshot()` to monitor it. Several connections may share a budget.
+ *
+ * This follows the retry throttling in gRPC: the bucket starts full, each call
+ * that fails with a retryable error takes one token, and each successful call
+ * returns `token_ratio` tokens. Retries are refused while the bucket is at
+ * most half full, so, once the calls fail more often than about one in
+ * `1 + 1 / token_ratio`, each call is attempted only once until the successes
+ * refill the bucket.
+ *
+ * The tokens are kept in thousandths, in an atomic, so this class is
+ * thread-safe and never takes a lock.
+ */
+class RetryBudget {
+ public:
+  /**
+   * @param max_tokens the size of the bucket, e.g. 100.
+   * @param token_ratio the tokens returned by each successful call, e.g. 0.1.
+   *     Values below 0.001 are rounded up to 0.001.
+   */
+  RetryBudget(std::int64_t max_tokens, double token_ratio);
+
+  RetryBudget(RetryBudget const&) = delete;
+  RetryBudget& operator=(RetryBudget const&) = delete;
+
+  /**
+   * Record the result of a call, calls with non-retryable errors are ignored.
+   *
+   * Only `kUnavailable` and `kResourceExhausted` take a token. A call that
+   * runs out of its attempt timeout should be recorded as `kUnavailable`, as
+   * it is retried, and a call that runs out of the operation deadline as
+   * `kDeadlineExceeded`, as it is not.
+   */
+  void Record(Status const& status);
+
+  /// Whether a call that just failed may be retried.
+  bool AllowRetry();
+
+  RetryBudgetMetrics Snapshot() const;
+
+ private:
+  void AddTokens(std::int64_t delta);
+
+  std::int64_t const max_tokens_;
+  std::int64_t const token_ratio_;
+  std::atomic<std::int64_t> tokens_;
+  std::atomic<std::int64_t> successes_{0};
+  std::atomic<std::int64_t> failures_{0};
+  std::atomic<std::int64_t> retries_{0};
+  std::atomic<std::int64_t> throttled_{0};
+};
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_RETRY_BUDGET_H
@@ -0,0 +1,114 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/retry_budget.h"
+#include <gmock/gmock.h>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+Status TransientError() { return Status(StatusCode::kUnavailable, "retry"); }
+
+TEST(RetryBudgetTest, StartsFull) {
+  RetryBudget budget(10, 0.5);
+  auto const metrics = budget.Snapshot();
+  EXPECT_EQ(10.0, metrics.max_tokens);
+  EXPECT_EQ(10.0, metrics.tokens);
+  EXPECT_TRUE(budget.AllowRetry());
+  EXPECT_EQ(1, budget.Snapshot().retries);
+}
+
+TEST(RetryBudgetTest, ThrottlesAtHalf) {
+  RetryBudget budget(10, 0.5);
+  for (int i = 0; i != 4; ++i) budget.Record(TransientError());
+  EXPECT_TRUE(budget.AllowRetry());
+  budget.Record(TransientError());
+  EXPECT_FALSE(budget.AllowRetry());
+
+  auto const metrics = budget.Snapshot();
+  EXPECT_EQ(5.0, metrics.tokens);
+  EXPECT_EQ(5, metrics.failures);
+  EXPECT_EQ(1, metrics.retries);
+  EXPECT_EQ(1, metrics.throttled);
+}
+
+TEST(RetryBudgetTest, SuccessesRefill) {
+  RetryBudget budget(10, 0.5);
+  for (int i = 0; i != 20; ++i) budget.Record(TransientError());
+  EXPECT_EQ(0.0, budget.Snapshot().tokens);
+  EXPECT_FALSE(budget.AllowRetry());
+
+  for (int i = 0; i != 11; ++i) budget.Record(Status());
+  EXPECT_EQ(5.5, budget.Snapshot().tokens);
+  EXPECT_TRUE(budget.AllowRetry());
+
+  // The bucket never holds more than `max_tokens`.
+  for (int i = 0; i != 100; ++i) budget.Record(Status());
+  auto const metrics = budget.Snapshot();
+  EXPECT_EQ(10.0, metrics.tokens);
+  EXPECT_EQ(111, metrics.successes);
+  EXPECT_EQ(20, metrics.failures);
+}
+
+TEST(RetryBudgetTest, IgnoresPermanentErrors) {
+  RetryBudget budget(10, 0.5);
+  for (int i = 0; i != 20; ++i) {
+    budget.Record(Status(StatusCode::kNotFound, "not found"));
+    budget.Record(Status(StatusCode::kAborted, "aborted"));
+  }
+  auto const metrics = budget.Snapshot();
+  EXPECT_EQ(10.0, metrics.tokens);
+  EXPECT_EQ(0, metrics.failures);
+
+  // The attempts that time out are reported as `kUnavailable` by the stub,
+  // this is the operation deadline, which is not retried.
+  budget.Record(Status(StatusCode::kDeadlineExceeded, "timeout"));
+  EXPECT_EQ(10.0, budget.Snapshot().tokens);
+  EXPECT_EQ(0, budget.Snapshot().failures);
+}
+
+TEST(RetryBudgetTest, Concurrent) {
+  RetryBudget budget(1000, 1.0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t != 4; ++t) {
+    threads.emplace_back([&budget] {
+      for (int i = 0; i != 100; ++i) {
+        budget.Record(TransientError());
+        budget.Record(Status());
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  auto const metrics = budget.Snapshot();
+  EXPECT_EQ(400, metrics.successes);
+  EXPECT_EQ(400, metrics.failures);
+  EXPECT_EQ(1000.0, metrics.tokens);
+}
+
+TEST(RetryBudgetTest, NegativeMaxTokens) {
+  RetryBudget budget(-1, 0.5);
+  EXPECT_EQ(0.0, budget.Snapshot().max_tokens);
+  EXPECT_FALSE(budget.AllowRetry());
+}
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,80 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/rpc_trace_buffer.h"
+#include <algorithm>
+#include <ostream>
+#include <thread>
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+std::ostream& operator<<(std::ostream& os, RpcTraceRecord const& r) {
+  os << r.method << "() latency=" << r.latency.count() << "us"
+     << " status=" << r.status;
+  if (!r.request.empty()) os << " request={" << r.request << "}";
+  if (!r.response.empty()) os << " response={" << r.response << "}";
+  if (r.responses != 0) os << " responses=" << r.responses;
+  return os;
+}
+
+RpcTraceBuffer::RpcTraceBuffer(std::size_t capacity)
+    : capacity_((std::max)(capacity, std::size_t{1})),
+      slots_(new Slot[capacity_]) {}
+
+void RpcTraceBuffer::Push(RpcTraceRecord record) {
+  auto const sequence = next_.fetch_add(1, std::memory_order_relaxed);
+  auto& slot = slots_[sequence % capacity_];
+  if (slot.busy.exchange(true, std::memory_order_acquire)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  // A slower writer that claimed an older sequence must not overwrite a newer
+  // record.
+  if (!slot.valid || slot.sequence < sequence) {
+    slot.valid = true;
+    slot.sequence = sequence;
+    slot.record = std::move(record);
+  }
+  slot.busy.store(false, std::memory_order_release);
+}
+
+std::vector<RpcTraceRecord> RpcTraceBuffer::Dump() const {
+  std::vector<std::pair<std::uint64_t, RpcTraceRecord>> records;
+  for (std::size_t i = 0; i != capacity_; ++i) {
+    auto& slot = slots_[i];
+    while (slot.busy.exchange(true, std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+    if (slot.valid) records.emplace_back(slot.sequence, slot.record);
+    slot.busy.store(false, std::memory_order_release);
+  }
+  std::sort(records.begin(), records.end(),
+            [](std::pair<std::uint64_t, RpcTraceRecord> const& a,
+               std::pair<std::uint64_t, RpcTraceRecord> const& b) {
+              return a.first < b.first;
+            });
+  std::vector<RpcTraceRecord> result;
+  result.reserve(records.size());
+  for (auto& r : records) result.push_back(std::move(r.second));
+  return result;
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,97 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_RPC_TRACE_BUFFER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_RPC_TRACE_BUFFER_H
+
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/status.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+/// The trace of a single RPC, see `RpcTraceBuffer`.
+struct RpcTraceRecord {
+  /// The name of the RPC, e.g. "Commit".
+  std::string method;
+  /// When the RPC started.
+  std::chrono::system_clock::time_point start;
+  std::chrono::microseconds latency;
+  Status status;
+  /// The request, empty if it was not captured.
+  std::string request;
+  /// The response of unary calls, empty for streaming calls.
+  std::string response;
+  /// The number of responses read from a streaming call.
+  std::int64_t responses;
+};
+
+std::ostream& operator<<(std::ostream& os, RpcTraceRecord const& r);
+
+/**
+ * A fixed-size buffer with the most recent `RpcTraceRecord`s.
+ *
+ * Install a buffer with `ConnectionTuningOptions::set_rpc_trace_buffer()` to
+ * record a sample of the RPCs of a `Connection`, and call `Dump()` to read the
+ * records, e.g. to debug tail latency. Several connections may share a buffer.
+ *
+ * `Push()` never blocks: each record claims the next slot with an atomic
+ * increment, and if another thread is still writing to that slot (which needs
+ * the buffer to wrap around while the write is in progress) the record is
+ * dropped. `Dump()` waits for the writes in progress, so it should only be
+ * used on demand, e.g. while debugging.
+ */
+class RpcTraceBuffer {
+ public:
+  explicit RpcTraceBuffer(std::size_t capacity);
+
+  void Push(RpcTraceRecord record);
+
+  /// The records in the buffer, oldest first.
+  std::vector<RpcTraceRecord> Dump() const;
+
+  /// The number of records dropped because their slot was busy.
+  std::int64_t dropped() const { return dropped_.load(); }
+
+  std::size_t capacity() const { return capacity_; }
+
+ private:
+  struct Slot {
+    std::atomic<bool> busy{false};
+    bool valid = false;          // GUARDED_BY(busy)
+    std::uint64_t sequence = 0;  // GUARDED_BY(busy)
+    RpcTraceRecord record;       // GUARDED_BY(busy)
+  };
+
+  std::size_t capacity_;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<std::uint64_t> next_{0};
+  std::atomic<std::int64_t> dropped_{0};
+};
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_RPC_TRACE_BUFFER_H
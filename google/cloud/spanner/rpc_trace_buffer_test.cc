@@ -0,0 +1,106 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/rpc_trace_buffer.h"
+#include <gmock/gmock.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+
+RpcTraceRecord MakeRecord(std::string method) {
+  return RpcTraceRecord{std::move(method),
+                        std::chrono::system_clock::now(),
+                        std::chrono::microseconds(10),
+                        Status(),
+                        {},
+                        {},
+                        0};
+}
+
+std::vector<std::string> Methods(std::vector<RpcTraceRecord> const& records) {
+  std::vector<std::string> methods;
+  for (auto const& r : records) methods.push_back(r.method);
+  return methods;
+}
+
+TEST(RpcTraceBufferTest, Empty) {
+  RpcTraceBuffer buffer(4);
+  EXPECT_EQ(4, buffer.capacity());
+  EXPECT_TRUE(buffer.Dump().empty());
+  EXPECT_EQ(0, buffer.dropped());
+}
+
+TEST(RpcTraceBufferTest, KeepsMostRecent) {
+  RpcTraceBuffer buffer(3);
+  buffer.Push(MakeRecord("A"));
+  buffer.Push(MakeRecord("B"));
+  EXPECT_THAT(Methods(buffer.Dump()), ElementsAre("A", "B"));
+
+  buffer.Push(MakeRecord("C"));
+  buffer.Push(MakeRecord("D"));
+  buffer.Push(MakeRecord("E"));
+  EXPECT_THAT(Methods(buffer.Dump()), ElementsAre("C", "D", "E"));
+  EXPECT_EQ(0, buffer.dropped());
+}
+
+TEST(RpcTraceBufferTest, ConcurrentWriters) {
+  RpcTraceBuffer buffer(64);
+  auto constexpr kThreads = 8;
+  auto constexpr kRecords = 1000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t != kThreads; ++t) {
+    threads.emplace_back([&buffer, t] {
+      for (int i = 0; i != kRecords; ++i) {
+        buffer.Push(MakeRecord("T" + std::to_string(t)));
+      }
+    });
+  }
+  // Dumping while the writers run must be safe too.
+  for (int i = 0; i != 10; ++i) {
+    EXPECT_LE(buffer.Dump().size(), buffer.capacity());
+  }
+  for (auto& t : threads) t.join();
+
+  auto const records = buffer.Dump();
+  EXPECT_LE(records.size(), buffer.capacity());
+  EXPECT_FALSE(records.empty());
+  EXPECT_LE(buffer.dropped(), kThreads * kRecords);
+}
+
+TEST(RpcTraceBufferTest, Format) {
+  auto record = MakeRecord("Commit");
+  record.status = Status(StatusCode::kUnavailable, "try-again");
+  record.request = "session: \"s\"";
+  std::ostringstream os;
+  os << record;
+  EXPECT_THAT(os.str(), HasSubstr("Commit() latency=10us"));
+  EXPECT_THAT(os.str(), HasSubstr("try-again"));
+  EXPECT_THAT(os.str(), HasSubstr("request={session: \"s\"}"));
+}
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
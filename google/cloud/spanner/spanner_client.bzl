@@ -20,24 +20,32 @@ spanner_client_hdrs = [
     "backoff_policy.h",
     "backup.h",
     "batch_dml_result.h",
+    "batch_read_options.h",
+    "bulk_loader.h",
     "bytes.h",
     "client.h",
     "client_options.h",
     "commit_result.h",
     "connection.h",
     "connection_options.h",
+    "connection_tuning_options.h",
+    "contention_controller.h",
     "create_instance_request_builder.h",
     "database.h",
     "database_admin_client.h",
     "database_admin_connection.h",
     "date.h",
+    "fan_out.h",
     "iam_updater.h",
     "instance.h",
     "instance_admin_client.h",
     "instance_admin_connection.h",
     "internal/api_client_header.h",
+    "internal/batch_read.h",
     "internal/build_info.h",
     "internal/channel.h",
+    "internal/channel_health.h",
+    "internal/channel_health_spanner_stub.h",
     "internal/clock.h",
     "internal/compiler_info.h",
     "internal/connection_impl.h",
@@ -45,6 +53,9 @@ spanner_client_hdrs = [
     "internal/database_admin_metadata.h",
     "internal/database_admin_stub.h",
     "internal/date.h",
+    "internal/deadline.h",
+    "internal/deadline_connection.h",
+    "internal/hedged_partial_result_set_reader.h",
     "internal/instance_admin_logging.h",
     "internal/instance_admin_metadata.h",
     "internal/instance_admin_stub.h",
@@ -53,20 +64,29 @@ spanner_client_hdrs = [
     "internal/logging_spanner_stub.h",
     "internal/merge_chunk.h",
     "internal/metadata_spanner_stub.h",
+    "internal/metrics_spanner_stub.h",
     "internal/partial_result_set_reader.h",
     "internal/partial_result_set_resume.h",
     "internal/partial_result_set_source.h",
     "internal/polling_loop.h",
+    "internal/read_timestamp_cache.h",
+    "internal/retry_budget_policy.h",
+    "internal/retry_budget_spanner_stub.h",
     "internal/retry_loop.h",
+    "internal/rpc_metrics.h",
+    "internal/sampled_logging_spanner_stub.h",
     "internal/session.h",
     "internal/session_pool.h",
     "internal/spanner_stub.h",
     "internal/status_utils.h",
+    "internal/stub_decorator_utils.h",
     "internal/time_format.h",
     "internal/time_utils.h",
+    "internal/tracing.h",
     "internal/transaction_impl.h",
     "internal/tuple_utils.h",
     "keys.h",
+    "mutation_batcher.h",
     "mutations.h",
     "partition_options.h",
     "partitioned_dml_result.h",
@@ -76,11 +96,14 @@ spanner_client_hdrs = [
     "read_options.h",
     "read_partition.h",
     "results.h",
+    "retry_budget.h",
     "retry_policy.h",
     "row.h",
+    "rpc_trace_buffer.h",
     "session_pool_options.h",
     "sql_statement.h",
     "timestamp.h",
+    "tracer.h",
     "tracing_options.h",
     "transaction.h",
     "update_instance_request_builder.h",
@@ -91,9 +114,11 @@ spanner_client_hdrs = [
 
 spanner_client_srcs = [
     "backup.cc",
+    "bulk_loader.cc",
     "bytes.cc",
     "client.cc",
     "connection_options.cc",
+    "contention_controller.cc",
     "database.cc",
     "database_admin_client.cc",
     "database_admin_connection.cc",
@@ -102,12 +127,18 @@ spanner_client_srcs = [
     "instance_admin_client.cc",
     "instance_admin_connection.cc",
     "internal/api_client_header.cc",
+    "internal/batch_read.cc",
+    "internal/channel_health.cc",
+    "internal/channel_health_spanner_stub.cc",
     "internal/compiler_info.cc",
     "internal/connection_impl.cc",
     "internal/database_admin_logging.cc",
     "internal/database_admin_metadata.cc",
     "internal/database_admin_stub.cc",
     "internal/date.cc",
+    "internal/deadline.cc",
+    "internal/deadline_connection.cc",
+    "internal/hedged_partial_result_set_reader.cc",
     "internal/instance_admin_logging.cc",
     "internal/instance_admin_metadata.cc",
     "internal/instance_admin_stub.cc",
@@ -116,22 +147,32 @@ spanner_client_srcs = [
     "internal/logging_spanner_stub.cc",
     "internal/merge_chunk.cc",
     "internal/metadata_spanner_stub.cc",
+    "internal/metrics_spanner_stub.cc",
     "internal/partial_result_set_resume.cc",
     "internal/partial_result_set_source.cc",
+    "internal/read_timestamp_cache.cc",
+    "internal/retry_budget_policy.cc",
+    "internal/retry_budget_spanner_stub.cc",
     "internal/retry_loop.cc",
+    "internal/rpc_metrics.cc",
+    "internal/sampled_logging_spanner_stub.cc",
     "internal/session.cc",
     "internal/session_pool.cc",
     "internal/spanner_stub.cc",
     "internal/status_utils.cc",
     "internal/time_format.cc",
+    "internal/tracing.cc",
     "internal/transaction_impl.cc",
     "keys.cc",
+    "mutation_batcher.cc",
     "mutations.cc",
     "partition_options.cc",
     "query_partition.cc",
     "read_partition.cc",
     "results.cc",
+    "retry_budget.cc",
     "row.cc",
+    "rpc_trace_buffer.cc",
     "sql_statement.cc",
     "timestamp.cc",
     "transaction.cc",
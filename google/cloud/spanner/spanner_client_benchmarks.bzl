@@ -20,6 +20,9 @@ spanner_client_benchmarks = [
     "bytes_benchmark.cc",
     "internal/date_benchmark.cc",
     "internal/merge_chunk_benchmark.cc",
+    "internal/metadata_spanner_stub_benchmark.cc",
     "internal/time_format_benchmark.cc",
+    "mutations_benchmark.cc",
     "row_benchmark.cc",
+    "value_benchmark.cc",
 ]
@@ -21,6 +21,7 @@ spanner_client_testing_hdrs = [
     "testing/compiler_supports_regexp.h",
     "testing/database_environment.h",
     "testing/fake_clock.h",
+    "testing/in_memory_tracer.h",
     "testing/matchers.h",
     "testing/mock_database_admin_stub.h",
     "testing/mock_instance_admin_stub.h",
@@ -38,6 +39,7 @@ spanner_client_testing_hdrs = [
 spanner_client_testing_srcs = [
     "testing/cleanup_stale_instances.cc",
     "testing/database_environment.cc",
+    "testing/in_memory_tracer.cc",
     "testing/pick_instance_config.cc",
     "testing/pick_random_instance.cc",
     "testing/random_backup_name.cc",
@@ -18,26 +18,36 @@
 
 spanner_client_unit_tests = [
     "backup_test.cc",
+    "bulk_loader_test.cc",
     "bytes_test.cc",
     "client_options_test.cc",
     "client_test.cc",
     "connection_options_test.cc",
+    "connection_tuning_options_test.cc",
+    "contention_controller_test.cc",
     "create_instance_request_builder_test.cc",
     "database_admin_client_test.cc",
     "database_admin_connection_test.cc",
     "database_test.cc",
     "date_test.cc",
+    "fan_out_test.cc",
     "instance_admin_client_test.cc",
     "instance_admin_connection_test.cc",
     "instance_test.cc",
     "internal/api_client_header_test.cc",
+    "internal/batch_read_test.cc",
     "internal/build_info_test.cc",
+    "internal/channel_health_spanner_stub_test.cc",
+    "internal/channel_health_test.cc",
     "internal/clock_test.cc",
     "internal/compiler_info_test.cc",
     "internal/connection_impl_test.cc",
     "internal/database_admin_logging_test.cc",
     "internal/database_admin_metadata_test.cc",
     "internal/date_test.cc",
+    "internal/deadline_connection_test.cc",
+    "internal/deadline_test.cc",
+    "internal/hedged_partial_result_set_reader_test.cc",
     "internal/instance_admin_logging_test.cc",
     "internal/instance_admin_metadata_test.cc",
     "internal/log_wrapper_test.cc",
@@ -45,18 +55,26 @@ spanner_client_unit_tests = [
     "internal/logging_spanner_stub_test.cc",
     "internal/merge_chunk_test.cc",
     "internal/metadata_spanner_stub_test.cc",
+    "internal/metrics_spanner_stub_test.cc",
     "internal/partial_result_set_resume_test.cc",
     "internal/partial_result_set_source_test.cc",
     "internal/polling_loop_test.cc",
+    "internal/read_timestamp_cache_test.cc",
+    "internal/retry_budget_policy_test.cc",
+    "internal/retry_budget_spanner_stub_test.cc",
     "internal/retry_loop_test.cc",
+    "internal/rpc_metrics_test.cc",
+    "internal/sampled_logging_spanner_stub_test.cc",
     "internal/session_pool_test.cc",
     "internal/spanner_stub_test.cc",
     "internal/status_utils_test.cc",
     "internal/time_format_test.cc",
     "internal/time_utils_test.cc",
+    "internal/tracing_test.cc",
     "internal/transaction_impl_test.cc",
     "internal/tuple_utils_test.cc",
     "keys_test.cc",
+    "mutation_batcher_test.cc",
     "mutations_test.cc",
     "partition_options_test.cc",
     "query_options_test.cc",
@@ -64,8 +82,10 @@ spanner_client_unit_tests = [
     "read_options_test.cc",
     "read_partition_test.cc",
     "results_test.cc",
+    "retry_budget_test.cc",
     "retry_policy_test.cc",
     "row_test.cc",
+    "rpc_trace_buffer_test.cc",
     "session_pool_options_test.cc",
     "spanner_version_test.cc",
     "sql_statement_test.cc",
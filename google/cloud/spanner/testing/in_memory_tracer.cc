@@ -0,0 +1,73 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/testing/in_memory_tracer.h"
+#include <utility>
+
+namespace google {
+namespace cloud {
+namespace spanner_testing {
+inline namespace SPANNER_CLIENT_NS {
+
+constexpr std::size_t SpanData::kNoParent;
+
+class InMemoryTracer::Span : public spanner::Span {
+ public:
+  Span(std::shared_ptr<State> state, std::size_t id)
+      : state_(std::move(state)), id_(id) {}
+
+  std::size_t id() const { return id_; }
+
+  void SetAttribute(std::string const& key,
+                    std::string const& value) override {
+    std::lock_guard<std::mutex> lk(state_->mu);
+    state_->spans[id_].attributes[key] = value;
+  }
+
+  void End(Status const& status) override {
+    std::lock_guard<std::mutex> lk(state_->mu);
+    state_->spans[id_].ended = true;
+    state_->spans[id_].status = status;
+  }
+
+ private:
+  std::shared_ptr<State> state_;
+  std::size_t id_;
+};
+
+std::shared_ptr<spanner::Span> InMemoryTracer::StartSpan(
+    std::string const& name, std::shared_ptr<spanner::Span> const& parent) {
+  auto parent_id = SpanData::kNoParent;
+  if (parent) parent_id = static_cast<Span const&>(*parent).id();
+  std::lock_guard<std::mutex> lk(state_->mu);
+  auto const id = state_->spans.size();
+  state_->spans.push_back(SpanData{id, parent_id, name, {}, false, Status()});
+  return std::make_shared<Span>(state_, id);
+}
+
+std::vector<SpanData> InMemoryTracer::Spans() const {
+  std::lock_guard<std::mutex> lk(state_->mu);
+  return state_->spans;
+}
+
+std::vector<std::string> InMemoryTracer::SpanNames() const {
+  std::vector<std::string> names;
+  for (auto const& s : Spans()) names.push_back(s.name);
+  return names;
+}
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner_testing
+}  // namespace cloud
+}  // namespace google
@@ -0,0 +1,81 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_TESTING_IN_MEMORY_TRACER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_TESTING_IN_MEMORY_TRACER_H
+
+#include "google/cloud/spanner/tracer.h"
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/status.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace google {
+namespace cloud {
+namespace spanner_testing {
+inline namespace SPANNER_CLIENT_NS {
+
+/// A span recorded by `InMemoryTracer`.
+struct SpanData {
+  std::size_t id;
+  /// The `id` of the parent span, or `SpanData::kNoParent` for a root span.
+  std::size_t parent;
+  std::string name;
+  std::map<std::string, std::string> attributes;
+  bool ended;
+  Status status;
+
+  static constexpr std::size_t kNoParent = static_cast<std::size_t>(-1);
+};
+
+/**
+ * A tracer intended for use in tests, it keeps all the spans in memory.
+ *
+ * The `id` of each span is its position in the vector returned by `Spans()`,
+ * which is the order the spans were started in.
+ */
+class InMemoryTracer : public spanner::Tracer {
+ public:
+  InMemoryTracer() : state_(std::make_shared<State>()) {}
+
+  std::shared_ptr<spanner::Span> StartSpan(
+      std::string const& name,
+      std::shared_ptr<spanner::Span> const& parent) override;
+
+  /// A copy of the spans started so far.
+  std::vector<SpanData> Spans() const;
+
+  /// The names of the spans started so far.
+  std::vector<std::string> SpanNames() const;
+
+ private:
+  class Span;
+  // Shared with the spans, which may outlive the tracer.
+  struct State {
+    std::mutex mu;
+    std::vector<SpanData> spans;  // GUARDED_BY(mu)
+  };
+
+  std::shared_ptr<State> state_;
+};
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner_testing
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_TESTING_IN_MEMORY_TRACER_H
@@ -18,6 +18,7 @@
 #include "google/cloud/spanner/internal/partial_result_set_reader.h"
 #include "google/cloud/spanner/version.h"
 #include <gmock/gmock.h>
+#include <cstdint>
 
 namespace google {
 namespace cloud {
@@ -30,6 +31,7 @@ class MockPartialResultSetReader
   MOCK_METHOD0(TryCancel, void());
   MOCK_METHOD0(Read, optional<google::spanner::v1::PartialResultSet>());
   MOCK_METHOD0(Finish, Status());
+  MOCK_CONST_METHOD0(Resumes, std::int64_t());
 };
 
 }  // namespace SPANNER_CLIENT_NS
@@ -15,12 +15,10 @@
 #include "google/cloud/spanner/timestamp.h"
 #include "google/cloud/spanner/internal/time_format.h"
 #include "google/cloud/status.h"
+#include <algorithm>
 #include <array>
 #include <cstdlib>
-#include <cstring>
-#include <iomanip>
 #include <limits>
-#include <sstream>
 #include <string>
 
 namespace google {
@@ -139,12 +137,12 @@ StatusOr<Timestamp> Timestamp::FromRFC3339(std::string const& s) {
     auto scale = kNanosPerSecond;
     auto fpos = pos + 1;  // start of fractional digits
     while (++pos != len) {
-      char const* dp = std::strchr(kDigits, s[pos]);
-      if (dp == nullptr || *dp == '\0') break;  // non-digit
-      if (scale == 1) continue;                 // drop insignificant digits
+      auto const d = static_cast<unsigned>(s[pos] - '0');
+      if (d >= 10) break;       // non-digit
+      if (scale == 1) continue;  // drop insignificant digits
       scale /= 10;
       v *= 10;
-      v += static_cast<std::int64_t>(dp - kDigits);
+      v += d;
     }
     if (pos == fpos) {
       return InvalidArgument(s + ": RFC3339 time-secfrac must include a digit");
@@ -176,10 +174,10 @@ StatusOr<Timestamp> Timestamp::FromRFC3339(std::string const& s) {
             if (pos == ipos) break;           // missing digit
             ipos = pos + 1;
           } else {
-            char const* dp = std::strchr(kDigits, s[pos]);
-            if (dp == nullptr || *dp == '\0') break;  // non-digit
+            auto const d = static_cast<unsigned>(s[pos] - '0');
+            if (d >= 10) break;  // non-digit
             *it *= 10;
-            *it += static_cast<std::int64_t>(dp - kDigits);
+            *it += d;
             if (*it >= 100) break;  // avoid overflow using overall bound
           }
         }
@@ -227,40 +225,87 @@ StatusOr<Timestamp> Timestamp::FromRFC3339(std::string const& s) {
 // TODO(#145): Reconcile this implementation with FormatRfc3339() in
 // google/cloud/internal/format_time_point.h in google-cloud-cpp.
 std::string Timestamp::ToRFC3339() const {
-  std::ostringstream output;
-
   // Spanner always uses "Z" but we leave support for a non-zero UTC offset
   // for later refactoring of this code to more general scenarios.
   constexpr std::int64_t kUtcOffsetSecs = 0;
+  auto const s = sec_ + kUtcOffsetSecs;
 
-  // Note: FormatTime(ZTime()) can only do the right thing when the requested
-  // time is within the range of a std::tm (to wit, the "int tm_year" field).
-  output << internal::FormatTime(ZTime(sec_ + kUtcOffsetSecs));
+  auto day = s / kSecsPerDay;
+  auto sec = s % kSecsPerDay;
+  if (sec < 0) {
+    sec += kSecsPerDay;
+    day -= 1;
+  }
 
+  // Timestamps sent together (say, the columns of a bulk insert) almost
+  // always fall on the same day, so we remember the most recently formatted
+  // full-date (including the "T") on each thread, and only run the civil-time
+  // arithmetic when the day changes. The cache is trivially destructible, so
+  // the thread_local costs nothing at thread exit.
+  struct DateCache {
+    bool valid;
+    std::int64_t day;
+    std::size_t size;
+    std::array<char, sizeof "-2147481748-01-01T"> data;
+  };
+  static thread_local DateCache cache;
+  if (!cache.valid || cache.day != day) {
+    // Note: FormatTime(ZTime()) can only do the right thing when the requested
+    // time is within the range of a std::tm (to wit, the "int tm_year" field),
+    // which also bounds the length of the full-date.
+    auto const date_time = internal::FormatTime(ZTime(s));
+    auto const size = (std::min)(date_time.size() - (sizeof "HH:MM:SS" - 1),
+                                 cache.data.size());
+    cache.size = date_time.copy(cache.data.data(), size);
+    cache.day = day;
+    cache.valid = true;
+  }
+
+  // Format the time of day, time-secfrac (dropping any trailing zeros), and
+  // time-offset directly into a fixed buffer, rather than going through the
+  // std::ostream machinery.
+  std::array<char, sizeof "HH:MM:SS.123456789+HH:MM"> buf;
+  char* const bp = buf.data();
+  char* ep = bp;
+  auto const hour = sec / kSecsPerHour;
+  auto const min = sec % kSecsPerHour / kSecsPerMinute;
+  sec %= kSecsPerMinute;
+  *ep++ = kDigits[hour / 10];
+  *ep++ = kDigits[hour % 10];
+  *ep++ = ':';
+  *ep++ = kDigits[min / 10];
+  *ep++ = kDigits[min % 10];
+  *ep++ = ':';
+  *ep++ = kDigits[sec / 10];
+  *ep++ = kDigits[sec % 10];
   if (auto ss = nsec_) {
-    int width = 0;
-    auto scale = kNanosPerSecond;
-    while (scale != 1) {
-      scale /= 10;
-      width += 1;
-    }
-    while (ss % 10 == 0) {
-      ss /= 10;
-      width -= 1;
+    *ep++ = '.';
+    for (auto scale = kNanosPerSecond / 10; ss != 0; scale /= 10) {
+      *ep++ = kDigits[ss / scale];
+      ss %= scale;
     }
-    output << '.' << std::setfill('0') << std::setw(width) << ss;
   }
 
   if (kUtcOffsetSecs != 0) {
     // Format colon-separated hours, minutes, but not (yet) seconds.
-    output << std::setfill('0') << std::internal << std::showpos
-           << std::setw(1 + 2) << (kUtcOffsetSecs / kSecsPerHour) << ':'
-           << std::noshowpos << std::setw(2)
-           << std::abs(kUtcOffsetSecs) % kSecsPerHour / kSecsPerMinute;
+    auto const offset = std::abs(kUtcOffsetSecs);
+    auto const hours = offset / kSecsPerHour;
+    auto const minutes = offset % kSecsPerHour / kSecsPerMinute;
+    *ep++ = kUtcOffsetSecs < 0 ? '-' : '+';
+    *ep++ = kDigits[hours / 10];
+    *ep++ = kDigits[hours % 10];
+    *ep++ = ':';
+    *ep++ = kDigits[minutes / 10];
+    *ep++ = kDigits[minutes % 10];
   } else {
-    output << 'Z';
+    *ep++ = 'Z';
   }
-  return output.str();
+
+  std::string output;
+  output.reserve(cache.size + (ep - bp));
+  output.append(cache.data.data(), cache.size);
+  output.append(bp, ep);
+  return output;
 }
 
 Timestamp Timestamp::FromProto(protobuf::Timestamp const& proto) {
@@ -18,6 +18,7 @@
 #include <cstdint>
 #include <limits>
 #include <sstream>
+#include <string>
 
 namespace google {
 namespace cloud {
@@ -275,6 +276,34 @@ TEST(Timestamp, ToRFC3339) {
                 MakeProtoTimestamp(1561135942, 100000000))));
 }
 
+TEST(Timestamp, ToRFC3339DayChanges) {
+  // ToRFC3339() reuses the most recently formatted date, so interleave
+  // timestamps on the same day, across a day boundary, and before the epoch.
+  struct {
+    std::int64_t seconds;
+    std::int32_t nanos;
+    std::string expected;
+  } cases[] = {
+      {1561135942, 0, "2019-06-21T16:52:22Z"},
+      {1561135943, 5, "2019-06-21T16:52:23.000000005Z"},
+      {1561075200, 0, "2019-06-21T00:00:00Z"},
+      {1561075199, 999999999, "2019-06-20T23:59:59.999999999Z"},
+      {1561135942, 0, "2019-06-21T16:52:22Z"},
+      {0, 0, "1970-01-01T00:00:00Z"},
+      {-1, 0, "1969-12-31T23:59:59Z"},
+      {-86400, 0, "1969-12-31T00:00:00Z"},
+      {-86401, 0, "1969-12-30T23:59:59Z"},
+      {253402300799, 1, "9999-12-31T23:59:59.000000001Z"},
+      {-62135596800, 0, "0001-01-01T00:00:00Z"},
+      {-62135596799, 0, "0001-01-01T00:00:01Z"},
+  };
+  for (auto const& c : cases) {
+    EXPECT_EQ(c.expected,
+              internal::TimestampToRFC3339(internal::TimestampFromProto(
+                  MakeProtoTimestamp(c.seconds, c.nanos))));
+  }
+}
+
 TEST(Timestamp, ToRFC3339Limit) {
   // Spanner range requirements.
   EXPECT_EQ("0001-01-01T00:00:00Z",
@@ -0,0 +1,82 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_TRACER_H
+#define GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_TRACER_H
+
+#include "google/cloud/spanner/version.h"
+#include "google/cloud/status.h"
+#include <memory>
+#include <string>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+
+/**
+ * A span created by a `Tracer`, representing one operation in a trace.
+ *
+ * The library calls `End()` exactly once, when the operation finishes. A span
+ * may still become the parent of new spans after it ends, for example when a
+ * streaming read is resumed after the call that started it returned.
+ */
+class Span {
+ public:
+  virtual ~Span() = default;
+
+  /// Annotate the span with a key/value pair.
+  virtual void SetAttribute(std::string const& key,
+                            std::string const& value) = 0;
+
+  /// Mark the end of the operation, with its outcome.
+  virtual void End(Status const& status) = 0;
+};
+
+/**
+ * Creates the spans for the operations performed by the library.
+ *
+ * Applications implement this interface to export traces to their tracing
+ * system, for example, by wrapping an OpenTelemetry tracer and span, and
+ * install it with `ConnectionTuningOptions::set_tracer()`. The library does
+ * not depend on any tracing system.
+ *
+ * The library creates a root span for each `Connection` operation, e.g.
+ * `ExecuteQuery` or `Commit`, and child spans for the session checkout, each
+ * attempt of a retried RPC, and each time a streaming read is resumed.
+ *
+ * @par Thread Safety
+ * `StartSpan()` may be called concurrently from multiple threads.
+ */
+class Tracer {
+ public:
+  virtual ~Tracer() = default;
+
+  /**
+   * Start a new span.
+   *
+   * @param name the name of the operation.
+   * @param parent the parent span, or `nullptr` for the root of a trace. This
+   *     is always a span returned by this `Tracer`.
+   */
+  virtual std::shared_ptr<Span> StartSpan(
+      std::string const& name, std::shared_ptr<Span> const& parent) = 0;
+};
+
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
+
+#endif  // GOOGLE_CLOUD_CPP_GOOGLE_CLOUD_SPANNER_TRACER_H
@@ -18,6 +18,7 @@
 #include "google/cloud/spanner/internal/transaction_impl.h"
 #include "google/cloud/spanner/timestamp.h"
 #include "google/cloud/spanner/version.h"
+#include "google/cloud/optional.h"
 #include <google/spanner/v1/transaction.pb.h>
 #include <chrono>
 #include <memory>
@@ -36,6 +37,8 @@ template <typename T>
 Transaction MakeSingleUseTransaction(T&&);
 template <typename Functor>
 VisitInvokeResult<Functor> Visit(Transaction, Functor&&);
+optional<google::spanner::v1::TransactionOptions> SingleUseOptions(
+    Transaction const&);
 Transaction MakeTransactionFromIds(std::string session_id,
                                    std::string transaction_id);
 }  // namespace internal
@@ -167,6 +170,8 @@ class Transaction {
   template <typename Functor>
   friend internal::VisitInvokeResult<Functor> internal::Visit(Transaction,
                                                               Functor&&);
+  friend optional<google::spanner::v1::TransactionOptions>
+  internal::SingleUseOptions(Transaction const&);
   friend Transaction internal::MakeTransactionFromIds(
       std::string session_id, std::string transaction_id);
 
@@ -227,6 +232,12 @@ VisitInvokeResult<Functor> Visit(Transaction txn, Functor&& f) {
   return txn.impl_->Visit(std::forward<Functor>(f));
 }
 
+/// The options of @p txn if it is a single-use transaction, without visiting.
+inline optional<google::spanner::v1::TransactionOptions> SingleUseOptions(
+    Transaction const& txn) {
+  return txn.impl_->SingleUseOptions();
+}
+
 }  // namespace internal
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner
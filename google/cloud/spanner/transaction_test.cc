@@ -96,6 +96,33 @@ TEST(Transaction, Visit) {
   });
 }
 
+TEST(Transaction, SingleUseOptions) {
+  auto a = internal::MakeSingleUseTransaction(
+      Transaction::SingleUseOptions(std::chrono::nanoseconds(10)));
+  auto options = internal::SingleUseOptions(a);
+  ASSERT_TRUE(options.has_value());
+  EXPECT_TRUE(options->read_only().has_max_staleness());
+
+  // Inspecting the options does not use a sequence number.
+  internal::Visit(a, [](internal::SessionHolder& /*session*/,
+                        google::spanner::v1::TransactionSelector& s,
+                        std::int64_t seqno) {
+    EXPECT_TRUE(s.has_single_use());
+    EXPECT_EQ(1, seqno);
+    return 0;
+  });
+
+  Transaction b = MakeReadOnlyTransaction();
+  EXPECT_FALSE(internal::SingleUseOptions(b).has_value());
+  internal::Visit(b, [](internal::SessionHolder& /*session*/,
+                        google::spanner::v1::TransactionSelector& s,
+                        std::int64_t) {
+    s.set_id("test-txn-id");
+    return 0;
+  });
+  EXPECT_FALSE(internal::SingleUseOptions(b).has_value());
+}
+
 TEST(Transaction, SessionAffinity) {
   auto a_session = internal::MakeDissociatedSessionHolder("SessionAffinity");
   Transaction a = MakeReadWriteTransaction();
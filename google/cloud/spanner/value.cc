@@ -15,11 +15,12 @@
 #include "google/cloud/spanner/value.h"
 #include "google/cloud/spanner/internal/date.h"
 #include "google/cloud/log.h"
-#include <cerrno>
+#include <array>
 #include <cmath>
-#include <cstdlib>
+#include <cstdint>
 #include <cstring>
 #include <ios>
+#include <limits>
 #include <string>
 
 namespace google {
@@ -175,6 +176,91 @@ std::ostream& StreamHelper(std::ostream& os, google::protobuf::Value const& v,
   return os;
 }
 
+// The two-digit decimal representations of 0 through 99, used to format
+// integers two digits at a time.
+constexpr char kDigitPairs[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Formats `i` in decimal so that it ends just before `end`, returning a
+// pointer to the first character. The buffer must have room for 20 chars.
+char* FormatInt64(std::int64_t i, char* end) {
+  std::uint64_t n = static_cast<std::uint64_t>(i);
+  if (i < 0) n = 0 - n;
+  char* p = end;
+  while (n >= 100) {
+    auto const r = n % 100;
+    n /= 100;
+    p -= 2;
+    std::memcpy(p, &kDigitPairs[2 * r], 2);
+  }
+  if (n >= 10) {
+    p -= 2;
+    std::memcpy(p, &kDigitPairs[2 * n], 2);
+  } else {
+    *--p = static_cast<char>('0' + n);
+  }
+  if (i < 0) *--p = '-';
+  return p;
+}
+
+bool IsDigit(char c) { return static_cast<unsigned char>(c - '0') < 10; }
+
+// Returns true if each of the eight bytes in `chunk` is an ASCII digit. Each
+// byte is checked independently, so the result does not depend on the byte
+// order used to load `chunk`.
+bool IsEightDigits(std::uint64_t chunk) {
+  return ((chunk & 0xF0F0F0F0F0F0F0F0) |
+          (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+         0x3333333333333333;
+}
+
+// Parses the decimal representation of an INT64. Unlike `std::strtoll()` this
+// needs no NUL terminator, ignores the locale, and does not touch `errno`.
+// Runs of digits are validated eight at a time, which covers most of the
+// (at most 19) significant digits with a single comparison per chunk.
+StatusOr<std::int64_t> ParseInt64(std::string const& s) {
+  char const* p = s.data();
+  char const* const end = p + s.size();
+  bool const negative = p != end && *p == '-';
+  if (p != end && (*p == '-' || *p == '+')) ++p;
+  if (p == end || !IsDigit(*p)) {
+    return Status(StatusCode::kUnknown, "No numeric conversion: \"" + s + "\"");
+  }
+  while (p != end && *p == '0') ++p;
+  char const* const digits = p;
+  // The accumulator may wrap when there are more than 19 digits, but in that
+  // case the value is out of range anyway, and we detect it below.
+  std::uint64_t n = 0;
+  while (end - p >= 8) {
+    std::uint64_t chunk;
+    std::memcpy(&chunk, p, sizeof(chunk));
+    if (!IsEightDigits(chunk)) break;
+    for (int i = 0; i != 8; ++i) {
+      n = n * 10 + static_cast<unsigned>(p[i] - '0');
+    }
+    p += 8;
+  }
+  for (; p != end && IsDigit(*p); ++p) {
+    n = n * 10 + static_cast<unsigned>(*p - '0');
+  }
+  if (p != end) {
+    return Status(StatusCode::kUnknown, "Trailing data: \"" + s + "\"");
+  }
+  auto const max = static_cast<std::uint64_t>(
+      std::numeric_limits<std::int64_t>::max());
+  if (p - digits > std::numeric_limits<std::int64_t>::digits10 + 1 ||
+      n > max + (negative ? 1 : 0)) {
+    return Status(StatusCode::kUnknown, "Out of range: \"" + s + "\"");
+  }
+  if (!negative) return static_cast<std::int64_t>(n);
+  if (n == 0) return std::int64_t{0};
+  return -static_cast<std::int64_t>(n - 1) - 1;
+}
+
 }  // namespace
 
 namespace internal {
@@ -187,6 +273,8 @@ std::pair<google::spanner::v1::Type, google::protobuf::Value> ToProto(Value v) {
   return std::make_pair(std::move(v.type_), std::move(v.value_));
 }
 
+google::protobuf::Value ToProtoValue(Value v) { return std::move(v.value_); }
+
 }  // namespace internal
 
 bool operator==(Value const& a, Value const& b) {
@@ -306,8 +394,11 @@ google::protobuf::Value Value::MakeValueProto(bool b) {
 }
 
 google::protobuf::Value Value::MakeValueProto(std::int64_t i) {
+  std::array<char, std::numeric_limits<std::int64_t>::digits10 + 2> buf;
+  auto* const end = buf.data() + buf.size();
+  auto const* const begin = FormatInt64(i, end);
   google::protobuf::Value v;
-  v.set_string_value(std::to_string(i));
+  v.set_string_value(begin, end - begin);
   return v;
 }
 
@@ -379,21 +470,7 @@ StatusOr<std::int64_t> Value::GetValue(std::int64_t,
   if (pv.kind_case() != google::protobuf::Value::kStringValue) {
     return Status(StatusCode::kUnknown, "missing INT64");
   }
-  auto const& s = pv.string_value();
-  char* end = nullptr;
-  errno = 0;
-  std::int64_t x = {std::strtoll(s.c_str(), &end, 10)};
-  if (errno != 0) {
-    auto const err = std::string(std::strerror(errno));
-    return Status(StatusCode::kUnknown, err + ": \"" + s + "\"");
-  }
-  if (end == s.c_str()) {
-    return Status(StatusCode::kUnknown, "No numeric conversion: \"" + s + "\"");
-  }
-  if (*end != '\0') {
-    return Status(StatusCode::kUnknown, "Trailing data: \"" + s + "\"");
-  }
-  return x;
+  return ParseInt64(pv.string_value());
 }
 
 StatusOr<double> Value::GetValue(double, google::protobuf::Value const& pv,
@@ -404,11 +481,23 @@ StatusOr<double> Value::GetValue(double, google::protobuf::Value const& pv,
   if (pv.kind_case() != google::protobuf::Value::kStringValue) {
     return Status(StatusCode::kUnknown, "missing FLOAT64");
   }
+  // Spanner only uses strings for the non-finite values, so dispatch on the
+  // first character instead of comparing against every spelling.
   std::string const& s = pv.string_value();
   auto const inf = std::numeric_limits<double>::infinity();
-  if (s == "-Infinity") return -inf;
-  if (s == "Infinity") return inf;
-  if (s == "NaN") return std::nan("");
+  switch (s.empty() ? '\0' : s[0]) {
+    case 'N':
+      if (s == "NaN") return std::numeric_limits<double>::quiet_NaN();
+      break;
+    case 'I':
+      if (s == "Infinity") return inf;
+      break;
+    case '-':
+      if (s == "-Infinity") return -inf;
+      break;
+    default:
+      break;
+  }
   return Status(StatusCode::kUnknown, "bad FLOAT64 data: \"" + s + "\"");
 }
 
@@ -440,6 +529,14 @@ StatusOr<Bytes> Value::GetValue(Bytes const&, google::protobuf::Value const& pv,
   return *decoded;
 }
 
+StatusOr<Bytes> Value::GetValue(Bytes const&, google::protobuf::Value&& pv,
+                                google::spanner::v1::Type const&) {
+  if (pv.kind_case() != google::protobuf::Value::kStringValue) {
+    return Status(StatusCode::kUnknown, "missing BYTES");
+  }
+  return internal::BytesFromBase64(std::move(*pv.mutable_string_value()));
+}
+
 StatusOr<Timestamp> Value::GetValue(Timestamp,
                                     google::protobuf::Value const& pv,
                                     google::spanner::v1::Type const&) {
@@ -43,6 +43,9 @@ class Value;  // Defined later in this file.
 namespace internal {
 Value FromProto(google::spanner::v1::Type t, google::protobuf::Value v);
 std::pair<google::spanner::v1::Type, google::protobuf::Value> ToProto(Value v);
+google::protobuf::Value ToProtoValue(Value v);
+template <typename T>
+google::protobuf::Value MakeValueProto(T v);
 }  // namespace internal
 
 /**
@@ -514,6 +517,8 @@ class Value {
                                         google::spanner::v1::Type const&);
   static StatusOr<Bytes> GetValue(Bytes const&, google::protobuf::Value const&,
                                   google::spanner::v1::Type const&);
+  static StatusOr<Bytes> GetValue(Bytes const&, google::protobuf::Value&&,
+                                  google::spanner::v1::Type const&);
   static StatusOr<Timestamp> GetValue(Timestamp, google::protobuf::Value const&,
                                       google::spanner::v1::Type const&);
   static StatusOr<CommitTimestamp> GetValue(CommitTimestamp,
@@ -627,6 +632,9 @@ class Value {
                                    google::protobuf::Value);
   friend std::pair<google::spanner::v1::Type, google::protobuf::Value>
       internal::ToProto(Value);
+  friend google::protobuf::Value internal::ToProtoValue(Value);
+  template <typename T>
+  friend google::protobuf::Value internal::MakeValueProto(T);
 
   google::spanner::v1::Type type_;
   google::protobuf::Value value_;
@@ -644,6 +652,25 @@ Value MakeNullValue() {
   return Value(optional<T>{});
 }
 
+namespace internal {
+
+/**
+ * Returns the `google::protobuf::Value` that `Value(T)` would hold, without
+ * creating the `Value` or its `google::spanner::v1::Type`.
+ *
+ * Callers should name `T` explicitly, so that any conversions (say, from a
+ * `std::vector<bool>::reference`) happen as they would for the corresponding
+ * `Value` constructor.
+ */
+template <typename T>
+google::protobuf::Value MakeValueProto(T v) {
+  static_assert(std::is_constructible<Value, T>::value,
+                "T is not a supported Spanner value type");
+  return Value::MakeValueProto(std::move(v));
+}
+
+}  // namespace internal
+
 }  // namespace SPANNER_CLIENT_NS
 }  // namespace spanner
 }  // namespace cloud
@@ -0,0 +1,76 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "google/cloud/spanner/value.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <limits>
+
+namespace google {
+namespace cloud {
+namespace spanner {
+inline namespace SPANNER_CLIENT_NS {
+namespace {
+
+void BM_Int64ToValue(benchmark::State& state) {
+  auto const i = static_cast<std::int64_t>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Value(i));
+  }
+}
+BENCHMARK(BM_Int64ToValue)
+    ->Arg(1)
+    ->Arg(1000000)
+    ->Arg(std::numeric_limits<std::int64_t>::max());
+
+void BM_Int64FromValue(benchmark::State& state) {
+  Value const v(static_cast<std::int64_t>(state.range(0)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(v.get<std::int64_t>());
+  }
+}
+BENCHMARK(BM_Int64FromValue)
+    ->Arg(1)
+    ->Arg(1000000)
+    ->Arg(std::numeric_limits<std::int64_t>::max());
+
+void BM_Float64ToValue(benchmark::State& state) {
+  double const d = 3.14159;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Value(d));
+  }
+}
+BENCHMARK(BM_Float64ToValue);
+
+void BM_Float64FromValue(benchmark::State& state) {
+  Value const v(3.14159);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(v.get<double>());
+  }
+}
+BENCHMARK(BM_Float64FromValue);
+
+void BM_Float64FromValueNaN(benchmark::State& state) {
+  Value const v(std::numeric_limits<double>::quiet_NaN());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(v.get<double>());
+  }
+}
+BENCHMARK(BM_Float64FromValueNaN);
+
+}  // namespace
+}  // namespace SPANNER_CLIENT_NS
+}  // namespace spanner
+}  // namespace cloud
+}  // namespace google
@@ -241,6 +241,27 @@ TEST(Value, RvalueGetString) {
   EXPECT_EQ("", *s);
 }
 
+// NOTE: This test relies on the same unspecified moved-from behavior of
+// std::string as `RvalueGetString`, applied to the base64 representation.
+TEST(Value, RvalueGetBytes) {
+  using Type = Bytes;
+  Type const data(std::string(128, 'x'));
+  Value v(data);
+
+  auto s = v.get<Type>();
+  EXPECT_STATUS_OK(s);
+  EXPECT_EQ(data, *s);
+
+  s = std::move(v).get<Type>();
+  EXPECT_STATUS_OK(s);
+  EXPECT_EQ(data, *s);
+
+  // NOLINTNEXTLINE(bugprone-use-after-move)
+  s = v.get<Type>();
+  EXPECT_STATUS_OK(s);
+  EXPECT_EQ(Bytes(), *s);
+}
+
 // NOTE: This test relies on unspecified behavior about the moved-from state
 // of std::string. Specifically, this test relies on the fact that "large"
 // strings, when moved-from, end up empty. And we use this fact to verify that
@@ -328,6 +349,14 @@ TEST(Value, DoubleNaN) {
   EXPECT_NE(v, v);
 }
 
+TEST(Value, ToProtoValue) {
+  Value const v(std::string("hello"));
+  auto const protos = internal::ToProto(v);
+  auto const value = internal::ToProtoValue(v);
+  EXPECT_EQ(protos.second.SerializeAsString(), value.SerializeAsString());
+  EXPECT_EQ(v, internal::FromProto(protos.first, value));
+}
+
 TEST(Value, BytesDecodingError) {
   Value const v(Bytes("some data"));
   auto p = internal::ToProto(v);
@@ -591,6 +620,15 @@ TEST(Value, ProtoConversionInt64) {
     EXPECT_EQ(google::spanner::v1::TypeCode::INT64, p.first.code());
     EXPECT_EQ(std::to_string(x), p.second.string_value());
   }
+
+  for (std::int64_t x = 1; x < max64 / 10; x *= 10) {
+    for (auto y : {x - 1, x, x + 1, -x + 1, -x, -x - 1}) {
+      Value const v(y);
+      auto const p = internal::ToProto(v);
+      EXPECT_EQ(std::to_string(y), p.second.string_value());
+      EXPECT_EQ(y, *v.get<std::int64_t>());
+    }
+  }
 }
 
 TEST(Value, ProtoConversionFloat64) {
@@ -837,6 +875,37 @@ TEST(Value, GetBadInt) {
 
   SetProtoKind(v, "123blah");
   EXPECT_FALSE(v.get<std::int64_t>().ok());
+
+  SetProtoKind(v, "-");
+  EXPECT_FALSE(v.get<std::int64_t>().ok());
+
+  SetProtoKind(v, "12345678x");
+  EXPECT_FALSE(v.get<std::int64_t>().ok());
+
+  SetProtoKind(v, "9223372036854775808");
+  EXPECT_FALSE(v.get<std::int64_t>().ok());
+
+  SetProtoKind(v, "-9223372036854775809");
+  EXPECT_FALSE(v.get<std::int64_t>().ok());
+
+  SetProtoKind(v, "18446744073709551616");
+  EXPECT_FALSE(v.get<std::int64_t>().ok());
+}
+
+TEST(Value, GetInt64NonCanonical) {
+  Value v(42);
+  SetProtoKind(v, "+42");
+  EXPECT_EQ(42, *v.get<std::int64_t>());
+
+  SetProtoKind(v, "-0");
+  EXPECT_EQ(0, *v.get<std::int64_t>());
+
+  SetProtoKind(v, "0000000000000000000000042");
+  EXPECT_EQ(42, *v.get<std::int64_t>());
+
+  SetProtoKind(v, "-000000000000000000009223372036854775808");
+  EXPECT_EQ(std::numeric_limits<std::int64_t>::min(),
+            *v.get<std::int64_t>());
 }
 
 TEST(Value, GetBadTimestamp) {